@@ -0,0 +1,467 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the bus functional models shared by the testbenches.
+//
+// A valid/ready channel of a Verilated model is described by a port accessor
+// class, declared with SIMMEM_BFM_PORT, which names its payload, valid and
+// ready signals. A channel is then handled by:
+//  * a Driver, on the side that drives the payload and the valid signal,
+//  * a Monitor, on the side that drives the ready signal.
+// A multi-port design packs the channels of its ports into the same signals:
+// the valid and ready signals are then vectors with one bit per port, and the
+// payloads are concatenated. A driver or monitor handles one lane of such a
+// channel, given by its lane index.
+// Drivers and monitors only record the signal values wanted for the current
+// cycle. drive_all writes the values of all the channels to the model at once,
+// so that a single evaluation precedes the sampling of all the handshakes.
+// Everything is resolved at compile time: there is no virtual call.
+//
+// SimHarness holds the Verilated model and implements the clocking, the reset
+// and the trace recording.
+
+#ifndef SIMMEM_DV_BFM
+#define SIMMEM_DV_BFM
+
+#include "verilated.h"
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <verilated_fst_c.h>
+
+/**
+ * Declares the port accessor class of a valid/ready channel.
+ *
+ * @param name the name of the accessor class
+ * @param payload_sig the payload signal of the model
+ * @param valid_sig the valid signal of the model
+ * @param ready_sig the ready signal of the model
+ */
+#define SIMMEM_BFM_PORT(name, payload_sig, valid_sig, ready_sig)  \
+  struct name {                                                  \
+    template <typename M>                                        \
+    static auto payload(M &m) -> decltype((m.payload_sig)) {     \
+      return m.payload_sig;                                      \
+    }                                                            \
+    template <typename M>                                        \
+    static auto valid(M &m) -> decltype((m.valid_sig)) {         \
+      return m.valid_sig;                                        \
+    }                                                            \
+    template <typename M>                                        \
+    static auto ready(M &m) -> decltype((m.ready_sig)) {         \
+      return m.ready_sig;                                        \
+    }                                                            \
+  }
+
+namespace simmem_bfm {
+
+//////////////
+// Payloads //
+//////////////
+
+// Payloads are either AXI messages (see simmem_axi_structures.h), placed at
+// some position in the signal, or raw integers, which occupy the whole signal.
+
+template <typename Msg, typename T>
+inline typename std::enable_if<std::is_integral<Msg>::value>::type
+payload_to_port(const Msg &msg, T &sig, size_t lsb) {
+  sig = msg;
+}
+
+template <typename Msg, typename T>
+inline typename std::enable_if<!std::is_integral<Msg>::value>::type
+payload_to_port(const Msg &msg, T &sig, size_t lsb) {
+  msg_to_port(msg, sig, lsb);
+}
+
+template <typename Msg, typename T>
+inline typename std::enable_if<std::is_integral<Msg>::value>::type
+payload_from_port(Msg &msg, const T &sig, size_t lsb) {
+  msg = (Msg)sig;
+}
+
+template <typename Msg, typename T>
+inline typename std::enable_if<!std::is_integral<Msg>::value>::type
+payload_from_port(Msg &msg, const T &sig, size_t lsb) {
+  msg_from_port(msg, sig, lsb);
+}
+
+/**
+ * Width of a payload in a lane: the packed width of an AXI message. Raw
+ * integers occupy the whole signal, and therefore only support lane 0.
+ */
+template <typename Msg>
+inline constexpr typename std::enable_if<std::is_integral<Msg>::value,
+                                         size_t>::type
+payload_width(void) {
+  return 0;
+}
+
+template <typename Msg>
+inline constexpr typename std::enable_if<!std::is_integral<Msg>::value,
+                                         size_t>::type
+payload_width(void) {
+  return Msg::packed_w;
+}
+
+///////////
+// Lanes //
+///////////
+
+// Valid and ready vectors have at most 64 lanes.
+
+template <typename T>
+inline void lane_set(T &sig, size_t lane, bool val) {
+  sig = (sig & ~((uint64_t)1 << lane)) | ((uint64_t)val << lane);
+}
+
+template <typename T>
+inline bool lane_get(const T &sig, size_t lane) {
+  return (sig >> lane) & 1;
+}
+
+//////////////////////////
+// Drivers and monitors //
+//////////////////////////
+
+/**
+ * Drives the payload and the valid signal of a channel.
+ *
+ * @tparam Module the Verilated model
+ * @tparam Msg the payload type
+ * @tparam Port the port accessor class (see SIMMEM_BFM_PORT)
+ * @tparam kLsb the position of the payload of lane 0 in the signal
+ */
+template <typename Module, typename Msg, typename Port, size_t kLsb = 0>
+class Driver {
+ public:
+  /**
+   * @param module the Verilated model
+   * @param lane the lane of the channel, i.e., the port of a multi-port design
+   */
+  explicit Driver(Module *module, size_t lane = 0)
+      : module_(module),
+        lane_(lane),
+        lsb_(kLsb + lane * payload_width<Msg>()),
+        valid_(false),
+        msg_() {}
+
+  /**
+   * Applies a valid payload, from the next call to drive on.
+   *
+   * @param msg the payload
+   */
+  void apply(const Msg &msg) {
+    msg_ = msg;
+    valid_ = true;
+  }
+
+  /**
+   * Stops applying a valid payload.
+   */
+  void stop(void) { valid_ = false; }
+
+  /**
+   * Writes the signals to the model.
+   */
+  void drive(void) const {
+    if (valid_) {
+      payload_to_port(msg_, Port::payload(*module_), lsb_);
+    }
+    lane_set(Port::valid(*module_), lane_, valid_);
+  }
+
+  /**
+   * Checks whether the payload has been accepted. Requires the model to have
+   * been evaluated since the last call to drive.
+   */
+  bool check(void) const {
+    return valid_ && lane_get(Port::ready(*module_), lane_);
+  }
+
+ private:
+  Module *module_;
+  size_t lane_;
+  size_t lsb_;
+  bool valid_;
+  Msg msg_;
+};
+
+/**
+ * Drives the ready signal of a channel and samples its payload.
+ *
+ * @tparam Module the Verilated model
+ * @tparam Msg the payload type
+ * @tparam Port the port accessor class (see SIMMEM_BFM_PORT)
+ * @tparam kLsb the position of the payload of lane 0 in the signal
+ */
+template <typename Module, typename Msg, typename Port, size_t kLsb = 0>
+class Monitor {
+ public:
+  /**
+   * @param module the Verilated model
+   * @param lane the lane of the channel, i.e., the port of a multi-port design
+   */
+  explicit Monitor(Module *module, size_t lane = 0)
+      : module_(module),
+        lane_(lane),
+        lsb_(kLsb + lane * payload_width<Msg>()),
+        ready_(false) {}
+
+  /**
+   * Sets the ready signal to one, from the next call to drive on.
+   */
+  void request(void) { ready_ = true; }
+
+  /**
+   * Sets the ready signal to zero, from the next call to drive on.
+   */
+  void stop(void) { ready_ = false; }
+
+  /**
+   * Writes the signals to the model.
+   */
+  void drive(void) const { lane_set(Port::ready(*module_), lane_, ready_); }
+
+  /**
+   * Fetches the payload if the handshake is successful. Requires the model to
+   * have been evaluated since the last call to drive.
+   *
+   * @param msg the payload, modified in place iff the handshake is successful
+   *
+   * @return true iff the handshake is successful
+   */
+  bool fetch(Msg &msg) const {
+    if (!ready_ || !lane_get(Port::valid(*module_), lane_)) {
+      return false;
+    }
+    payload_from_port(msg, Port::payload(*module_), lsb_);
+    return true;
+  }
+
+ private:
+  Module *module_;
+  size_t lane_;
+  size_t lsb_;
+  bool ready_;
+};
+
+/**
+ * Writes the signals of all the given channels to the model. A vector stands
+ * for all the lanes of a channel.
+ */
+inline void drive_all(void) {}
+
+template <typename Channel, typename... Channels>
+inline void drive_all(const Channel &channel, const Channels &... channels);
+
+template <typename Channel, typename... Channels>
+inline void drive_all(const std::vector<Channel> &lanes,
+                      const Channels &... channels) {
+  for (const Channel &lane : lanes) {
+    lane.drive();
+  }
+  drive_all(channels...);
+}
+
+template <typename Channel, typename... Channels>
+inline void drive_all(const Channel &channel, const Channels &... channels) {
+  channel.drive();
+  drive_all(channels...);
+}
+
+/**
+ * Stops all the given channels. A vector stands for all the lanes of a channel.
+ */
+inline void stop_all(void) {}
+
+template <typename Channel, typename... Channels>
+inline void stop_all(Channel &channel, Channels &... channels);
+
+template <typename Channel, typename... Channels>
+inline void stop_all(std::vector<Channel> &lanes, Channels &... channels) {
+  for (Channel &lane : lanes) {
+    lane.stop();
+  }
+  stop_all(channels...);
+}
+
+template <typename Channel, typename... Channels>
+inline void stop_all(Channel &channel, Channels &... channels) {
+  channel.stop();
+  stop_all(channels...);
+}
+
+/////////////
+// Harness //
+/////////////
+
+/**
+ * Holds a Verilated model with a clk_i clock and a rst_ni active-low reset,
+ * and records its trace.
+ *
+ * Each clock cycle requires two evaluations of the model, as the designs only
+ * have logic on the rising clock edge (and on the asynchronous reset):
+ *  * settle, with the clock low, propagates the inputs of the cycle through
+ *  the combinational logic. It is the sampling point of the cycle: once the
+ *  model is settled, the outputs and the handshakes of the cycle are valid.
+ *  * The rising clock edge updates the registers, and the outputs that depend
+ *  on them. The clock is only lowered by the next settling evaluation, as the
+ *  falling edge has no logic.
+ * If the model is not settled when the clock rises, the settling evaluation is
+ * performed first, so that the model always sees the clock low between two
+ * rising edges.
+ *
+ * If SIMMEM_EVAL_STEP is defined, the settling evaluation only performs the
+ * evaluation step of the model (eval_step, Verilator 4.200 or later), and
+ * leaves the end-of-step work to the evaluation of the rising edge.
+ *
+ * @tparam Module the Verilated model
+ */
+template <typename Module>
+class SimHarness {
+ public:
+  /**
+   * @param record_trace set to false to skip trace recording
+   * @param trace_filename the name of the FST trace file
+   * @param trace_level the depth of the trace
+   */
+  SimHarness(bool record_trace, const std::string &trace_filename,
+             int trace_level)
+      : tick_count_(0l),
+        record_trace_(record_trace),
+        settled_(false),
+        legacy_clocking_(false),
+        module_(new Module) {
+    if (record_trace) {
+      trace_ = new VerilatedFstC;
+      module_->trace(trace_, trace_level);
+      trace_->open(trace_filename.c_str());
+    }
+  }
+
+  ~SimHarness() {
+    if (record_trace_) {
+      simmem_close_trace();
+    }
+  }
+
+  void simmem_close_trace(void) { trace_->close(); }
+
+  /**
+   * Selects the former clocking, with three evaluations per clock cycle (clock
+   * low, high, then low again). Only kept as a reference for the clocking
+   * benchmark.
+   */
+  void set_legacy_clocking(bool legacy_clocking) {
+    legacy_clocking_ = legacy_clocking;
+  }
+
+  /**
+   * Number of clock cycles performed so far.
+   */
+  vluint64_t get_tick_count(void) const { return tick_count_; }
+
+ protected:
+  /**
+   * Evaluates the model with the clock low, after the inputs of the cycle have
+   * been applied. Outputs may then be sampled until the next clock edge.
+   */
+  void settle(void) {
+    module_->clk_i = 0;
+#ifdef SIMMEM_EVAL_STEP
+    module_->eval_step();
+#else
+    module_->eval();
+#endif  // SIMMEM_EVAL_STEP
+    settled_ = true;
+
+    if (record_trace_) {
+      trace_->dump(5 * tick_count_ + 2);
+    }
+  }
+
+  /**
+   * Performs one or multiple clock cycles.
+   *
+   * @param num_ticks the number of ticks to perform at once
+   */
+  void tick(int num_ticks) {
+    if (legacy_clocking_) {
+      legacy_tick(num_ticks);
+      return;
+    }
+
+    for (int i = 0; i < num_ticks; i++) {
+      if (!settled_) {
+        settle();
+      }
+
+      tick_count_++;
+      module_->clk_i = 1;
+      module_->eval();
+      settled_ = false;
+
+      if (record_trace_) {
+        trace_->dump(5 * tick_count_);
+        trace_->flush();
+      }
+    }
+  }
+
+  /**
+   * Holds the reset signal for some clock cycles.
+   *
+   * @param length the number of clock cycles
+   */
+  void pulse_reset(int length) {
+    module_->rst_ni = 0;
+    settled_ = false;
+    tick(length);
+    module_->rst_ni = 1;
+  }
+
+  vluint64_t tick_count_;
+  bool record_trace_;
+  // True iff the model has been evaluated with the clock low since the last
+  // rising edge.
+  bool settled_;
+  bool legacy_clocking_;
+  std::unique_ptr<Module> module_;
+  VerilatedFstC *trace_;
+
+ private:
+  void legacy_tick(int num_ticks) {
+    for (int i = 0; i < num_ticks; i++) {
+      tick_count_++;
+
+      module_->clk_i = 0;
+      module_->eval();
+
+      if (record_trace_) {
+        trace_->dump(5 * tick_count_ - 1);
+      }
+      module_->clk_i = 1;
+      module_->eval();
+
+      if (record_trace_) {
+        trace_->dump(5 * tick_count_);
+      }
+      module_->clk_i = 0;
+      module_->eval();
+      settled_ = true;
+
+      if (record_trace_) {
+        trace_->dump(5 * tick_count_ + 2);
+        trace_->flush();
+      }
+    }
+  }
+};
+
+}  // namespace simmem_bfm
+
+#endif  // SIMMEM_DV_BFM
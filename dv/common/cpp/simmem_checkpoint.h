@@ -0,0 +1,131 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the checkpoint serialization of the testbench-side
+// state, on top of the Verilated save and restore streams. Plain values, such
+// as the AXI messages, are trivially copyable and written as raw bytes, and a
+// checkpoint is only restored by the binary that saved it. The containers are
+// written element by element.
+
+#ifndef SIMMEM_DV_CHECKPOINT
+#define SIMMEM_DV_CHECKPOINT
+
+#include <map>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <verilated_save.h>
+
+namespace simmem_ckpt {
+
+// All the overloads are declared first, so that the containers of containers
+// resolve to them.
+template <typename T>
+void serialize(VerilatedSerialize &os, const T &val);
+template <typename T>
+void deserialize(VerilatedDeserialize &is, T &val);
+inline void serialize(VerilatedSerialize &os, const std::mt19937 &rng);
+inline void deserialize(VerilatedDeserialize &is, std::mt19937 &rng);
+template <typename T>
+void serialize(VerilatedSerialize &os, const std::vector<T> &vec);
+template <typename T>
+void deserialize(VerilatedDeserialize &is, std::vector<T> &vec);
+template <typename T>
+void serialize(VerilatedSerialize &os, const std::queue<T> &queue);
+template <typename T>
+void deserialize(VerilatedDeserialize &is, std::queue<T> &queue);
+template <typename K, typename V>
+void serialize(VerilatedSerialize &os, const std::map<K, V> &map);
+template <typename K, typename V>
+void deserialize(VerilatedDeserialize &is, std::map<K, V> &map);
+
+template <typename T>
+void serialize(VerilatedSerialize &os, const T &val) {
+  os.write(&val, sizeof(T));
+}
+template <typename T>
+void deserialize(VerilatedDeserialize &is, T &val) {
+  is.read(&val, sizeof(T));
+}
+
+inline void serialize(VerilatedSerialize &os, const std::mt19937 &rng) {
+  std::ostringstream rng_state;
+  rng_state << rng;
+  std::string str = rng_state.str();
+  serialize(os, str.size());
+  os.write(str.data(), str.size());
+}
+inline void deserialize(VerilatedDeserialize &is, std::mt19937 &rng) {
+  size_t size;
+  deserialize(is, size);
+  std::string str(size, ' ');
+  is.read(&str[0], size);
+  std::istringstream rng_state(str);
+  rng_state >> rng;
+}
+
+template <typename T>
+void serialize(VerilatedSerialize &os, const std::vector<T> &vec) {
+  serialize(os, vec.size());
+  for (size_t i = 0; i < vec.size(); i++) {
+    serialize(os, vec[i]);
+  }
+}
+template <typename T>
+void deserialize(VerilatedDeserialize &is, std::vector<T> &vec) {
+  size_t size;
+  deserialize(is, size);
+  vec.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    deserialize(is, vec[i]);
+  }
+}
+
+template <typename T>
+void serialize(VerilatedSerialize &os, const std::queue<T> &queue) {
+  std::queue<T> copy(queue);
+  serialize(os, copy.size());
+  for (; !copy.empty(); copy.pop()) {
+    serialize(os, copy.front());
+  }
+}
+template <typename T>
+void deserialize(VerilatedDeserialize &is, std::queue<T> &queue) {
+  size_t size;
+  deserialize(is, size);
+  queue = std::queue<T>();
+  for (size_t i = 0; i < size; i++) {
+    T elem;
+    deserialize(is, elem);
+    queue.push(elem);
+  }
+}
+
+template <typename K, typename V>
+void serialize(VerilatedSerialize &os, const std::map<K, V> &map) {
+  serialize(os, map.size());
+  for (typename std::map<K, V>::const_iterator it = map.begin();
+       it != map.end(); it++) {
+    serialize(os, it->first);
+    serialize(os, it->second);
+  }
+}
+template <typename K, typename V>
+void deserialize(VerilatedDeserialize &is, std::map<K, V> &map) {
+  size_t size;
+  deserialize(is, size);
+  map.clear();
+  for (size_t i = 0; i < size; i++) {
+    K key;
+    deserialize(is, key);
+    deserialize(is, map[key]);
+  }
+}
+
+}  // namespace simmem_ckpt
+
+#endif  // SIMMEM_DV_CHECKPOINT
@@ -0,0 +1,80 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header checks that the generated simmem_axi_dimensions.h matches the
+// Verilated model. The header is generated from the package sources and the
+// SIMMEM_DEFINES overrides, whereas the model is built from the SIMMEM_*
+// macros passed to the RTL (for instance as FuseSoC core parameters): if they
+// differ, the testbench would pack the messages with wrong field widths.
+//
+// The configurable parameters of simmem_pkg are public to Verilator, so that
+// the model exposes their values in its package class, for instance
+// Vsimmem_top_simmem_pkg.
+
+#ifndef SIMMEM_DV_DIMS_CHECK
+#define SIMMEM_DV_DIMS_CHECK
+
+#include "simmem_axi_dimensions.h"
+#include <iostream>
+#include <stdint.h>
+
+namespace simmem_dims {
+
+inline bool check_param(const char *name, uint64_t header_value,
+                        uint64_t model_value) {
+  if (header_value == model_value) {
+    return true;
+  }
+  std::cerr << "Parameter " << name << " is " << model_value
+            << " in the model, but " << header_value
+            << " in simmem_axi_dimensions.h." << std::endl;
+  return false;
+}
+
+#define SIMMEM_DIMS_CHECK_PARAM(param) \
+  matches &= check_param(#param, ::param, (uint64_t)Pkg::param)
+
+/**
+ * Compares the configurable package parameters of the generated header and of
+ * the model, and reports the mismatches on the standard error.
+ *
+ * @tparam Pkg the Verilated package class, Vsimmem_top_simmem_pkg for instance
+ *
+ * @return true iff all the parameters match
+ */
+template <typename Pkg>
+bool matches_model(void) {
+  bool matches = true;
+  SIMMEM_DIMS_CHECK_PARAM(GlobalMemCapaW);
+  SIMMEM_DIMS_CHECK_PARAM(RowBufLenW);
+  SIMMEM_DIMS_CHECK_PARAM(NumRanks);
+  SIMMEM_DIMS_CHECK_PARAM(AddrMapScheme);
+  SIMMEM_DIMS_CHECK_PARAM(AddrMapXorHash);
+  SIMMEM_DIMS_CHECK_PARAM(ClkPeriodPs);
+  SIMMEM_DIMS_CHECK_PARAM(MemClkPeriodPs);
+  SIMMEM_DIMS_CHECK_PARAM(RowPolicy);
+  SIMMEM_DIMS_CHECK_PARAM(RowHitCost);
+  SIMMEM_DIMS_CHECK_PARAM(PrechargeCost);
+  SIMMEM_DIMS_CHECK_PARAM(ActivationCost);
+  SIMMEM_DIMS_CHECK_PARAM(ActToActCost);
+  SIMMEM_DIMS_CHECK_PARAM(FourActWindowCost);
+  SIMMEM_DIMS_CHECK_PARAM(WrToRdCost);
+  SIMMEM_DIMS_CHECK_PARAM(RdToWrCost);
+  SIMMEM_DIMS_CHECK_PARAM(MaxBurstSizeField);
+  SIMMEM_DIMS_CHECK_PARAM(MaxBurstLenField);
+  SIMMEM_DIMS_CHECK_PARAM(WRspBankCapa);
+  SIMMEM_DIMS_CHECK_PARAM(RDataBankCapa);
+  SIMMEM_DIMS_CHECK_PARAM(NumWSlots);
+  SIMMEM_DIMS_CHECK_PARAM(NumRSlots);
+  SIMMEM_DIMS_CHECK_PARAM(DelayEngine);
+  SIMMEM_DIMS_CHECK_PARAM(IDWidth);
+  SIMMEM_DIMS_CHECK_PARAM(NumPorts);
+  return matches;
+}
+
+#undef SIMMEM_DIMS_CHECK_PARAM
+
+}  // namespace simmem_dims
+
+#endif  // SIMMEM_DV_DIMS_CHECK
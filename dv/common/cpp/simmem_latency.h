@@ -0,0 +1,347 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the latency attribution of the toplevel testbench, which
+// breaks down the latency of each transaction into the phases it spends in the
+// design, from the events reported by the testbench and by the debug port of
+// simmem_top.
+
+#ifndef SIMMEM_DV_LATENCY
+#define SIMMEM_DV_LATENCY
+
+#include "simmem_checkpoint.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <verilated_save.h>
+
+namespace simmem_lat {
+
+// Channels and phases of the latency attribution. The phases of a transaction
+// are consecutive:
+//  * slot: from the first presentation of the address request to its
+//  acceptance, while the design has no free slot or bank entry.
+//  * sched: from the acceptance to the issue of the first memory request of the
+//  burst, while older or cheaper entries are scheduled first.
+//  * mem: the modelled DRAM cost, until the burst completes.
+//  * realmem: waiting for the (last) response of the real memory controller.
+//  * output: from there to the (last) output handshake with the requester.
+typedef enum { LAT_CH_WRITE, LAT_CH_READ, NUM_LAT_CHANNELS } lat_channel_e;
+typedef enum {
+  LAT_PHASE_SLOT,
+  LAT_PHASE_SCHED,
+  LAT_PHASE_MEM,
+  LAT_PHASE_REALMEM,
+  LAT_PHASE_OUTPUT,
+  NUM_LAT_PHASES
+} lat_phase_e;
+
+const char *const kLatChannelNames[NUM_LAT_CHANNELS] = {"Write", "Read"};
+const char *const kLatPhaseNames[NUM_LAT_PHASES] = {"slot", "sched", "mem",
+                                                    "realmem", "output"};
+
+// Phase durations of one completed transaction.
+struct LatencyRecord {
+  lat_channel_e channel;
+  uint64_t axi_id;
+  size_t accepted;
+  size_t phases[NUM_LAT_PHASES];
+  // Whether the debug events located the issue and the end of the delay of the
+  // transaction, which bound the mem phase.
+  bool located;
+
+  size_t total(void) const {
+    size_t sum = 0;
+    for (size_t i = 0; i < NUM_LAT_PHASES; i++) {
+      sum += phases[i];
+    }
+    return sum;
+  }
+};
+
+// Sums of the phase durations over a set of transactions.
+struct LatencyAggregate {
+  size_t num_txns = 0;
+  size_t phase_sums[NUM_LAT_PHASES] = {0};
+  size_t max_total = 0;
+
+  void add(const LatencyRecord &rec) {
+    num_txns++;
+    for (size_t i = 0; i < NUM_LAT_PHASES; i++) {
+      phase_sums[i] += rec.phases[i];
+    }
+    max_total = std::max(max_total, rec.total());
+  }
+
+  /**
+   * Displays the mean phase durations on a single line.
+   *
+   * @param name the name of the line, for instance the channel and the ID
+   */
+  void display(const std::string &name) const {
+    size_t total_sum = 0;
+    std::cout << name << std::dec << ": transactions: " << num_txns;
+    for (size_t i = 0; i < NUM_LAT_PHASES; i++) {
+      total_sum += phase_sums[i];
+      std::cout << ", " << kLatPhaseNames[i] << ": "
+                << (num_txns ? (double)phase_sums[i] / num_txns : 0.);
+    }
+    std::cout << ", total: " << (num_txns ? (double)total_sum / num_txns : 0.)
+              << " (max: " << max_total << ")" << std::endl;
+  }
+};
+
+/**
+ * Attributes the latency of each transaction to the phases of lat_phase_e.
+ *
+ * The testbench reports the presentation and acceptance of the address
+ * requests, the responses of the real memory controller and the output
+ * handshakes, while the debug events of the design locate the transactions in
+ * the delay calculator through their internal identifiers. The responses of a
+ * given AXI identifier are delivered in order, hence they are matched with the
+ * oldest outstanding transaction of their identifier.
+ */
+class LatencyTracker {
+ public:
+  LatencyTracker() : next_seq_(0), measure_start_(0) {
+    for (size_t i = 0; i < NUM_LAT_CHANNELS; i++) {
+      presented_[i] = 0;
+      presented_v_[i] = false;
+    }
+  }
+
+  /**
+   * Only the transactions accepted from this cycle on are recorded.
+   */
+  void set_measure_start(size_t measure_start) {
+    measure_start_ = measure_start;
+  }
+
+  /**
+   * Signals that an address request is presented to the design. Only the first
+   * presentation of each request matters.
+   */
+  void present(lat_channel_e ch, size_t cycle) {
+    if (!presented_v_[ch]) {
+      presented_[ch] = cycle;
+      presented_v_[ch] = true;
+    }
+  }
+
+  /**
+   * Signals the acceptance of an address request.
+   *
+   * @param iid the internal identifier reserved for the request
+   * @param num_rsps the number of responses (or read data) of the burst
+   */
+  void accept(lat_channel_e ch, uint64_t axi_id, uint64_t iid, size_t num_rsps,
+              size_t cycle) {
+    Transaction txn;
+    txn.axi_id = axi_id;
+    txn.presented = presented_v_[ch] ? presented_[ch] : cycle;
+    txn.accepted = cycle;
+    txn.issued = cycle;
+    txn.done = cycle;
+    txn.rsp_in = cycle;
+    txn.issued_v = false;
+    txn.done_v = false;
+    txn.rsps_left = num_rsps;
+    txn.outs_left = num_rsps;
+    presented_v_[ch] = false;
+
+    txns_[next_seq_] = txn;
+    iid_txns_[ch][iid] = next_seq_;
+    rsp_queues_[ch][axi_id].push(next_seq_);
+    out_queues_[ch][axi_id].push(next_seq_);
+    next_seq_++;
+  }
+
+  /**
+   * Applies the issued and done multi-hot debug signals of the current cycle.
+   */
+  void apply_debug_events(lat_channel_e ch, uint64_t issued_mhot,
+                          uint64_t done_mhot, size_t cycle) {
+    uint64_t events_mhot = issued_mhot | done_mhot;
+    for (uint64_t iid = 0; iid < 64 && events_mhot >> iid; iid++) {
+      if (!(events_mhot >> iid & 1)) {
+        continue;
+      }
+      std::map<uint64_t, size_t>::iterator seq_it = iid_txns_[ch].find(iid);
+      if (seq_it == iid_txns_[ch].end() || !txns_.count(seq_it->second)) {
+        continue;
+      }
+      Transaction &txn = txns_[seq_it->second];
+      if ((issued_mhot >> iid & 1) && !txn.issued_v) {
+        txn.issued = cycle;
+        txn.issued_v = true;
+      }
+      if ((done_mhot >> iid & 1) && !txn.done_v) {
+        txn.done = cycle;
+        txn.done_v = true;
+      }
+    }
+  }
+
+  /**
+   * Signals a response (or read data) input from the real memory controller.
+   */
+  void realmem_response(lat_channel_e ch, uint64_t axi_id, size_t cycle) {
+    std::queue<size_t> &queue = rsp_queues_[ch][axi_id];
+    if (queue.empty()) {
+      return;
+    }
+    Transaction &txn = txns_[queue.front()];
+    if (--txn.rsps_left == 0) {
+      txn.rsp_in = cycle;
+      queue.pop();
+    }
+  }
+
+  /**
+   * Signals a response (or read data) output to the requester. Records the
+   * transaction when its last response is output.
+   */
+  void output(lat_channel_e ch, uint64_t axi_id, size_t cycle) {
+    std::queue<size_t> &queue = out_queues_[ch][axi_id];
+    if (queue.empty()) {
+      return;
+    }
+    size_t seq = queue.front();
+    Transaction &txn = txns_[seq];
+    if (--txn.outs_left != 0) {
+      return;
+    }
+    queue.pop();
+
+    if (txn.accepted >= measure_start_) {
+      // The phase boundaries are made monotonic, so that the phases add up to
+      // the total latency even if an event is missing or precedes the previous
+      // one.
+      size_t issued = std::max(txn.issued, txn.accepted);
+      size_t done = std::max(txn.done_v ? txn.done : issued, issued);
+      size_t rsp_in = std::max(txn.rsp_in, done);
+      size_t out = std::max(cycle, rsp_in);
+
+      LatencyRecord rec;
+      rec.channel = ch;
+      rec.axi_id = axi_id;
+      rec.accepted = txn.accepted;
+      rec.located = txn.issued_v && txn.done_v;
+      rec.phases[LAT_PHASE_SLOT] = txn.accepted - txn.presented;
+      rec.phases[LAT_PHASE_SCHED] = issued - txn.accepted;
+      rec.phases[LAT_PHASE_MEM] = done - issued;
+      rec.phases[LAT_PHASE_REALMEM] = rsp_in - done;
+      rec.phases[LAT_PHASE_OUTPUT] = out - rsp_in;
+      records_.push_back(rec);
+    }
+    txns_.erase(seq);
+  }
+
+  /**
+   * Displays the latency breakdown: the phases of each recorded transaction if
+   * display_txns is set, then the mean phases per channel and per AXI
+   * identifier.
+   */
+  void display(bool display_txns) const {
+    LatencyAggregate ch_aggr[NUM_LAT_CHANNELS];
+    std::map<uint64_t, LatencyAggregate> id_aggr[NUM_LAT_CHANNELS];
+
+    std::cout << "\n\n#### Latency breakdown ####" << std::endl;
+    for (size_t i = 0; i < records_.size(); i++) {
+      const LatencyRecord &rec = records_[i];
+      ch_aggr[rec.channel].add(rec);
+      id_aggr[rec.channel][rec.axi_id].add(rec);
+
+      if (display_txns) {
+        std::cout << "Transaction: " << kLatChannelNames[rec.channel]
+                  << ", ID " << std::dec << rec.axi_id << ", accepted at "
+                  << rec.accepted;
+        for (size_t i_ph = 0; i_ph < NUM_LAT_PHASES; i_ph++) {
+          std::cout << ", " << kLatPhaseNames[i_ph] << ": " << rec.phases[i_ph];
+        }
+        std::cout << ", total: " << rec.total() << std::endl;
+      }
+    }
+
+    std::cout << std::endl;
+    for (size_t i_ch = 0; i_ch < NUM_LAT_CHANNELS; i_ch++) {
+      ch_aggr[i_ch].display(std::string(kLatChannelNames[i_ch]) + " all IDs");
+      for (std::map<uint64_t, LatencyAggregate>::const_iterator it =
+               id_aggr[i_ch].begin();
+           it != id_aggr[i_ch].end(); ++it) {
+        std::ostringstream name;
+        name << kLatChannelNames[i_ch] << " ID " << it->first;
+        it->second.display(name.str());
+      }
+    }
+  }
+
+  const std::vector<LatencyRecord> &records(void) const { return records_; }
+
+  void serialize(VerilatedSerialize &os) const {
+    simmem_ckpt::serialize(os, next_seq_);
+    simmem_ckpt::serialize(os, presented_);
+    simmem_ckpt::serialize(os, presented_v_);
+    simmem_ckpt::serialize(os, txns_);
+    for (size_t i = 0; i < NUM_LAT_CHANNELS; i++) {
+      simmem_ckpt::serialize(os, iid_txns_[i]);
+      simmem_ckpt::serialize(os, rsp_queues_[i]);
+      simmem_ckpt::serialize(os, out_queues_[i]);
+    }
+  }
+
+  void deserialize(VerilatedDeserialize &is) {
+    simmem_ckpt::deserialize(is, next_seq_);
+    simmem_ckpt::deserialize(is, presented_);
+    simmem_ckpt::deserialize(is, presented_v_);
+    simmem_ckpt::deserialize(is, txns_);
+    for (size_t i = 0; i < NUM_LAT_CHANNELS; i++) {
+      simmem_ckpt::deserialize(is, iid_txns_[i]);
+      simmem_ckpt::deserialize(is, rsp_queues_[i]);
+      simmem_ckpt::deserialize(is, out_queues_[i]);
+    }
+  }
+
+ private:
+  // Event cycles of an outstanding transaction.
+  struct Transaction {
+    uint64_t axi_id;
+    size_t presented;
+    size_t accepted;
+    size_t issued;
+    size_t done;
+    size_t rsp_in;
+    bool issued_v;
+    bool done_v;
+    // Numbers of responses still expected from the real memory controller, and
+    // still to be output.
+    size_t rsps_left;
+    size_t outs_left;
+  };
+
+  // Outstanding transactions, indexed by increasing sequence numbers.
+  size_t next_seq_;
+  std::map<size_t, Transaction> txns_;
+  // First presentation of the current address request of each channel.
+  size_t presented_[NUM_LAT_CHANNELS];
+  bool presented_v_[NUM_LAT_CHANNELS];
+  // Transaction of each internal identifier.
+  std::map<uint64_t, size_t> iid_txns_[NUM_LAT_CHANNELS];
+  // Per AXI identifier, the transactions awaiting real memory responses, and
+  // awaiting outputs.
+  std::map<uint64_t, std::queue<size_t>> rsp_queues_[NUM_LAT_CHANNELS];
+  std::map<uint64_t, std::queue<size_t>> out_queues_[NUM_LAT_CHANNELS];
+
+  size_t measure_start_;
+  std::vector<LatencyRecord> records_;
+};
+
+}  // namespace simmem_lat
+
+#endif  // SIMMEM_DV_LATENCY
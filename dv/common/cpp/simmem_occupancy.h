@@ -0,0 +1,204 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the occupancy sampling of the toplevel testbench, which
+// records the occupancy of the delay calculator slots and of the response banks
+// as a CSV time series, and summarizes it at the end of the run.
+
+#ifndef SIMMEM_DV_OCCUPANCY
+#define SIMMEM_DV_OCCUPANCY
+
+#include "simmem_axi_dimensions.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <string>
+
+namespace simmem_occ {
+
+// The debug port of simmem_top carries the slot valid bits as multi-hot
+// signals, read as 64-bit integers.
+static_assert(NumWSlots <= 64 && NumRSlots <= 64,
+              "The occupancy sampling supports up to 64 slots.");
+
+// Occupancy of the delay calculator slots and of the response banks, read from
+// the debug port of simmem_top (see SimmemTestbench::simmem_get_occupancy).
+struct Occupancy {
+  // False if the design has no debug port, in which case the occupancy is
+  // empty.
+  bool valid = false;
+  size_t wslots = 0;
+  size_t rslots = 0;
+  // Lengths of the reservation and response queues of each AXI identifier.
+  size_t wrsv_lens[NumIds] = {0};
+  size_t wrsp_lens[NumIds] = {0};
+  size_t rrsv_lens[NumIds] = {0};
+  size_t rdata_lens[NumIds] = {0};
+
+  size_t wbank(void) const {
+    size_t sum = 0;
+    for (size_t i = 0; i < NumIds; i++) {
+      sum += wrsv_lens[i] + wrsp_lens[i];
+    }
+    return sum;
+  }
+
+  size_t rbank(void) const {
+    size_t sum = 0;
+    for (size_t i = 0; i < NumIds; i++) {
+      sum += rrsv_lens[i] + rdata_lens[i];
+    }
+    return sum;
+  }
+};
+
+/**
+ * Samples the occupancy of the design every given number of cycles. Each
+ * sample is written as a row of a CSV time series, and the samples are
+ * summarized at the end of the run. A sampler with a zero period is disabled,
+ * and only costs one test per cycle.
+ */
+class OccupancySampler {
+ public:
+  OccupancySampler() : period_(0), episode_(0), num_samples_(0) {}
+
+  /**
+   * Enables the sampler.
+   *
+   * @param path the CSV file
+   * @param period the sampling period, in cycles
+   */
+  void open(const std::string &path, size_t period) {
+    csv_.open(path.c_str());
+    if (!csv_) {
+      std::cerr << "Cannot open the occupancy file " << path << "."
+                << std::endl;
+      exit(1);
+    }
+    period_ = period;
+    path_ = path;
+
+    csv_ << "episode,cycle,wslots,rslots,wbank,rbank";
+    const char *const kLenNames[] = {"wrsv", "wrsp", "rrsv", "rdata"};
+    for (size_t i_len = 0; i_len < 4; i_len++) {
+      for (size_t i_id = 0; i_id < NumIds; i_id++) {
+        csv_ << "," << kLenNames[i_len] << "_id" << i_id;
+      }
+    }
+    csv_ << std::endl;
+  }
+
+  bool enabled(void) const { return period_ != 0; }
+
+  /**
+   * Checks whether a sample is due in the given cycle.
+   */
+  bool is_due(size_t cycle) const {
+    return period_ != 0 && cycle % period_ == 0;
+  }
+
+  void set_episode(size_t episode) { episode_ = episode; }
+
+  /**
+   * Records a sample.
+   */
+  void record(size_t cycle, const Occupancy &occ) {
+    size_t wbank = occ.wbank();
+    size_t rbank = occ.rbank();
+
+    csv_ << episode_ << "," << cycle << "," << occ.wslots << "," << occ.rslots
+         << "," << wbank << "," << rbank;
+    const size_t *const lens[] = {occ.wrsv_lens, occ.wrsp_lens, occ.rrsv_lens,
+                                  occ.rdata_lens};
+    for (size_t i_len = 0; i_len < 4; i_len++) {
+      for (size_t i_id = 0; i_id < NumIds; i_id++) {
+        csv_ << "," << lens[i_len][i_id];
+      }
+    }
+    csv_ << "\n";
+
+    num_samples_++;
+    stats_[OCC_WSLOTS].add(occ.wslots, NumWSlots);
+    stats_[OCC_RSLOTS].add(occ.rslots, NumRSlots);
+    stats_[OCC_WBANK].add(wbank, WRspBankCapa);
+    stats_[OCC_RBANK].add(rbank, RDataBankCapa);
+    for (size_t i_id = 0; i_id < NumIds; i_id++) {
+      id_stats_[0][i_id].add(occ.wrsv_lens[i_id] + occ.wrsp_lens[i_id],
+                             WRspBankCapa);
+      id_stats_[1][i_id].add(occ.rrsv_lens[i_id] + occ.rdata_lens[i_id],
+                             RDataBankCapa);
+    }
+  }
+
+  /**
+   * Displays the mean and maximal occupancies, and the fraction of the samples
+   * where each structure is full.
+   */
+  void display(void) {
+    static const char *const kOccNames[NUM_OCC] = {
+        "Write slots", "Read slots", "Write response bank", "Read data bank"};
+    static const size_t kOccCapas[NUM_OCC] = {NumWSlots, NumRSlots,
+                                              WRspBankCapa, RDataBankCapa};
+    if (!enabled()) {
+      return;
+    }
+    csv_.flush();
+
+    std::cout << "\n\n#### Occupancy ####" << std::endl;
+    std::cout << "Samples: " << std::dec << num_samples_ << " (every "
+              << period_ << " cycles, see " << path_ << ")" << std::endl;
+    for (size_t i = 0; i < NUM_OCC; i++) {
+      stats_[i].display(kOccNames[i], kOccCapas[i], num_samples_);
+    }
+    for (size_t i_id = 0; i_id < NumIds; i_id++) {
+      std::ostringstream wname, rname;
+      wname << "Write response bank ID " << i_id;
+      rname << "Read data bank ID " << i_id;
+      id_stats_[0][i_id].display(wname.str(), WRspBankCapa, num_samples_);
+      id_stats_[1][i_id].display(rname.str(), RDataBankCapa, num_samples_);
+    }
+  }
+
+ private:
+  typedef enum { OCC_WSLOTS, OCC_RSLOTS, OCC_WBANK, OCC_RBANK, NUM_OCC } occ_e;
+
+  // Summary of the samples of one quantity.
+  struct OccupancyStats {
+    size_t sum = 0;
+    size_t max = 0;
+    size_t num_full = 0;
+
+    void add(size_t val, size_t capa) {
+      sum += val;
+      max = std::max(max, val);
+      num_full += val >= capa;
+    }
+
+    void display(const std::string &name, size_t capa,
+                 size_t num_samples) const {
+      std::cout << name << ": mean: "
+                << (num_samples ? (double)sum / num_samples : 0.) << " / "
+                << capa << ", max: " << max << ", full: "
+                << (num_samples ? 100. * num_full / num_samples : 0.) << " %"
+                << std::endl;
+    }
+  };
+
+  size_t period_;
+  size_t episode_;
+  std::string path_;
+  std::ofstream csv_;
+
+  size_t num_samples_;
+  OccupancyStats stats_[NUM_OCC];
+  // Total queue lengths of each AXI identifier, in the write response and the
+  // read data banks.
+  OccupancyStats id_stats_[2][NumIds];
+};
+
+}  // namespace simmem_occ
+
+#endif  // SIMMEM_DV_OCCUPANCY
@@ -0,0 +1,125 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the testbench phase profiler. The testbench declares
+// the phase it enters (stimulus generation, model evaluation, scoreboard or
+// logging), and the profiler accumulates the wall-clock time spent in each
+// phase. The profiler is only enabled if SIMMEM_PROFILE is defined (see the
+// sim_simmem_top_prof target); otherwise, all its calls compile to nothing.
+
+#ifndef SIMMEM_DV_PROF
+#define SIMMEM_DV_PROF
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace simmem_prof {
+
+typedef enum {
+  PHASE_OTHER,
+  PHASE_STIMULUS,
+  PHASE_EVAL,
+  PHASE_SCOREBOARD,
+  PHASE_LOGGING,
+  NUM_PHASES
+} phase_e;
+
+#ifdef SIMMEM_PROFILE
+
+class PhaseProfiler {
+ public:
+  PhaseProfiler() : curr_phase_(PHASE_OTHER), last_(clock::now()) {
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+      phase_secs_[i] = 0.;
+    }
+  }
+
+  /**
+   * Charges the time elapsed since the last switch to the current phase, and
+   * enters a new phase.
+   *
+   * @param phase the new phase
+   *
+   * @return the previous phase
+   */
+  phase_e switch_to(phase_e phase) {
+    clock::time_point now = clock::now();
+    phase_secs_[curr_phase_] +=
+        std::chrono::duration<double>(now - last_).count();
+    last_ = now;
+
+    phase_e prev_phase = curr_phase_;
+    curr_phase_ = phase;
+    return prev_phase;
+  }
+
+  /**
+   * Displays the time spent in each phase.
+   */
+  void display(void) {
+    static const char *const kPhaseNames[NUM_PHASES] = {
+        "Other", "Stimulus", "Eval", "Scoreboard", "Logging"};
+    switch_to(curr_phase_);
+
+    double total_secs = 0.;
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+      total_secs += phase_secs_[i];
+    }
+
+    std::cout << "\n\n#### Testbench profile ####" << std::endl;
+    for (size_t i = 0; i < NUM_PHASES; i++) {
+      std::cout << "Phase " << kPhaseNames[i] << ": " << std::fixed
+                << std::setprecision(4) << phase_secs_[i] << " s ("
+                << std::setprecision(1)
+                << (total_secs > 0. ? 100. * phase_secs_[i] / total_secs : 0.)
+                << " %)" << std::endl;
+    }
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(6);
+  }
+
+ private:
+  typedef std::chrono::steady_clock clock;
+
+  phase_e curr_phase_;
+  clock::time_point last_;
+  double phase_secs_[NUM_PHASES];
+};
+
+#else
+
+class PhaseProfiler {
+ public:
+  phase_e switch_to(phase_e) { return PHASE_OTHER; }
+  void display(void) {}
+};
+
+#endif  // SIMMEM_PROFILE
+
+/**
+ * The profiler of the testbench.
+ */
+inline PhaseProfiler &profiler(void) {
+  static PhaseProfiler prof;
+  return prof;
+}
+
+/**
+ * Charges the time of a scope to a phase, and then returns to the previous
+ * phase.
+ */
+class PhaseScope {
+ public:
+  explicit PhaseScope(phase_e phase)
+      : prev_phase_(profiler().switch_to(phase)) {}
+  ~PhaseScope() { profiler().switch_to(prev_phase_); }
+
+ private:
+  phase_e prev_phase_;
+};
+
+}  // namespace simmem_prof
+
+#endif  // SIMMEM_DV_PROF
@@ -0,0 +1,117 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the worst-case stimulus search of the toplevel
+// testbench. The search is independent of the testbench: it mutates stimuli
+// (see simmem_stimulus.h), and relies on a callable to run each of them and
+// score the run.
+
+#ifndef SIMMEM_DV_SEARCH
+#define SIMMEM_DV_SEARCH
+
+#include "simmem_stimulus.h"
+#include <iostream>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace simmem_search {
+
+// Objectives of the worst-case stimulus search.
+typedef enum {
+  FUZZ_LATENCY,
+  FUZZ_THROUGHPUT,
+  NUM_FUZZ_OBJECTIVES
+} fuzz_objective_e;
+const char *const kFuzzObjectiveNames[NUM_FUZZ_OBJECTIVES] = {"latency",
+                                                              "throughput"};
+
+// Default length, in bytes, of the searched stimuli.
+const size_t kFuzzLen = 256;
+
+// Outcome of the run of a stimulus.
+struct RunOutcome {
+  // Description of the failure of the run, for instance "response mismatches",
+  // or null if the run passed.
+  const char *failure;
+  // Score of the run for the objective. The higher the score, the worse the
+  // run.
+  double score;
+};
+
+/**
+ * Searches for the stimulus that scores worst for an objective, by hill
+ * climbing: each iteration mutates the worst stimulus found so far, and keeps
+ * the mutant if it scores at least as bad. The worst stimulus is saved at each
+ * improvement. A stimulus whose run fails is saved and stops the search.
+ *
+ * @tparam Run a callable, which runs a stimulus and returns its RunOutcome
+ * @param run the callable
+ * @param seed the seed of the random number generator of the search
+ * @param start the stimulus to start from, or null to start from random bytes
+ * @param num_iterations the number of mutations to try
+ * @param max_len the maximal length of the stimulus, in bytes
+ * @param objective the objective
+ * @param out_path the file where the worst stimulus is saved
+ * @param worst the worst stimulus found, modified in place
+ *
+ * @return 0, or 1 if the run of a stimulus failed
+ */
+template <typename Run>
+int search_worst_stimulus(Run run, unsigned int seed,
+                          const std::vector<uint8_t> *start,
+                          size_t num_iterations, size_t max_len,
+                          fuzz_objective_e objective,
+                          const std::string &out_path,
+                          std::vector<uint8_t> &worst) {
+  std::mt19937 rng(seed);
+  worst.clear();
+  if (start) {
+    worst = *start;
+  } else {
+    for (size_t i = 0; i < max_len; i++) {
+      worst.push_back(rng());
+    }
+  }
+  double worst_score = run(worst).score;
+  simmem_stim::write_stimulus(out_path, worst);
+
+  for (size_t i_iter = 0; i_iter < num_iterations; i_iter++) {
+    std::vector<uint8_t> mutant(worst);
+    simmem_stim::mutate_stimulus(mutant, max_len, rng);
+    RunOutcome outcome = run(mutant);
+
+    if (outcome.failure) {
+      simmem_stim::write_stimulus(out_path, mutant);
+      std::cout << "Iteration " << std::dec << i_iter << ": "
+                << outcome.failure << ", stimulus saved to " << out_path << "."
+                << std::endl;
+      return 1;
+    }
+    if (outcome.score >= worst_score) {
+      if (outcome.score > worst_score) {
+        std::cout << "Iteration " << std::dec << i_iter << ": worst "
+                  << kFuzzObjectiveNames[objective]
+                  << " score: " << outcome.score << std::endl;
+        simmem_stim::write_stimulus(out_path, mutant);
+      }
+      worst.swap(mutant);
+      worst_score = outcome.score;
+    }
+  }
+  // Neutral mutations may have replaced the saved stimulus by an equivalent
+  // one.
+  simmem_stim::write_stimulus(out_path, worst);
+
+  std::cout << "\n\n#### Worst-case search ####" << std::endl;
+  std::cout << "Iterations: " << std::dec << num_iterations << ", worst "
+            << kFuzzObjectiveNames[objective] << " score: " << worst_score
+            << ", stimulus saved to " << out_path << std::endl;
+  return 0;
+}
+
+}  // namespace simmem_search
+
+#endif  // SIMMEM_DV_SEARCH
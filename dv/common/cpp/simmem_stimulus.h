@@ -0,0 +1,157 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the replayable requester stimulus of the toplevel
+// testbench: its decoding from a byte string, its files and its mutations,
+// which the worst-case search and the fuzzer rely on (see simmem_search.h).
+
+#ifndef SIMMEM_DV_STIMULUS
+#define SIMMEM_DV_STIMULUS
+
+#include "simmem_checkpoint.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <verilated_save.h>
+
+namespace simmem_stim {
+
+
+// Bits of the per-cycle byte of a decoded stimulus, which decide whether the
+// requester applies a write address, a read address and write data.
+const uint8_t kStimulusWAddr = 1 << 0;
+const uint8_t kStimulusRAddr = 1 << 1;
+const uint8_t kStimulusWData = 1 << 2;
+
+/**
+ * Decodes a byte string into the requester stimulus, as a replayable
+ * alternative to the random number generator. The string is consumed from both
+ * ends, so that a local mutation keeps the rest of the stimulus in place:
+ *  * from the front, one byte per cycle, whose kStimulus* bits decide which
+ *  inputs the requester applies in this cycle,
+ *  * from the back, four bytes per address request, which give its packed
+ *  content, including its AXI identifier and address.
+ * Once the string is exhausted, the requester stays idle and the requests are
+ * zero, so that the outstanding transactions drain.
+ */
+class StimulusDecoder {
+ public:
+  StimulusDecoder() : front_(0), back_(0) {}
+
+  explicit StimulusDecoder(const std::vector<uint8_t> &bytes)
+      : bytes_(bytes), front_(0), back_(bytes.size()) {}
+
+  /**
+   * @return the kStimulus* bits of the next cycle.
+   */
+  uint8_t next_cycle(void) { return front_ < back_ ? bytes_[front_++] : 0; }
+
+  /**
+   * @return the packed content of the next address request.
+   */
+  uint32_t next_request(void) {
+    uint32_t word = 0;
+    for (size_t i = 0; i < 4; i++) {
+      word <<= 8;
+      if (back_ > front_) {
+        word |= bytes_[--back_];
+      }
+    }
+    return word;
+  }
+
+  void serialize(VerilatedSerialize &os) const {
+    simmem_ckpt::serialize(os, bytes_);
+    simmem_ckpt::serialize(os, front_);
+    simmem_ckpt::serialize(os, back_);
+  }
+
+  void deserialize(VerilatedDeserialize &is) {
+    simmem_ckpt::deserialize(is, bytes_);
+    simmem_ckpt::deserialize(is, front_);
+    simmem_ckpt::deserialize(is, back_);
+  }
+
+ private:
+  std::vector<uint8_t> bytes_;
+  size_t front_;
+  size_t back_;
+};
+
+/**
+ * Reads a stimulus file, as saved by write_stimulus or by libFuzzer.
+ *
+ * @return false if the file cannot be read.
+ */
+inline bool read_stimulus(const std::string &path,
+                          std::vector<uint8_t> &stimulus) {
+  std::ifstream file(path.c_str(), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  stimulus.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+  return true;
+}
+
+/**
+ * Writes a stimulus file, which can be replayed with +replay.
+ */
+inline void write_stimulus(const std::string &path,
+                           const std::vector<uint8_t> &stimulus) {
+  std::ofstream file(path.c_str(), std::ios::binary);
+  file.write((const char *)stimulus.data(), stimulus.size());
+}
+
+/**
+ * Applies one random mutation to a stimulus: flipping a bit, replacing a byte,
+ * inserting or erasing a byte, or copying a chunk over another place, which
+ * repeats a pattern of requests.
+ *
+ * @param stimulus the stimulus to mutate
+ * @param max_len the maximal length of the stimulus
+ * @param rng the random number generator of the search
+ */
+inline void mutate_stimulus(std::vector<uint8_t> &stimulus, size_t max_len,
+                            std::mt19937 &rng) {
+  if (stimulus.empty()) {
+    stimulus.push_back(rng());
+    return;
+  }
+  size_t pos = rng() % stimulus.size();
+  switch (rng() % 5) {
+    case 0:
+      stimulus[pos] ^= 1 << (rng() % 8);
+      break;
+    case 1:
+      stimulus[pos] = rng();
+      break;
+    case 2:
+      if (stimulus.size() < max_len) {
+        stimulus.insert(stimulus.begin() + pos, (uint8_t)rng());
+      }
+      break;
+    case 3:
+      if (stimulus.size() > 1) {
+        stimulus.erase(stimulus.begin() + pos);
+      }
+      break;
+    default: {
+      size_t len = 1 + rng() % std::min<size_t>(16, stimulus.size());
+      size_t src = rng() % (stimulus.size() - len + 1);
+      size_t dst = rng() % (stimulus.size() - len + 1);
+      std::copy(stimulus.begin() + src, stimulus.begin() + src + len,
+                stimulus.begin() + dst);
+      break;
+    }
+  }
+}
+
+}  // namespace simmem_stim
+
+#endif  // SIMMEM_DV_STIMULUS
@@ -0,0 +1,398 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// This header defines the liveness watchdog of the toplevel testbench, which
+// checks online that every transaction completes within a bound derived from
+// the configuration, and reports the state of the design on a violation.
+
+#ifndef SIMMEM_DV_WATCHDOG
+#define SIMMEM_DV_WATCHDOG
+
+#include "simmem_axi_dimensions.h"
+#include "simmem_checkpoint.h"
+#include "simmem_latency.h"
+#include "simmem_occupancy.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <stdint.h>
+#include <vector>
+#include <verilated_save.h>
+
+namespace simmem_wd {
+
+// Number of cycles of handshakes displayed by the watchdog on a violation.
+const size_t kWatchdogWindow = 32;
+// Margin factor and slack, in cycles, of the default watchdog bound.
+const size_t kWatchdogMargin = 2;
+const size_t kWatchdogSlack = 100;
+
+/**
+ * Derives the default bound of the watchdog from the timing parameters and the
+ * capacities. The response banks limit the outstanding bursts, hence a
+ * transaction waits at most for all the bank entries to be served before its
+ * own, each beat costing at most the worst cost of one memory request of the
+ * delay engine, followed by the output of all the responses. With the row
+ * buffer engine, this cost is taken with the maximal latency scale and offset,
+ * which may be written at runtime through the configuration port.
+ *
+ * @return the bound, in cycles
+ */
+inline size_t default_watchdog_bound(void) {
+  size_t request_cost;
+  if (DelayEngine == DELAY_ENGINE_STAT) {
+    request_cost = (1 << StatLatW) - 1;
+  } else if (DelayEngine == DELAY_ENGINE_FIXED) {
+    request_cost = std::max(FixedWLat, FixedRLat);
+  } else {
+    // The inter-command constraints, which are not scaled, come on top of the
+    // maximal delay, converted to clk_i cycles and rounded up.
+    size_t constr_cost =
+        ActToActCost + FourActWindowCost + WrToRdCost + RdToWrCost;
+    request_cost = MaxScaledDelay + ((constr_cost * MemClkRatio +
+                                      (1 << MemClkRatioFracW) - 1) >>
+                                     MemClkRatioFracW);
+  }
+  size_t num_beats = (WRspBankCapa + RDataBankCapa) * MaxBurstEffLen;
+  return kWatchdogMargin * num_beats * (request_cost + 1) + kWatchdogSlack;
+}
+
+// Handshakes recorded by the watchdog.
+typedef enum {
+  WD_EV_WADDR_IN,
+  WD_EV_RADDR_IN,
+  WD_EV_WDATA_IN,
+  WD_EV_WRSP_OUT,
+  WD_EV_RDATA_OUT,
+  NUM_WD_EVENTS
+} watchdog_event_e;
+
+const char *const kWatchdogEventNames[NUM_WD_EVENTS] = {
+    "waddr in", "raddr in", "wdata in", "wrsp out", "rdata out"};
+
+/**
+ * Checks online that every transaction completes within a bound:
+ *  * an accepted transaction must deliver its (last) response within the bound,
+ *  counted from its acceptance for the read transactions, and from the arrival
+ *  of its last write data for the write transactions, as their data are up to
+ *  the requester,
+ *  * a presented address request must be accepted within the bound, counted
+ *  in cycles where it is presented. A write address is only counted while all
+ *  the accepted write bursts have their data, as write bursts waiting for data
+ *  may legitimately hold the write resources.
+ * On a violation, the watchdog reports the stuck transaction, the outstanding
+ * transactions and the handshakes of the last kWatchdogWindow cycles. A
+ * watchdog with a zero bound is disabled.
+ */
+class LivenessWatchdog {
+ public:
+  LivenessWatchdog()
+      : bound_(0),
+        next_seq_(0),
+        wbeats_needed_(0),
+        wbeats_received_(0),
+        window_(kWatchdogWindow) {
+    for (size_t i = 0; i < simmem_lat::NUM_LAT_CHANNELS; i++) {
+      presented_cycles_[i] = 0;
+    }
+  }
+
+  /**
+   * @param bound the bound, in cycles, or zero to disable the watchdog
+   */
+  void set_bound(size_t bound) { bound_ = bound; }
+
+  bool enabled(void) const { return bound_ != 0; }
+
+  /**
+   * Starts recording the handshakes of a new cycle.
+   */
+  void begin_cycle(size_t cycle) {
+    if (!enabled()) {
+      return;
+    }
+    WindowCycle &wc = window_[cycle % kWatchdogWindow];
+    wc.cycle = cycle;
+    wc.events = 0;
+  }
+
+  /**
+   * Signals that an address request is presented to the design.
+   */
+  void present(simmem_lat::lat_channel_e ch) {
+    if (enabled() && (ch == simmem_lat::LAT_CH_READ || wdata_queue_.empty())) {
+      presented_cycles_[ch]++;
+    }
+  }
+
+  /**
+   * Signals the acceptance of an address request.
+   *
+   * @param num_beats the number of data of the burst
+   */
+  void accept(simmem_lat::lat_channel_e ch, uint64_t axi_id, uint64_t addr,
+              size_t num_beats, size_t cycle) {
+    if (!enabled()) {
+      return;
+    }
+    Transaction txn;
+    txn.axi_id = axi_id;
+    txn.addr = addr;
+    txn.accepted = cycle;
+    txn.started = cycle;
+    txn.started_v = true;
+    txn.outs_left = ch == simmem_lat::LAT_CH_WRITE ? 1 : num_beats;
+    if (ch == simmem_lat::LAT_CH_WRITE) {
+      // The write data are associated with the write bursts in order.
+      wbeats_needed_ += num_beats;
+      txn.wbeats_needed = wbeats_needed_;
+      if (wbeats_received_ < wbeats_needed_) {
+        txn.started_v = false;
+        wdata_queue_.push(next_seq_);
+      }
+    }
+    presented_cycles_[ch] = 0;
+
+    txns_[next_seq_] = txn;
+    out_queues_[ch][axi_id].push(next_seq_);
+    next_seq_++;
+    record(ch == simmem_lat::LAT_CH_WRITE ? WD_EV_WADDR_IN : WD_EV_RADDR_IN,
+           axi_id, cycle);
+  }
+
+  /**
+   * Signals the acceptance of write data.
+   */
+  void wdata(size_t cycle) {
+    if (!enabled()) {
+      return;
+    }
+    wbeats_received_++;
+    while (!wdata_queue_.empty() &&
+           txns_[wdata_queue_.front()].wbeats_needed <= wbeats_received_) {
+      Transaction &txn = txns_[wdata_queue_.front()];
+      txn.started = cycle;
+      txn.started_v = true;
+      wdata_queue_.pop();
+    }
+    record(WD_EV_WDATA_IN, 0, cycle);
+  }
+
+  /**
+   * Signals a response (or read data) output to the requester.
+   */
+  void output(simmem_lat::lat_channel_e ch, uint64_t axi_id, size_t cycle) {
+    if (!enabled()) {
+      return;
+    }
+    record(ch == simmem_lat::LAT_CH_WRITE ? WD_EV_WRSP_OUT : WD_EV_RDATA_OUT,
+           axi_id, cycle);
+    std::queue<size_t> &queue = out_queues_[ch][axi_id];
+    if (queue.empty()) {
+      return;
+    }
+    if (--txns_[queue.front()].outs_left == 0) {
+      txns_.erase(queue.front());
+      queue.pop();
+    }
+  }
+
+  /**
+   * Checks the bound at the end of a cycle. The oldest outstanding transaction
+   * of each AXI identifier is the one that has waited longest.
+   *
+   * @return true iff a transaction or an address request exceeds the bound
+   */
+  bool check(size_t cycle) {
+    if (!enabled()) {
+      return false;
+    }
+    for (size_t i_ch = 0; i_ch < simmem_lat::NUM_LAT_CHANNELS; i_ch++) {
+      violation_.channel = (simmem_lat::lat_channel_e)i_ch;
+      if (presented_cycles_[i_ch] > bound_) {
+        violation_.accepted = false;
+        violation_.cycle = cycle;
+        return true;
+      }
+      for (std::map<uint64_t, std::queue<size_t>>::const_iterator it =
+               out_queues_[i_ch].begin();
+           it != out_queues_[i_ch].end(); ++it) {
+        if (it->second.empty()) {
+          continue;
+        }
+        const Transaction &txn = txns_[it->second.front()];
+        if (txn.started_v && cycle - txn.started > bound_) {
+          violation_.accepted = true;
+          violation_.txn = txn;
+          violation_.cycle = cycle;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Displays the last violation found by check, the outstanding transactions,
+   * the occupancy of the design and the handshakes of the last cycles.
+   *
+   * @param occ the occupancy of the design in the cycle of the violation
+   */
+  void display_violation(const simmem_occ::Occupancy &occ) const {
+    const Violation &vio = violation_;
+    std::cout << "\n\n#### Watchdog ####" << std::endl;
+    std::cout << std::dec << "Bound: " << bound_ << " cycles" << std::endl;
+    if (vio.accepted) {
+      const Transaction &txn = vio.txn;
+      std::cout << simmem_lat::kLatChannelNames[vio.channel]
+                << " transaction of ID " << txn.axi_id << " (address 0x"
+                << std::hex << txn.addr << std::dec << "), accepted at cycle "
+                << txn.accepted
+                << ", is still outstanding at cycle " << vio.cycle << ", "
+                << vio.cycle - txn.started << " cycles after "
+                << (vio.channel == simmem_lat::LAT_CH_WRITE
+                        ? "its last write data"
+                        : "its acceptance")
+                << "." << std::endl;
+    } else {
+      std::cout << simmem_lat::kLatChannelNames[vio.channel]
+                << " address request not accepted after "
+                << presented_cycles_[vio.channel]
+                << " cycles of presentation, at cycle " << vio.cycle << "."
+                << std::endl;
+    }
+
+    for (size_t i_ch = 0; i_ch < simmem_lat::NUM_LAT_CHANNELS; i_ch++) {
+      std::cout << simmem_lat::kLatChannelNames[i_ch]
+                << " bursts outstanding per ID:";
+      for (std::map<uint64_t, std::queue<size_t>>::const_iterator it =
+               out_queues_[i_ch].begin();
+           it != out_queues_[i_ch].end(); ++it) {
+        std::cout << " " << it->first << ": " << it->second.size();
+      }
+      std::cout << std::endl;
+    }
+    std::cout << "Write bursts waiting for data: " << wdata_queue_.size()
+              << std::endl;
+
+    if (occ.valid) {
+      std::cout << "Write slots: " << occ.wslots << " / " << NumWSlots
+                << ", read slots: " << occ.rslots << " / " << NumRSlots
+                << std::endl;
+      for (size_t i_id = 0; i_id < NumIds; i_id++) {
+        std::cout << "Bank lengths of ID " << i_id
+                  << ": write reserved: " << occ.wrsv_lens[i_id]
+                  << ", write responses: " << occ.wrsp_lens[i_id]
+                  << ", read reserved: " << occ.rrsv_lens[i_id]
+                  << ", read data: " << occ.rdata_lens[i_id] << std::endl;
+      }
+    }
+
+    size_t first = vio.cycle + 1 >= kWatchdogWindow
+                       ? vio.cycle + 1 - kWatchdogWindow
+                       : 0;
+    std::cout << "Handshakes from cycle " << first << " (see the waveforms):"
+              << std::endl;
+    for (size_t cycle = first; cycle <= vio.cycle; cycle++) {
+      const WindowCycle &wc = window_[cycle % kWatchdogWindow];
+      if (wc.cycle != cycle || !wc.events) {
+        continue;
+      }
+      std::cout << "Cycle " << cycle << ":";
+      for (size_t i_ev = 0; i_ev < NUM_WD_EVENTS; i_ev++) {
+        if (wc.events >> i_ev & 1) {
+          std::cout << " " << kWatchdogEventNames[i_ev];
+          if (i_ev != WD_EV_WDATA_IN) {
+            std::cout << " (ID " << wc.ids[i_ev] << ")";
+          }
+        }
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  void serialize(VerilatedSerialize &os) const {
+    simmem_ckpt::serialize(os, next_seq_);
+    simmem_ckpt::serialize(os, presented_cycles_);
+    simmem_ckpt::serialize(os, wbeats_needed_);
+    simmem_ckpt::serialize(os, wbeats_received_);
+    simmem_ckpt::serialize(os, txns_);
+    simmem_ckpt::serialize(os, wdata_queue_);
+    for (size_t i = 0; i < simmem_lat::NUM_LAT_CHANNELS; i++) {
+      simmem_ckpt::serialize(os, out_queues_[i]);
+    }
+  }
+
+  void deserialize(VerilatedDeserialize &is) {
+    simmem_ckpt::deserialize(is, next_seq_);
+    simmem_ckpt::deserialize(is, presented_cycles_);
+    simmem_ckpt::deserialize(is, wbeats_needed_);
+    simmem_ckpt::deserialize(is, wbeats_received_);
+    simmem_ckpt::deserialize(is, txns_);
+    simmem_ckpt::deserialize(is, wdata_queue_);
+    for (size_t i = 0; i < simmem_lat::NUM_LAT_CHANNELS; i++) {
+      simmem_ckpt::deserialize(is, out_queues_[i]);
+    }
+  }
+
+ private:
+  // An outstanding transaction. Its age is counted from the start cycle, if
+  // started_v is set.
+  struct Transaction {
+    uint64_t axi_id;
+    uint64_t addr;
+    size_t accepted;
+    size_t started;
+    bool started_v;
+    // Number of write data received when the burst has all its data.
+    size_t wbeats_needed;
+    // Number of responses (or read data) still to be output.
+    size_t outs_left;
+  };
+
+  struct Violation {
+    simmem_lat::lat_channel_e channel;
+    // If not set, the address request is not accepted.
+    bool accepted;
+    Transaction txn;
+    size_t cycle;
+  };
+
+  // Handshakes of one cycle.
+  struct WindowCycle {
+    size_t cycle = SIZE_MAX;
+    uint8_t events = 0;
+    uint64_t ids[NUM_WD_EVENTS];
+  };
+
+  void record(watchdog_event_e event, uint64_t axi_id, size_t cycle) {
+    WindowCycle &wc = window_[cycle % kWatchdogWindow];
+    wc.events |= 1 << event;
+    wc.ids[event] = axi_id;
+  }
+
+  size_t bound_;
+
+  // Outstanding transactions, indexed by increasing sequence numbers.
+  size_t next_seq_;
+  std::map<size_t, Transaction> txns_;
+  // Cycles of presentation of the current address request of each channel.
+  size_t presented_cycles_[simmem_lat::NUM_LAT_CHANNELS];
+  // Cumulative numbers of write data needed by the accepted write bursts, and
+  // received, and the write bursts waiting for their data.
+  size_t wbeats_needed_;
+  size_t wbeats_received_;
+  std::queue<size_t> wdata_queue_;
+  // Per AXI identifier, the transactions awaiting outputs.
+  std::map<uint64_t, std::queue<size_t>>
+      out_queues_[simmem_lat::NUM_LAT_CHANNELS];
+
+  Violation violation_;
+  std::vector<WindowCycle> window_;
+};
+
+}  // namespace simmem_wd
+
+#endif  // SIMMEM_DV_WATCHDOG
@@ -0,0 +1,484 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// This testbench measures the interference between the requester ports of the
+// multi-port simulated memory controller:
+//  * Per-port latency of write responses and read data.
+//  * Per-port bandwidth, in data beats per cycle.
+//  * Per-port routing of the responses.
+//
+// The testbench is divided into 3 parts:
+//  * Definition of the MultiportTestbench class, which is the interface with
+//  the design under test. Each port is a lane of the packed channels of the
+//  design, handled by the bus functional models of simmem_bfm.h.
+//  * Definition of a RealMemoryController class, which emulates a simple and
+//  instantaneous real memory controller.
+//  * Definition of a randomized testbench, where each port issues requests with
+//  its own probability and QoS value.
+
+#include "Vsimmem_multiport_top.h"
+#include "Vsimmem_multiport_top_simmem_pkg.h"
+#include "simmem_axi_structures.h"
+#include "simmem_bfm.h"
+#include "simmem_dims_check.h"
+#include "verilated.h"
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <stdlib.h>
+#include <vector>
+#include <verilated_fst_c.h>
+
+// Length of the reset signal.
+const int kResetLength = 5;  // Cycles
+// Depth of the trace.
+const int kTraceLevel = 6;
+
+// Number of ports of the design, and number of identifier MSBs used to tag the
+// port, log2(kNumPorts). The design is built with the default NumPorts of the
+// package (SIMMEM_NUM_PORTS).
+const size_t kNumPorts = NumPorts;
+const size_t kPortIdW = PortIdW;
+
+// Constant burst lengths supplied to the DUT
+const int kWBurstLenField = 3;
+const int kRBurstLenField = 2;
+
+// Constant burst sizes supplied to the DUT
+const int kWBurstSizeField = 2;
+const int kRBurstSizeField = 2;
+
+// Port settings: port i uses the settings i modulo kNumPortSettings, so that
+// they hold for any number of ports.
+const size_t kNumPortSettings = 2;
+// Probability (in percent) that a port issues a new address request in a given
+// cycle, if it is not already waiting for one to be accepted.
+const unsigned int kPortReqProb[kNumPortSettings] = {50, 50};
+// AxQOS value of the address requests, per port. Only relevant if the DUT is
+// configured with the ARB_QOS arbitration mode.
+const uint64_t kPortQos[kNumPortSettings] = {0, 0};
+
+// Determines seed for the randomized testbench.
+const unsigned int kSeed = 2;
+
+// Determines the number of steps per randomized testbench.
+const size_t kNumRandomTestSteps = 1000;
+// Number of trailing cycles to let the outstanding requests complete.
+const size_t kNumTrailingSteps = 200;
+
+typedef Vsimmem_multiport_top Module;
+typedef Vsimmem_multiport_top_simmem_pkg ModulePkg;
+
+// Channels of the design. The requester-side signals pack the channels of all
+// the ports: each port is a lane of the channel (see simmem_bfm.h).
+SIMMEM_BFM_PORT(WAddrInPort, waddr_i, waddr_in_valid_i, waddr_in_ready_o);
+SIMMEM_BFM_PORT(WDataInPort, wdata_i, wdata_in_valid_i, wdata_in_ready_o);
+SIMMEM_BFM_PORT(RAddrInPort, raddr_i, raddr_in_valid_i, raddr_in_ready_o);
+SIMMEM_BFM_PORT(WRspOutPort, wrsp_o, wrsp_out_valid_o, wrsp_out_ready_i);
+SIMMEM_BFM_PORT(RDataOutPort, rdata_o, rdata_out_valid_o, rdata_out_ready_i);
+SIMMEM_BFM_PORT(WRspInPort, wrsp_i, wrsp_in_valid_i, wrsp_in_ready_o);
+SIMMEM_BFM_PORT(RDataInPort, rdata_i, rdata_in_valid_i, rdata_in_ready_o);
+SIMMEM_BFM_PORT(WAddrOutPort, waddr_o, waddr_out_valid_o, waddr_out_ready_i);
+SIMMEM_BFM_PORT(WDataOutPort, wdata_o, wdata_out_valid_o, wdata_out_ready_i);
+SIMMEM_BFM_PORT(RAddrOutPort, raddr_o, raddr_out_valid_o, raddr_out_ready_i);
+
+// This class implements elementary interaction with the design under test. The
+// requesters, one per port, and the real memory controller interact with the
+// design through the public channel members: the signals of all the channels
+// are applied at once by simmem_apply_channels, which settles the design, so
+// that the handshakes of the cycle can then be checked.
+class MultiportTestbench : public simmem_bfm::SimHarness<Module> {
+ public:
+  /**
+   * @param record_trace set to false to skip trace recording
+   */
+  MultiportTestbench(bool record_trace = true,
+                     const std::string &trace_filename = "sim.fst")
+      : simmem_bfm::SimHarness<Module>(record_trace, trace_filename,
+                                       kTraceLevel),
+        realmem_wrsp(module_.get()),
+        realmem_rdata(module_.get()),
+        realmem_waddr(module_.get()),
+        realmem_wdata(module_.get()),
+        realmem_raddr(module_.get()) {
+    // The messages would be packed with wrong field widths.
+    if (!simmem_dims::matches_model<ModulePkg>()) {
+      std::cerr << "Regenerate simmem_axi_dimensions.h with the overrides of "
+                   "the model (see SIMMEM_DEFINES)."
+                << std::endl;
+      exit(1);
+    }
+    for (size_t port = 0; port < kNumPorts; port++) {
+      requester_waddr.emplace_back(module_.get(), port);
+      requester_wdata.emplace_back(module_.get(), port);
+      requester_raddr.emplace_back(module_.get(), port);
+      requester_wrsp.emplace_back(module_.get(), port);
+      requester_rdata.emplace_back(module_.get(), port);
+    }
+  }
+
+  void simmem_reset(void) {
+    simmem_bfm::stop_all(requester_waddr, requester_wdata, requester_raddr,
+                         requester_wrsp, requester_rdata, realmem_wrsp,
+                         realmem_rdata, realmem_waddr, realmem_wdata,
+                         realmem_raddr);
+    drive_channels();
+    pulse_reset(kResetLength);
+  }
+
+  /**
+   * Performs one or multiple clock cycles, with the signals of the channels.
+   *
+   * @param num_ticks the number of ticks to perform at once
+   */
+  void simmem_tick(int num_ticks = 1) {
+    drive_channels();
+    tick(num_ticks);
+  }
+
+  /**
+   * Applies the signals of all the channels and settles the design, once all
+   * the inputs of the cycle have been set.
+   */
+  void simmem_apply_channels(void) {
+    drive_channels();
+    settle();
+  }
+
+  size_t simmem_get_tick_count(void) { return tick_count_; }
+
+  // Requester side, indexed by port.
+  std::vector<simmem_bfm::Driver<Module, WriteAddress, WAddrInPort>>
+      requester_waddr;
+  std::vector<simmem_bfm::Driver<Module, WriteData, WDataInPort>>
+      requester_wdata;
+  std::vector<simmem_bfm::Driver<Module, ReadAddress, RAddrInPort>>
+      requester_raddr;
+  std::vector<simmem_bfm::Monitor<Module, WriteResponse, WRspOutPort>>
+      requester_wrsp;
+  std::vector<simmem_bfm::Monitor<Module, ReadData, RDataOutPort>>
+      requester_rdata;
+
+  // Real memory controller side.
+  simmem_bfm::Driver<Module, WriteResponse, WRspInPort> realmem_wrsp;
+  simmem_bfm::Driver<Module, ReadData, RDataInPort> realmem_rdata;
+  simmem_bfm::Monitor<Module, WriteAddress, WAddrOutPort> realmem_waddr;
+  simmem_bfm::Monitor<Module, WriteData, WDataOutPort> realmem_wdata;
+  simmem_bfm::Monitor<Module, ReadAddress, RAddrOutPort> realmem_raddr;
+
+ private:
+  void drive_channels(void) {
+    simmem_bfm::drive_all(requester_waddr, requester_wdata, requester_raddr,
+                          requester_wrsp, requester_rdata, realmem_wrsp,
+                          realmem_rdata, realmem_waddr, realmem_wdata,
+                          realmem_raddr);
+  }
+};
+
+// Emulates an instantaneous real memory controller. Write responses are
+// issued once all the write data of the burst have been received. Responses
+// are issued in order of acceptance.
+class RealMemoryController {
+ public:
+  RealMemoryController() : wdata_cnt_(0) {}
+
+  void accept_waddr(WriteAddress waddr) { waddr_expecting_data_.push(waddr); }
+
+  void accept_wdata(void) {
+    wdata_cnt_++;
+    if (!waddr_expecting_data_.empty() &&
+        wdata_cnt_ == waddr_expecting_data_.front().burst_len + 1) {
+      WriteResponse wrsp;
+      wrsp.id = waddr_expecting_data_.front().id;
+      wrsp.rsp = 0;  // "OK" response
+      wrsp_out_queue_.push(wrsp);
+      waddr_expecting_data_.pop();
+      wdata_cnt_ = 0;
+    }
+  }
+
+  void accept_raddr(ReadAddress raddr) {
+    for (size_t i = 0; i < raddr.burst_len + 1; i++) {
+      ReadData rdata;
+      rdata.id = raddr.id;
+      rdata.data = raddr.addr + i;
+      rdata.rsp = 0;  // "OK" response
+      rdata.last = i == raddr.burst_len;
+      rdata_out_queue_.push(rdata);
+    }
+  }
+
+  bool has_wrsp(void) { return !wrsp_out_queue_.empty(); }
+  bool has_rdata(void) { return !rdata_out_queue_.empty(); }
+  WriteResponse get_next_wrsp(void) { return wrsp_out_queue_.front(); }
+  ReadData get_next_rdata(void) { return rdata_out_queue_.front(); }
+  void pop_next_wrsp(void) { wrsp_out_queue_.pop(); }
+  void pop_next_rdata(void) { rdata_out_queue_.pop(); }
+
+ private:
+  size_t wdata_cnt_;  // Write data received for the oldest waddr
+  std::queue<WriteAddress> waddr_expecting_data_;
+  std::queue<WriteResponse> wrsp_out_queue_;
+  std::queue<ReadData> rdata_out_queue_;
+};
+
+// Per-port statistics.
+struct PortStats {
+  size_t num_waddr;
+  size_t num_raddr;
+  size_t num_wrsp;
+  size_t num_rbursts;
+  size_t num_wdata_beats;
+  size_t num_rdata_beats;
+  size_t wlatency_sum, wlatency_max;
+  size_t rlatency_sum, rlatency_max;
+  size_t num_misrouted;
+
+  PortStats()
+      : num_waddr(0),
+        num_raddr(0),
+        num_wrsp(0),
+        num_rbursts(0),
+        num_wdata_beats(0),
+        num_rdata_beats(0),
+        wlatency_sum(0),
+        wlatency_max(0),
+        rlatency_sum(0),
+        rlatency_max(0),
+        num_misrouted(0) {}
+};
+
+/**
+ * Displays the per-port statistics.
+ *
+ * @param stats the per-port statistics
+ * @param num_cycles the number of cycles over which the bandwidth is computed
+ */
+void display_stats(const std::vector<PortStats> &stats, size_t num_cycles) {
+  std::cout << "\n#### Per-port statistics ####" << std::endl;
+  for (size_t port = 0; port < stats.size(); port++) {
+    const PortStats &s = stats[port];
+    std::cout << "\n--- Port " << std::dec << port << " ---" << std::endl;
+    std::cout << "Write bursts: " << s.num_wrsp << "/" << s.num_waddr
+              << ", mean latency: "
+              << (s.num_wrsp ? (double)s.wlatency_sum / s.num_wrsp : 0.)
+              << ", max latency: " << s.wlatency_max << std::endl;
+    std::cout << "Read bursts:  " << s.num_rbursts << "/" << s.num_raddr
+              << ", mean latency: "
+              << (s.num_rbursts ? (double)s.rlatency_sum / s.num_rbursts : 0.)
+              << ", max latency: " << s.rlatency_max << std::endl;
+    std::cout << "Bandwidth: " << std::fixed << std::setprecision(3)
+              << (double)(s.num_wdata_beats + s.num_rdata_beats) / num_cycles
+              << " beats/cycle (write: "
+              << (double)s.num_wdata_beats / num_cycles
+              << ", read: " << (double)s.num_rdata_beats / num_cycles << ")"
+              << std::defaultfloat << std::endl;
+    std::cout << "Misrouted responses: " << s.num_misrouted << std::endl;
+  }
+}
+
+/**
+ * This function implements a randomized and automatic testbench, where all the
+ * ports compete for the simulated memory controller.
+ *
+ * @param tb A pointer the the already contructed MultiportTestbench object.
+ * @param seed The seed for the randomized test.
+ * @param num_cycles The number of simulated clock cycles where new requests
+ * can be issued.
+ */
+void randomized_testbench(MultiportTestbench *tb, unsigned int seed,
+                          size_t num_cycles) {
+  srand(seed);
+
+  RealMemoryController realmem;
+  std::vector<PortStats> stats(kNumPorts);
+
+  // Number of identifiers available to each port.
+  const uint64_t num_port_ids = 1 << (IDWidth - kPortIdW);
+
+  // Current requests of each port, and whether they are applied.
+  std::vector<WriteAddress> port_waddr(kNumPorts);
+  std::vector<ReadAddress> port_raddr(kNumPorts);
+  std::vector<bool> port_waddr_valid(kNumPorts, false);
+  std::vector<bool> port_raddr_valid(kNumPorts, false);
+  // Number of write data beats owed by each port, for the accepted waddr.
+  std::vector<size_t> port_wdata_owed(kNumPorts, 0);
+
+  // Timestamps of the accepted address requests, per port and per identifier.
+  std::vector<std::map<uint64_t, std::queue<size_t>>> waddr_times(kNumPorts);
+  std::vector<std::map<uint64_t, std::queue<size_t>>> raddr_times(kNumPorts);
+
+  tb->simmem_reset();
+  for (size_t port = 0; port < kNumPorts; port++) {
+    tb->requester_wrsp[port].request();
+    tb->requester_rdata[port].request();
+  }
+  tb->realmem_waddr.request();
+  tb->realmem_raddr.request();
+  tb->realmem_wdata.request();
+
+  size_t start_time = tb->simmem_get_tick_count();
+
+  for (size_t step = 0; step < num_cycles + kNumTrailingSteps; step++) {
+    size_t curr_time = tb->simmem_get_tick_count();
+    bool issue_allowed = step < num_cycles;
+
+    //////////////////////
+    // Apply the inputs //
+    //////////////////////
+
+    for (size_t port = 0; port < kNumPorts; port++) {
+      unsigned int req_prob = kPortReqProb[port % kNumPortSettings];
+      uint64_t qos = kPortQos[port % kNumPortSettings];
+      if (!port_waddr_valid[port] && issue_allowed &&
+          (unsigned int)(rand() % 100) < req_prob) {
+        port_waddr[port].from_packed(rand());
+        port_waddr[port].id = rand() % num_port_ids;
+        port_waddr[port].burst_len = kWBurstLenField;
+        port_waddr[port].burst_size = kWBurstSizeField;
+        port_waddr[port].burst_type = BURST_INCR;
+        port_waddr[port].qos = qos;
+        port_waddr_valid[port] = true;
+      }
+      if (!port_raddr_valid[port] && issue_allowed &&
+          (unsigned int)(rand() % 100) < req_prob) {
+        port_raddr[port].from_packed(rand());
+        port_raddr[port].id = rand() % num_port_ids;
+        port_raddr[port].burst_len = kRBurstLenField;
+        port_raddr[port].burst_size = kRBurstSizeField;
+        port_raddr[port].burst_type = BURST_INCR;
+        port_raddr[port].qos = qos;
+        port_raddr_valid[port] = true;
+      }
+
+      if (port_waddr_valid[port]) {
+        tb->requester_waddr[port].apply(port_waddr[port]);
+      } else {
+        tb->requester_waddr[port].stop();
+      }
+      if (port_raddr_valid[port]) {
+        tb->requester_raddr[port].apply(port_raddr[port]);
+      } else {
+        tb->requester_raddr[port].stop();
+      }
+      if (port_wdata_owed[port] > 0) {
+        WriteData wdata;
+        wdata.from_packed(rand());
+        wdata.last = port_wdata_owed[port] == 1;
+        tb->requester_wdata[port].apply(wdata);
+      } else {
+        tb->requester_wdata[port].stop();
+      }
+    }
+
+    if (realmem.has_wrsp()) {
+      tb->realmem_wrsp.apply(realmem.get_next_wrsp());
+    } else {
+      tb->realmem_wrsp.stop();
+    }
+    if (realmem.has_rdata()) {
+      tb->realmem_rdata.apply(realmem.get_next_rdata());
+    } else {
+      tb->realmem_rdata.stop();
+    }
+
+    ////////////////////////
+    // Observe handshakes //
+    ////////////////////////
+
+    tb->simmem_apply_channels();
+
+    for (size_t port = 0; port < kNumPorts; port++) {
+      if (tb->requester_waddr[port].check()) {
+        waddr_times[port][port_waddr[port].id].push(curr_time);
+        port_wdata_owed[port] += port_waddr[port].burst_len + 1;
+        port_waddr_valid[port] = false;
+        stats[port].num_waddr++;
+      }
+      if (tb->requester_raddr[port].check()) {
+        raddr_times[port][port_raddr[port].id].push(curr_time);
+        port_raddr_valid[port] = false;
+        stats[port].num_raddr++;
+      }
+      if (tb->requester_wdata[port].check()) {
+        port_wdata_owed[port]--;
+        stats[port].num_wdata_beats++;
+      }
+
+      WriteResponse wrsp;
+      if (tb->requester_wrsp[port].fetch(wrsp)) {
+        if (waddr_times[port][wrsp.id].empty()) {
+          stats[port].num_misrouted++;
+        } else {
+          size_t latency = curr_time - waddr_times[port][wrsp.id].front();
+          waddr_times[port][wrsp.id].pop();
+          stats[port].num_wrsp++;
+          stats[port].wlatency_sum += latency;
+          stats[port].wlatency_max =
+              std::max(stats[port].wlatency_max, latency);
+        }
+      }
+
+      ReadData rdata;
+      if (tb->requester_rdata[port].fetch(rdata)) {
+        stats[port].num_rdata_beats++;
+        if (rdata.last) {
+          if (raddr_times[port][rdata.id].empty()) {
+            stats[port].num_misrouted++;
+          } else {
+            size_t latency = curr_time - raddr_times[port][rdata.id].front();
+            raddr_times[port][rdata.id].pop();
+            stats[port].num_rbursts++;
+            stats[port].rlatency_sum += latency;
+            stats[port].rlatency_max =
+                std::max(stats[port].rlatency_max, latency);
+          }
+        }
+      }
+    }
+
+    // Real memory controller side.
+    WriteAddress out_waddr;
+    ReadAddress out_raddr;
+    WriteData out_wdata;
+
+    if (tb->realmem_wrsp.check()) {
+      realmem.pop_next_wrsp();
+    }
+    if (tb->realmem_rdata.check()) {
+      realmem.pop_next_rdata();
+    }
+    if (tb->realmem_waddr.fetch(out_waddr)) {
+      realmem.accept_waddr(out_waddr);
+    }
+    if (tb->realmem_raddr.fetch(out_raddr)) {
+      realmem.accept_raddr(out_raddr);
+    }
+    if (tb->realmem_wdata.fetch(out_wdata)) {
+      realmem.accept_wdata();
+    }
+
+    tb->simmem_tick();
+  }
+
+  display_stats(stats, tb->simmem_get_tick_count() - start_time);
+}
+
+int main(int argc, char **argv, char **env) {
+  Verilated::commandArgs(argc, argv);
+  Verilated::traceEverOn(true);
+
+  MultiportTestbench *tb = new MultiportTestbench(true, "multiport_top.fst");
+
+  randomized_testbench(tb, kSeed, kNumRandomTestSteps);
+
+  delete tb;
+
+  std::cout << "Testbench complete!" << std::endl;
+
+  exit(0);
+}
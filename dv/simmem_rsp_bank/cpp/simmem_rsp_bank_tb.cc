@@ -16,6 +16,7 @@
 //    inputs and observe output delays and contents.
 
 #include "Vsimmem_rsp_bank.h"
+#include "simmem_bfm.h"
 #include "verilated.h"
 #include <cassert>
 #include <iostream>
@@ -46,9 +47,14 @@ typedef enum { MANUAL_TEST, RANDOMIZED_TEST } test_strategy_e;
 const test_strategy_e kTestStrategy = RANDOMIZED_TEST;
 
 // Determines the number of independent testbenches are performed in the
-// randomized testbench. Set to 1 to proceed with wave analysis.
+// randomized testbench. Set to 1 to proceed with wave analysis. All the rounds
+// run on the same model instance, which is reset between the rounds.
 const size_t kNumRandomTestRounds = 100;
 
+// Determines whether the waveforms are recorded. As all the rounds share the
+// same trace file, the trace is only recorded for a single round.
+const bool kRecordTrace = kNumRandomTestRounds == 1;
+
 // Determines the number of steps per randomized testbench round.
 const size_t kNumRandomTestSteps = 1000;
 
@@ -59,68 +65,65 @@ const size_t kNumIdentifiers = 2;
 typedef Vsimmem_rsp_bank Module;
 typedef std::map<uint32_t, std::queue<uint32_t>> queue_map_t;
 
+// Valid/ready channels of the design under test.
+SIMMEM_BFM_PORT(RsvPort, rsv_req_id_onehot_i, rsv_valid_i, rsv_ready_o);
+SIMMEM_BFM_PORT(InRspPort, rsp_i, in_rsp_valid_i, in_rsp_ready_o);
+SIMMEM_BFM_PORT(OutRspPort, rsp_o, out_rsp_valid_o, out_rsp_ready_i);
+
 // This class implements elementary interaction with the design under test.
-class RspBankTestbench {
+class RspBankTestbench : public simmem_bfm::SimHarness<Module> {
  public:
   /**
    * @param record_trace set to false to skip trace recording
    */
   RspBankTestbench(bool record_trace = true,
                    const std::string &trace_filename = "sim.fst")
-      : tick_count_(0l), record_trace_(record_trace), module_(new Module) {
-    if (record_trace) {
-      trace_ = new VerilatedFstC;
-      module_->trace(trace_, kTraceLevel);
-      trace_->open(trace_filename.c_str());
-    }
-
+      : simmem_bfm::SimHarness<Module>(record_trace, trace_filename,
+                                       kTraceLevel),
+        reservation_(module_.get()),
+        input_rsp_(module_.get()),
+        output_rsp_(module_.get()) {
     // Puts ones at the fields' places
     id_mask_ = ~((1 << 31) >> (31 - kIdWidth));
     content_mask_ = ~((1 << 31) >> (31 - kRspWidth)) & ~id_mask_;
 
     // The delay bank is supposedly always ready to receive address requests.
     module_->delay_calc_ready_i = 1;
-  }
 
-  ~RspBankTestbench(void) { simmem_close_trace(); }
+    // Must be not larger than MaxBurstLenField
+    module_->rsv_burst_len_i = 2;
+  }
 
+  /**
+   * Releases all the inputs and resets the design, so that a new round can run
+   * on the same model instance.
+   */
   void simmem_reset(void) {
-    module_->rst_ni = 0;
-    this->simmem_tick(kResetLength);
-    module_->rst_ni = 1;
-  }
+    simmem_bfm::stop_all(reservation_, input_rsp_, output_rsp_);
+    module_->release_en_i = 0;
 
-  void simmem_close_trace(void) { trace_->close(); }
+    simmem_apply_channels();
+    pulse_reset(kResetLength);
+  }
 
   /**
-   * Performs one or multiple clock cycles.
+   * Performs one or multiple clock cycles, with the signals of the channels.
    *
    * @param num_ticks the number of ticks to perform at once
    */
   void simmem_tick(int num_ticks = 1) {
-    for (size_t i = 0; i < num_ticks; i++) {
-      tick_count_++;
-
-      module_->clk_i = 0;
-      module_->eval();
-
-      if (record_trace_) {
-        trace_->dump(5 * tick_count_ - 1);
-      }
-      module_->clk_i = 1;
-      module_->eval();
-
-      if (record_trace_) {
-        trace_->dump(5 * tick_count_);
-      }
-      module_->clk_i = 0;
-      module_->eval();
+    simmem_bfm::drive_all(reservation_, input_rsp_, output_rsp_);
+    tick(num_ticks);
+  }
 
-      if (record_trace_) {
-        trace_->dump(5 * tick_count_ + 2);
-        trace_->flush();
-      }
-    }
+  /**
+   * Applies the signals of all the channels for the current cycle and settles
+   * the design, so that all the handshakes can then be checked until the next
+   * clock tick.
+   */
+  void simmem_apply_channels(void) {
+    simmem_bfm::drive_all(reservation_, input_rsp_, output_rsp_);
+    settle();
   }
 
   /**
@@ -130,17 +133,13 @@ class RspBankTestbench {
    * @param axi_id the AXI identifier to reserve
    */
   void simmem_reservation_start(uint32_t axi_id) {
-    module_->rsv_valid_i = 1;
-    module_->rsv_req_id_onehot_i = 1 << axi_id;
-
-    // Must be not larger than MaxBurstLenField
-    module_->rsv_burst_len_i = 2;
+    reservation_.apply(1 << axi_id);
   }
 
   /**
    * Sets the reservation request signal to zero.
    */
-  void simmem_reservation_stop(void) { module_->rsv_valid_i = 0; }
+  void simmem_reservation_stop(void) { reservation_.stop(); }
 
   /**
    * Applies valid input data.
@@ -156,8 +155,7 @@ class RspBankTestbench {
     assert(!(identifier >> kIdWidth));
 
     uint32_t in_rsp = rsp << kIdWidth | identifier;
-    module_->rsp_i = in_rsp;
-    module_->in_rsp_valid_i = 1;
+    input_rsp_.apply(in_rsp);
     return in_rsp;
   }
 
@@ -167,26 +165,21 @@ class RspBankTestbench {
   uint32_t simmem_reservation_get_address(void) { return module_->rsv_iid_o; }
 
   /**
-   * Checks whether the input data has been accepted by checking the ready
-   * output signal.
+   * Checks whether the input data has been accepted. Requires the channels to
+   * have been applied.
    */
-  bool simmem_input_rsp_check(void) {
-    module_->eval();
-    return (bool)(module_->in_rsp_ready_o);
-  }
+  bool simmem_input_rsp_check(void) { return input_rsp_.check(); }
 
   /**
-   * Checks whether the reservation request has been accepted.
+   * Checks whether the reservation request has been accepted. Requires the
+   * channels to have been applied.
    */
-  bool simmem_reservation_check(void) {
-    module_->eval();
-    return (bool)(module_->rsv_ready_o);
-  }
+  bool simmem_reservation_check(void) { return reservation_.check(); }
 
   /**
    * Stops applying data to the DUT instance.
    */
-  void simmem_input_rsp_stop(void) { module_->in_rsp_valid_i = 0; }
+  void simmem_input_rsp_stop(void) { input_rsp_.stop(); }
 
   /**
    * Allows all the data output from a releaser module standpoint.
@@ -201,28 +194,23 @@ class RspBankTestbench {
   /**
    * Sets the ready signal to one on the output side.
    */
-  void simmem_output_rsp_request(void) { module_->out_rsp_ready_i = 1; }
+  void simmem_output_rsp_request(void) { output_rsp_.request(); }
 
   /**
-   * Tries to fetch output data. Requires the ready signal to be one at the DUT
-   * output.
+   * Tries to fetch output data. Requires the channels to have been applied.
    *
    * @param out_rsp the output data from the DUT
    *
-   * @return true iff the data is valid
+   * @return true iff the handshake is successful
    */
   bool simmem_output_rsp_fetch(uint32_t &out_rsp) {
-    module_->eval();
-    assert(module_->out_rsp_ready_i);
-
-    out_rsp = (uint32_t)module_->rsp_o;
-    return (bool)(module_->out_rsp_valid_o);
+    return output_rsp_.fetch(out_rsp);
   }
 
   /**
    * Sets the ready signal to zero on the output side.
    */
-  void simmem_output_rsp_stop(void) { module_->out_rsp_ready_i = 0; }
+  void simmem_output_rsp_stop(void) { output_rsp_.stop(); }
 
   /**
    * Getters.
@@ -231,10 +219,9 @@ class RspBankTestbench {
   uint32_t simmem_get_identifier_mask(void) { return id_mask_; }
 
  private:
-  vluint32_t tick_count_;
-  bool record_trace_;
-  std::unique_ptr<Module> module_;
-  VerilatedFstC *trace_;
+  simmem_bfm::Driver<Module, uint32_t, RsvPort> reservation_;
+  simmem_bfm::Driver<Module, uint32_t, InRspPort> input_rsp_;
+  simmem_bfm::Monitor<Module, uint32_t, OutRspPort> output_rsp_;
 
   // Masks that contain ones in the corresponding fields.
   uint32_t id_mask_;
@@ -364,6 +351,7 @@ size_t randomized_testbench(RspBankTestbench *tb, size_t num_ids,
     }
 
     // Only perform the evaluation once all the inputs have been applied
+    tb->simmem_apply_channels();
     if (reserve && tb->simmem_reservation_check()) {
       if (kTransactionsVerbose) {
         if (!iteration_announced) {
@@ -460,13 +448,14 @@ int main(int argc, char **argv, char **env) {
   // Counts the number of mismatches during the whole test
   size_t total_num_mismatches = 0;
 
+  // Instantiate the DUT instance once for all the rounds, as the model
+  // construction and the trace setup dominate the short rounds.
+  RspBankTestbench *tb = new RspBankTestbench(kRecordTrace, "rsp_bank.fst");
+
   for (unsigned int seed = 0; seed < kNumRandomTestRounds; seed++) {
     // Counts the number of mismatches during the loop iteration
     size_t local_num_mismatches;
 
-    // Instantiate the DUT instance
-    RspBankTestbench *tb = new RspBankTestbench(true, "rsp_bank.fst");
-
     // Perform one test for the given seed
     if (kTestStrategy == MANUAL_TEST) {
       manual_test(tb);
@@ -479,9 +468,12 @@ int main(int argc, char **argv, char **env) {
     total_num_mismatches += local_num_mismatches;
     std::cout << "Mismatches for seed " << std::dec << seed << ": "
               << local_num_mismatches << std::hex << std::endl;
-    delete tb;
   }
 
+  std::cout << "Total mismatches: " << std::dec << total_num_mismatches
+            << std::endl;
+  delete tb;
+
   std::cout << "Testbench complete!" << std::endl;
 
   exit(0);
@@ -2,29 +2,304 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 //
-// This header defines the structures that represent the AXI messages.
+// This header defines the structures that represent the AXI messages. The
+// field offsets and widths are inherited from the layouts generated in
+// simmem_axi_dimensions.h. The messages are packed into arrays of 32-bit words
+// with the layout of the Verilated wide signals, so that they may be wider
+// than 64 bits, for instance with 128- to 512-bit data beats.
 
 #ifndef SIMMEM_DV_AXI_STRUCTURES
 #define SIMMEM_DV_AXI_STRUCTURES
 
 #include "simmem_axi_dimensions.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdint.h>
+#include <type_traits>
+
+/////////////////////////
+// Bit-level accessors //
+/////////////////////////
+
+// Verilator represents signals up to 64 bits as integers, and wider signals as
+// arrays of 32-bit words, the least significant word first (VlWide). The
+// following helpers access bit fields of at most 64 bits in both
+// representations, one word at a time.
+
+/**
+ * Returns a mask of the width least significant bits.
+ *
+ * @param width the mask width (bits), at most 64
+ */
+inline uint64_t low_mask(size_t width) {
+  return width >= 64 ? ~0UL : (1UL << width) - 1;
+}
+
+/**
+ * Gets a bit field from an array of 32-bit words.
+ *
+ * @param words the word array, least significant word first
+ * @param lsb the position of the least significant bit of the field
+ * @param width the width of the field, at most 64
+ *
+ * @return the value of the field
+ */
+inline uint64_t words_get_bits(const uint32_t *words, size_t lsb,
+                               size_t width) {
+  uint64_t ret = 0;
+  for (size_t bit = 0; bit < width;) {
+    size_t shift = (lsb + bit) % 32;
+    size_t chunk = std::min(32 - shift, width - bit);
+    ret |= ((words[(lsb + bit) / 32] >> shift) & low_mask(chunk)) << bit;
+    bit += chunk;
+  }
+  return ret;
+}
+
+/**
+ * Sets a bit field in an array of 32-bit words.
+ *
+ * @param words the word array, least significant word first
+ * @param lsb the position of the least significant bit of the field
+ * @param width the width of the field, at most 64
+ * @param val the value to write
+ */
+inline void words_set_bits(uint32_t *words, size_t lsb, size_t width,
+                           uint64_t val) {
+  for (size_t bit = 0; bit < width;) {
+    size_t shift = (lsb + bit) % 32;
+    size_t chunk = std::min(32 - shift, width - bit);
+    uint32_t mask = (uint32_t)low_mask(chunk) << shift;
+    uint32_t &word = words[(lsb + bit) / 32];
+    word = (word & ~mask) | (((uint32_t)(val >> bit) << shift) & mask);
+    bit += chunk;
+  }
+}
+
+/**
+ * Gets a bit field from a narrow Verilated signal.
+ *
+ * @param sig the signal
+ * @param lsb the position of the least significant bit of the field
+ * @param width the width of the field, at most 64
+ *
+ * @return the value of the field
+ */
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, uint64_t>::type
+port_get_bits(const T &sig, size_t lsb, size_t width) {
+  return ((uint64_t)sig >> lsb) & low_mask(width);
+}
+
+/**
+ * Gets a bit field from a wide Verilated signal.
+ */
+template <typename T>
+inline typename std::enable_if<!std::is_integral<T>::value, uint64_t>::type
+port_get_bits(const T &sig, size_t lsb, size_t width) {
+  return words_get_bits(&sig[0], lsb, width);
+}
+
+/**
+ * Sets a bit field in a narrow Verilated signal.
+ *
+ * @param sig the signal
+ * @param lsb the position of the least significant bit of the field
+ * @param width the width of the field, at most 64
+ * @param val the value to write
+ */
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value>::type port_set_bits(
+    T &sig, size_t lsb, size_t width, uint64_t val) {
+  uint64_t mask = low_mask(width) << lsb;
+  sig = (T)(((uint64_t)sig & ~mask) | ((val << lsb) & mask));
+}
+
+/**
+ * Sets a bit field in a wide Verilated signal.
+ */
+template <typename T>
+inline typename std::enable_if<!std::is_integral<T>::value>::type
+port_set_bits(T &sig, size_t lsb, size_t width, uint64_t val) {
+  words_set_bits(&sig[0], lsb, width, val);
+}
+
+//////////////////////////////////
+// Wide fields and packed types //
+//////////////////////////////////
+
+/**
+ * Field wider than 64 bits, such as the data of wide beats, held as 64-bit
+ * words, the least significant word first. Assigning an integer sets the least
+ * significant word and clears the others.
+ *
+ * @tparam W the field width (bits)
+ */
+template <uint64_t W>
+struct WideField {
+  static constexpr size_t kNumWords = (W + 63) / 64;
+  uint64_t words[kNumWords];
+
+  WideField(uint64_t low = 0) {
+    words[0] = low;
+    std::fill(words + 1, words + kNumWords, 0UL);
+  }
+
+  uint64_t low() const { return words[0]; }
+};
+
+// Representation of a message field: an integer up to 64 bits, and a WideField
+// beyond.
+template <uint64_t W, bool IsWide = (W > 64)>
+struct field_type {
+  typedef uint64_t type;
+};
+template <uint64_t W>
+struct field_type<W, true> {
+  typedef WideField<W> type;
+};
+
+/**
+ * Packed representation of a message, with the word layout of the Verilated
+ * wide signals.
+ *
+ * @tparam W the packed message width (bits)
+ */
+template <uint64_t W>
+struct PackedMsg {
+  static constexpr size_t kNumWords = (W + 31) / 32;
+  uint32_t words[kNumWords];
+
+  PackedMsg() { std::fill(words, words + kNumWords, 0U); }
+
+  /**
+   * @param low the value of the (up to) 64 least significant bits
+   */
+  explicit PackedMsg(uint64_t low) {
+    std::fill(words, words + kNumWords, 0U);
+    set_bits(0, std::min<size_t>(W, 64), low);
+  }
+
+  uint64_t get_bits(size_t lsb, size_t width) const {
+    return words_get_bits(words, lsb, width);
+  }
+  void set_bits(size_t lsb, size_t width, uint64_t val) {
+    words_set_bits(words, lsb, width, val);
+  }
+
+  /**
+   * @return the (up to) 64 least significant bits
+   */
+  uint64_t low() const { return get_bits(0, std::min<size_t>(W, 64)); }
+
+  template <uint64_t FieldW, uint64_t FieldOff>
+  void set_field(uint64_t field) {
+    static_assert(FieldOff + FieldW <= W, "field out of the message");
+    set_bits(FieldOff, FieldW, field);
+  }
+  template <uint64_t FieldW, uint64_t FieldOff>
+  void set_field(const WideField<FieldW> &field) {
+    static_assert(FieldOff + FieldW <= W, "field out of the message");
+    for (size_t i = 0; i < WideField<FieldW>::kNumWords; i++) {
+      set_bits(FieldOff + 64 * i, std::min<size_t>(FieldW - 64 * i, 64),
+               field.words[i]);
+    }
+  }
+
+  template <uint64_t FieldW, uint64_t FieldOff>
+  void get_field(uint64_t &field) const {
+    static_assert(FieldOff + FieldW <= W, "field out of the message");
+    field = get_bits(FieldOff, FieldW);
+  }
+  template <uint64_t FieldW, uint64_t FieldOff>
+  void get_field(WideField<FieldW> &field) const {
+    static_assert(FieldOff + FieldW <= W, "field out of the message");
+    for (size_t i = 0; i < WideField<FieldW>::kNumWords; i++) {
+      field.words[i] =
+          get_bits(FieldOff + 64 * i, std::min<size_t>(FieldW - 64 * i, 64));
+    }
+  }
+
+  /**
+   * Writes the packed message to a Verilated signal.
+   *
+   * @param sig the signal, narrow or wide
+   * @param lsb the position of the message in the signal, for instance when
+   *        the signal concatenates the messages of several ports
+   */
+  template <typename T>
+  void to_port(T &sig, size_t lsb = 0) const {
+    for (size_t bit = 0; bit < W; bit += 64) {
+      size_t width = std::min<size_t>(W - bit, 64);
+      port_set_bits(sig, lsb + bit, width, get_bits(bit, width));
+    }
+  }
+
+  /**
+   * Reads the packed message from a Verilated signal.
+   *
+   * @param sig the signal, narrow or wide
+   * @param lsb the position of the message in the signal
+   */
+  template <typename T>
+  void from_port(const T &sig, size_t lsb = 0) {
+    for (size_t bit = 0; bit < W; bit += 64) {
+      size_t width = std::min<size_t>(W - bit, 64);
+      set_bits(bit, width, port_get_bits(sig, lsb + bit, width));
+    }
+  }
+};
+
+/**
+ * Displays a packed message in hexadecimal, the most significant word first.
+ */
+template <uint64_t W>
+std::ostream &operator<<(std::ostream &os, const PackedMsg<W> &msg) {
+  std::ios_base::fmtflags flags = os.flags();
+  char fill = os.fill();
+
+  os << std::hex << msg.words[PackedMsg<W>::kNumWords - 1];
+  for (size_t i = PackedMsg<W>::kNumWords - 1; i-- > 0;) {
+    os << std::setw(8) << std::setfill('0') << msg.words[i];
+  }
+  os.flags(flags);
+  os.fill(fill);
+  return os;
+}
+
+/**
+ * Writes a message to a Verilated signal.
+ *
+ * @param msg the message
+ * @param sig the signal, narrow or wide
+ * @param lsb the position of the message in the signal
+ */
+template <typename Msg, typename T>
+inline void msg_to_port(const Msg &msg, T &sig, size_t lsb = 0) {
+  msg.to_packed().to_port(sig, lsb);
+}
+
+/**
+ * Reads a message from a Verilated signal.
+ *
+ * @param msg the message, modified in place
+ * @param sig the signal, narrow or wide
+ * @param lsb the position of the message in the signal
+ */
+template <typename Msg, typename T>
+inline void msg_from_port(Msg &msg, const T &sig, size_t lsb = 0) {
+  typename Msg::packed_t packed;
+  packed.from_port(sig, lsb);
+  msg.from_packed(packed);
+}
 
 ///////////////////////////
 // Write address request //
 ///////////////////////////
 
-struct WriteAddress {
-  // Shift offsets and widths in the packed representation
-  static const uint64_t id_off, id_w;
-  static const uint64_t addr_off, addr_w;
-  static const uint64_t burst_len_off, burst_len_w;
-  static const uint64_t burst_size_off, burst_size_w;
-  static const uint64_t burst_type_off, burst_type_w;
-  static const uint64_t lock_type_off, lock_type_w;
-  static const uint64_t mem_type_off, mem_type_w;
-  static const uint64_t prot_off, prot_w;
-  static const uint64_t qos_off, qos_w;
-  static const uint64_t region_off, region_w;
+struct WriteAddress : WriteAddressLayout {
+  typedef PackedMsg<packed_w> packed_t;
 
   uint64_t id;
   uint64_t addr;
@@ -37,44 +312,73 @@ struct WriteAddress {
   uint64_t qos;
   uint64_t region;
 
-  uint64_t to_packed();
-  void from_packed(uint64_t packed_val);
+  packed_t to_packed() const {
+    packed_t packed;
+
+    packed.set_field<id_w, id_off>(id);
+    packed.set_field<addr_w, addr_off>(addr);
+    packed.set_field<burst_len_w, burst_len_off>(burst_len);
+    packed.set_field<burst_size_w, burst_size_off>(burst_size);
+    packed.set_field<burst_type_w, burst_type_off>(burst_type);
+    packed.set_field<lock_type_w, lock_type_off>(lock_type);
+    packed.set_field<mem_type_w, mem_type_off>(mem_type);
+    packed.set_field<prot_w, prot_off>(prot);
+    packed.set_field<qos_w, qos_off>(qos);
+    packed.set_field<region_w, region_off>(region);
+
+    return packed;
+  }
+
+  void from_packed(uint64_t low) { from_packed(packed_t(low)); }
+  void from_packed(const packed_t &packed) {
+    packed.get_field<id_w, id_off>(id);
+    packed.get_field<addr_w, addr_off>(addr);
+    packed.get_field<burst_len_w, burst_len_off>(burst_len);
+    packed.get_field<burst_size_w, burst_size_off>(burst_size);
+    packed.get_field<burst_type_w, burst_type_off>(burst_type);
+    packed.get_field<lock_type_w, lock_type_off>(lock_type);
+    packed.get_field<mem_type_w, mem_type_off>(mem_type);
+    packed.get_field<prot_w, prot_off>(prot);
+    packed.get_field<qos_w, qos_off>(qos);
+    packed.get_field<region_w, region_off>(region);
+  }
 };
 
 ////////////////
 // Write data //
 ////////////////
 
-struct WriteData {
-  // Shift offsets and widths in the packed representation
-  static const uint64_t data_off, data_w;
-  static const uint64_t strb_off, strb_w;
-  static const uint64_t last_off, last_w;
+struct WriteData : WriteDataLayout {
+  typedef PackedMsg<packed_w> packed_t;
 
-  uint64_t data;
+  field_type<data_w>::type data;
   uint64_t strb;
   uint64_t last;
 
-  uint64_t to_packed();
-  void from_packed(uint64_t packed_val);
+  packed_t to_packed() const {
+    packed_t packed;
+
+    packed.set_field<data_w, data_off>(data);
+    packed.set_field<strb_w, strb_off>(strb);
+    packed.set_field<last_w, last_off>(last);
+
+    return packed;
+  }
+
+  void from_packed(uint64_t low) { from_packed(packed_t(low)); }
+  void from_packed(const packed_t &packed) {
+    packed.get_field<data_w, data_off>(data);
+    packed.get_field<strb_w, strb_off>(strb);
+    packed.get_field<last_w, last_off>(last);
+  }
 };
 
 //////////////////////////
 // Read address request //
 //////////////////////////
 
-struct ReadAddress {
-  // Shift offsets and widths in the packed representation
-  static const uint64_t id_off, id_w;
-  static const uint64_t addr_off, addr_w;
-  static const uint64_t burst_len_off, burst_len_w;
-  static const uint64_t burst_size_off, burst_size_w;
-  static const uint64_t burst_type_off, burst_type_w;
-  static const uint64_t lock_type_off, lock_type_w;
-  static const uint64_t mem_type_off, mem_type_w;
-  static const uint64_t prot_off, prot_w;
-  static const uint64_t qos_off, qos_w;
-  static const uint64_t region_off, region_w;
+struct ReadAddress : ReadAddressLayout {
+  typedef PackedMsg<packed_w> packed_t;
 
   uint64_t id;
   uint64_t addr;
@@ -87,44 +391,94 @@ struct ReadAddress {
   uint64_t qos;
   uint64_t region;
 
-  uint64_t to_packed();
-  void from_packed(uint64_t packed_val);
+  packed_t to_packed() const {
+    packed_t packed;
+
+    packed.set_field<id_w, id_off>(id);
+    packed.set_field<addr_w, addr_off>(addr);
+    packed.set_field<burst_len_w, burst_len_off>(burst_len);
+    packed.set_field<burst_size_w, burst_size_off>(burst_size);
+    packed.set_field<burst_type_w, burst_type_off>(burst_type);
+    packed.set_field<lock_type_w, lock_type_off>(lock_type);
+    packed.set_field<mem_type_w, mem_type_off>(mem_type);
+    packed.set_field<prot_w, prot_off>(prot);
+    packed.set_field<qos_w, qos_off>(qos);
+    packed.set_field<region_w, region_off>(region);
+
+    return packed;
+  }
+
+  void from_packed(uint64_t low) { from_packed(packed_t(low)); }
+  void from_packed(const packed_t &packed) {
+    packed.get_field<id_w, id_off>(id);
+    packed.get_field<addr_w, addr_off>(addr);
+    packed.get_field<burst_len_w, burst_len_off>(burst_len);
+    packed.get_field<burst_size_w, burst_size_off>(burst_size);
+    packed.get_field<burst_type_w, burst_type_off>(burst_type);
+    packed.get_field<lock_type_w, lock_type_off>(lock_type);
+    packed.get_field<mem_type_w, mem_type_off>(mem_type);
+    packed.get_field<prot_w, prot_off>(prot);
+    packed.get_field<qos_w, qos_off>(qos);
+    packed.get_field<region_w, region_off>(region);
+  }
 };
 
-////////////////
+///////////////
 // Read data //
-////////////////
+///////////////
 
-struct ReadData {
-  // Shift offsets and widths in the packed representation
-  static const uint64_t id_off, id_w;
-  static const uint64_t data_off, data_w;
-  static const uint64_t rsp_off, rsp_w;
-  static const uint64_t last_off, last_w;
+struct ReadData : ReadDataLayout {
+  typedef PackedMsg<packed_w> packed_t;
 
   uint64_t id;
-  uint64_t data;
+  field_type<data_w>::type data;
   uint64_t rsp;
   uint64_t last;
 
-  uint64_t to_packed();
-  void from_packed(uint64_t packed_val);
+  packed_t to_packed() const {
+    packed_t packed;
+
+    packed.set_field<id_w, id_off>(id);
+    packed.set_field<data_w, data_off>(data);
+    packed.set_field<rsp_w, rsp_off>(rsp);
+    packed.set_field<last_w, last_off>(last);
+
+    return packed;
+  }
+
+  void from_packed(uint64_t low) { from_packed(packed_t(low)); }
+  void from_packed(const packed_t &packed) {
+    packed.get_field<id_w, id_off>(id);
+    packed.get_field<data_w, data_off>(data);
+    packed.get_field<rsp_w, rsp_off>(rsp);
+    packed.get_field<last_w, last_off>(last);
+  }
 };
 
 ////////////////////
 // Write response //
 ////////////////////
 
-struct WriteResponse {
-  // Shift offsets and widths in the packed representation
-  static const uint64_t id_off, id_w;
-  static const uint64_t rsp_off, rsp_w;
+struct WriteResponse : WriteResponseLayout {
+  typedef PackedMsg<packed_w> packed_t;
 
   uint64_t id;
   uint64_t rsp;
 
-  uint64_t to_packed();
-  void from_packed(uint64_t packed_val);
+  packed_t to_packed() const {
+    packed_t packed;
+
+    packed.set_field<id_w, id_off>(id);
+    packed.set_field<rsp_w, rsp_off>(rsp);
+
+    return packed;
+  }
+
+  void from_packed(uint64_t low) { from_packed(packed_t(low)); }
+  void from_packed(const packed_t &packed) {
+    packed.get_field<id_w, id_off>(id);
+    packed.get_field<rsp_w, rsp_off>(rsp);
+  }
 };
 
 #endif  // SIMMEM_DV_AXI_STRUCTURES
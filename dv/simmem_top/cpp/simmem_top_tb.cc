@@ -14,19 +14,46 @@
 //  requests.
 //  * Definition of a manual and a randomized testbench. The randomized
 //  testbench randomly applies inputs and observes output delays and contents.
-
+//
+// The instruments of the randomized testbench are defined in dv/common/cpp:
+// the latency attribution (simmem_latency.h), the occupancy sampling
+// (simmem_occupancy.h), the liveness watchdog (simmem_watchdog.h), the
+// stimulus decoding (simmem_stimulus.h), the worst-case search
+// (simmem_search.h) and the checkpoint serialization (simmem_checkpoint.h).
+
+#ifdef SIMMEM_MULTICHANNEL
+#include "Vsimmem_multichannel_top.h"
+#include "Vsimmem_multichannel_top_simmem_pkg.h"
+#else
 #include "Vsimmem_top.h"
+#include "Vsimmem_top_simmem_pkg.h"
+#endif  // SIMMEM_MULTICHANNEL
 #include "simmem_axi_structures.h"
+#include "simmem_bfm.h"
+#include "simmem_checkpoint.h"
+#include "simmem_dims_check.h"
+#include "simmem_latency.h"
+#include "simmem_occupancy.h"
+#include "simmem_prof.h"
+#include "simmem_search.h"
+#include "simmem_stimulus.h"
+#include "simmem_watchdog.h"
 #include "verilated.h"
+#include <algorithm>
 #include <cassert>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <queue>
+#include <random>
+#include <sstream>
 #include <stdlib.h>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include <verilated_fst_c.h>
+#include <verilated_save.h>
 
 // Choose whether to display all the transactions
 const bool kTransactionVerbose = true;
@@ -36,9 +63,10 @@ const int kResetLength = 5;  // Cycles
 // Depth of the trace.
 const int kTraceLevel = 6;
 
-// Constant burst lengths supplied to the DUT
-const int kWBurstLenField = 3;
-const int kRBurstLenField = 2;
+// Constant burst lengths supplied to the DUT, clipped to the maximal burst
+// length field of the configuration
+const int kWBurstLenField = MaxBurstLenField < 3 ? MaxBurstLenField : 3;
+const int kRBurstLenField = MaxBurstLenField < 2 ? MaxBurstLenField : 2;
 
 // Constant burst sizes supplied to the DUT
 const int kWBurstSizeField = 2;
@@ -58,6 +86,68 @@ const unsigned int kSeed = 2;
 // Determines the number of steps per randomized testbench.
 const size_t kNumRandomTestSteps = 1000;
 
+// Probabilities, in percent, that the requester applies a new write address,
+// read address or write data in a given cycle of the randomized testbench.
+const unsigned int kWAddrProb = 50;
+const unsigned int kRAddrProb = 50;
+const unsigned int kWDataProb = 50;
+
+// Address patterns of the requests of the randomized testbench:
+//  * random: the addresses are drawn randomly.
+//  * sequential: the write and the read addresses are two streams of
+//  consecutive bursts, starting at the beginning and the middle of the memory.
+//  * row_conflict: consecutive requests of both channels target different rows
+//  of the same rank.
+typedef enum {
+  ADDR_PATTERN_RANDOM,
+  ADDR_PATTERN_SEQUENTIAL,
+  ADDR_PATTERN_ROW_CONFLICT,
+  NUM_ADDR_PATTERNS
+} addr_pattern_e;
+const char *const kAddrPatternNames[NUM_ADDR_PATTERNS] = {
+    "random", "sequential", "row_conflict"};
+
+// Options of a randomized testbench run. They default to the constants above,
+// and may be overridden at runtime by the following plusargs (see the
+// documentation):
+//  +seed=<n> +cycles=<n> +ids=<n> +waddr_prob=<n> +raddr_prob=<n>
+//  +wdata_prob=<n> +quiet (no transaction display) +notrace (no trace file)
+//  +warmup=<n> +save=<path> +restore=<path> +reseed (checkpoints)
+//  +episodes=<n> +brief +legacy_clocking +occupancy=<n> +occupancy_csv=<path>
+//  +replay=<path> +fuzz=<n> +fuzz_len=<n> +fuzz_objective=<name>
+//  +fuzz_out=<path> +watchdog=<n> +nowatchdog +addr_pattern=<name>
+//  (see main).
+struct RandomizedTestOptions {
+  size_t num_ids = kNumIdentifiers;
+  unsigned int seed = kSeed;
+  // Number of cycles of the measurement window.
+  size_t num_cycles = kNumRandomTestSteps;
+  // Number of cycles before the measurement window.
+  size_t warmup_cycles = 0;
+  unsigned int waddr_prob = kWAddrProb;
+  unsigned int raddr_prob = kRAddrProb;
+  unsigned int wdata_prob = kWDataProb;
+  addr_pattern_e addr_pattern = ADDR_PATTERN_RANDOM;
+  bool verbose = kTransactionVerbose;
+  // If false, skips the display of the delay of each transaction.
+  bool display_delays = true;
+  // If set, saves a checkpoint at the end of the warm-up and stops the run.
+  std::string save_path;
+  // If set, starts the measurement window from a checkpoint instead of reset.
+  std::string restore_path;
+  // If set, re-seeds the stimulus with the seed after restoring a checkpoint.
+  bool reseed = false;
+  // If not null, the requester stimulus is decoded from these bytes (see
+  // StimulusDecoder) instead of being drawn randomly.
+  const std::vector<uint8_t> *stimulus = nullptr;
+  // If false, the run displays nothing and only returns its statistics.
+  bool report = true;
+  // If set, the run stops when a transaction exceeds the watchdog bound, in
+  // cycles, or the default bound if zero (see LivenessWatchdog).
+  bool watchdog = true;
+  size_t watchdog_bound = 0;
+};
+
 // Detemine whether the requester and the real memory controller are always
 // ready to accept the outputs from the design under test. If not, the
 // corresponding ready signals are independent Bernoulli signals of probability
@@ -65,7 +155,27 @@ const size_t kNumRandomTestSteps = 1000;
 const bool kRequesterAlwaysReady = true;
 const bool kRealmemAlwaysReady = true;
 
+// Number of cycles between the release enable of a response and its output,
+// which simmem_delay_slots subtracts from the request latency (RspLatency).
+const size_t kSlotRspLatency = 3;
+
+// Energy weights used to estimate the DRAM energy from the performance
+// counters. The command energies are given per command, and the background
+// energies per rank and per clock cycle.
+const double kActEnergyPj = 1000.;
+const double kPreEnergyPj = 600.;
+const double kRdCasEnergyPj = 800.;
+const double kWrCasEnergyPj = 850.;
+const double kActStbyEnergyPj = 40.;
+const double kPreStbyEnergyPj = 30.;
+
+#ifdef SIMMEM_MULTICHANNEL
+typedef Vsimmem_multichannel_top Module;
+typedef Vsimmem_multichannel_top_simmem_pkg ModulePkg;
+#else
 typedef Vsimmem_top Module;
+typedef Vsimmem_top_simmem_pkg ModulePkg;
+#endif  // SIMMEM_MULTICHANNEL
 
 typedef std::map<uint64_t, std::queue<WriteResponse>> wrsp_queue_map_t;
 typedef std::map<uint64_t, u_int64_t> wids_cnt_t;
@@ -85,326 +195,354 @@ typedef std::map<uint64_t, std::queue<std::pair<size_t, WriteResponse>>>
 typedef std::map<uint64_t, std::queue<std::pair<size_t, ReadData>>>
     rdata_time_queue_map_t;
 
-// This class implements elementary interaction with the design under test.
-class SimmemTestbench {
- public:
-  /**
-   * @param record_trace set to false to skip trace recording
-   */
-  SimmemTestbench(bool record_trace = true,
-                  const std::string &trace_filename = "sim.fst")
-      : tick_count_(0l), record_trace_(record_trace), module_(new Module) {
-    if (record_trace) {
-      trace_ = new VerilatedFstC;
-      module_->trace(trace_, kTraceLevel);
-      trace_->open(trace_filename.c_str());
-    }
-
-    wrsp_mask_ =
-        ~((1L << 63) >> (64 - WriteResponse::id_w - WriteResponse::rsp_w));
+struct RandomizedTestState;
+
+// Statistics of one randomized testbench run (episode), restricted to the
+// transactions of the measurement window.
+struct EpisodeStats {
+  size_t num_wrsp = 0;
+  size_t wrsp_delay_sum = 0;
+  size_t wrsp_delay_max = 0;
+  size_t num_rdata = 0;
+  size_t rdata_delay_sum = 0;
+  size_t rdata_delay_max = 0;
+  size_t num_wrsp_mismatches = 0;
+  size_t num_rdata_mismatches = 0;
+  // Bytes delivered to the requester, and cycles where at least one
+  // transaction is outstanding.
+  size_t delivered_bytes = 0;
+  size_t busy_cycles = 0;
+  size_t num_watchdog_violations = 0;
+  // Transactions which do not meet the fixed latency, with the fixed-latency
+  // delay engine.
+  size_t num_fixed_lat_mismatches = 0;
+
+  void add(const EpisodeStats &other) {
+    num_wrsp += other.num_wrsp;
+    wrsp_delay_sum += other.wrsp_delay_sum;
+    wrsp_delay_max = std::max(wrsp_delay_max, other.wrsp_delay_max);
+    num_rdata += other.num_rdata;
+    rdata_delay_sum += other.rdata_delay_sum;
+    rdata_delay_max = std::max(rdata_delay_max, other.rdata_delay_max);
+    num_wrsp_mismatches += other.num_wrsp_mismatches;
+    num_rdata_mismatches += other.num_rdata_mismatches;
+    delivered_bytes += other.delivered_bytes;
+    busy_cycles += other.busy_cycles;
+    num_watchdog_violations += other.num_watchdog_violations;
+    num_fixed_lat_mismatches += other.num_fixed_lat_mismatches;
   }
 
-  ~SimmemTestbench() { simmem_close_trace(); }
-
-  void simmem_reset(void) {
-    module_->rst_ni = 0;
-    this->simmem_tick(kResetLength);
-    module_->rst_ni = 1;
+  size_t num_mismatches(void) const {
+    return num_wrsp_mismatches + num_rdata_mismatches;
   }
 
-  void simmem_close_trace(void) { trace_->close(); }
-
   /**
-   * Performs one or multiple clock cycles.
+   * Displays the statistics on a single line.
    *
-   * @param num_ticks the number of ticks to perform at once
+   * @param name the name of the line, for instance the episode
    */
-  void simmem_tick(int num_ticks = 1) {
-    for (size_t i = 0; i < num_ticks; i++) {
-      tick_count_++;
-
-      module_->clk_i = 0;
-      module_->eval();
-
-      if (record_trace_) {
-        trace_->dump(5 * tick_count_ - 1);
-      }
-      module_->clk_i = 1;
-      module_->eval();
-
-      if (record_trace_) {
-        trace_->dump(5 * tick_count_);
-      }
-      module_->clk_i = 0;
-      module_->eval();
-
-      if (record_trace_) {
-        trace_->dump(5 * tick_count_ + 2);
-        trace_->flush();
-      }
-    }
-  }
-
-  /**
-   * Applies a valid input address request as the requester.
-   *
-   * @param waddr_req the input address request
-   */
-  void simmem_requester_waddr_apply(WriteAddress waddr_req) {
-    module_->waddr_i = waddr_req.to_packed();
-    module_->waddr_in_valid_i = 1;
-  }
-
-  /**
-   * Checks whether the input request has been accepted.
-   */
-  bool simmem_requester_waddr_check() {
-    module_->eval();
-    return (bool)(module_->waddr_in_ready_o);
+  void display(const std::string &name) const {
+    std::cout << name << std::dec << ": write responses: " << num_wrsp
+              << " (mean delay: "
+              << (num_wrsp ? (double)wrsp_delay_sum / num_wrsp : 0.)
+              << ", max: " << wrsp_delay_max << "), read data: " << num_rdata
+              << " (mean delay: "
+              << (num_rdata ? (double)rdata_delay_sum / num_rdata : 0.)
+              << ", max: " << rdata_delay_max
+              << "), mismatches: " << num_wrsp_mismatches << " / "
+              << num_rdata_mismatches
+              << ", watchdog violations: " << num_watchdog_violations
+              << std::endl;
   }
+};
 
-  /**
-   * Stops applying a valid input write address request as the requester.
-   */
-  void simmem_requester_waddr_stop(void) { module_->waddr_in_valid_i = 0; }
+// The debug port of simmem_top carries the internal identifiers as multi-hot
+// signals, read as 64-bit integers.
+static_assert(WRspBankCapa <= 64 && RDataBankCapa <= 64,
+              "The latency attribution supports up to 64 bank entries.");
+
+// Events of the debug port of simmem_top in the current cycle (see
+// SimmemTestbench::simmem_get_debug_events).
+struct DebugEvents {
+  // Internal identifiers reserved for the incoming address requests.
+  uint64_t wrsv_iid = 0;
+  uint64_t rrsv_iid = 0;
+  // Bursts that start being served by the delay calculator.
+  uint64_t wrsp_issued_mhot = 0;
+  uint64_t rdata_issued_mhot = 0;
+  // Bursts that complete in the delay calculator.
+  uint64_t wrsp_done_mhot = 0;
+  uint64_t rdata_done_mhot = 0;
+};
 
+// Valid/ready channels of the design under test.
+SIMMEM_BFM_PORT(WAddrInPort, waddr_i, waddr_in_valid_i, waddr_in_ready_o);
+SIMMEM_BFM_PORT(WDataInPort, wdata_i, wdata_in_valid_i, wdata_in_ready_o);
+SIMMEM_BFM_PORT(RAddrInPort, raddr_i, raddr_in_valid_i, raddr_in_ready_o);
+SIMMEM_BFM_PORT(WRspOutPort, wrsp_o, wrsp_out_valid_o, wrsp_out_ready_i);
+SIMMEM_BFM_PORT(RDataOutPort, rdata_o, rdata_out_valid_o, rdata_out_ready_i);
+SIMMEM_BFM_PORT(WRspInPort, wrsp_i, wrsp_in_valid_i, wrsp_in_ready_o);
+SIMMEM_BFM_PORT(RDataInPort, rdata_i, rdata_in_valid_i, rdata_in_ready_o);
+SIMMEM_BFM_PORT(WAddrOutPort, waddr_o, waddr_out_valid_o, waddr_out_ready_i);
+SIMMEM_BFM_PORT(WDataOutPort, wdata_o, wdata_out_valid_o, wdata_out_ready_i);
+SIMMEM_BFM_PORT(RAddrOutPort, raddr_o, raddr_out_valid_o, raddr_out_ready_i);
+
+// This class implements elementary interaction with the design under test. The
+// requester and the real memory controller interact with the design through
+// the public channel members (see simmem_bfm.h): the signals of all the
+// channels are applied at once by simmem_apply_channels, which is also called
+// at each clock tick.
+class SimmemTestbench : public simmem_bfm::SimHarness<Module> {
+ public:
   /**
-   * Applies a valid input data request as the requester.
-   *
-   * @param wdata_req the input address request
+   * @param record_trace set to false to skip trace recording
    */
-  void simmem_requester_wdata_apply(WriteData wdata_req) {
-    module_->wdata_i = wdata_req.to_packed();
-    module_->wdata_in_valid_i = 1;
+  SimmemTestbench(bool record_trace = true,
+                  const std::string &trace_filename = "sim.fst")
+      : simmem_bfm::SimHarness<Module>(record_trace, trace_filename,
+                                       kTraceLevel),
+        requester_waddr(module_.get()),
+        requester_wdata(module_.get()),
+        requester_raddr(module_.get()),
+        requester_wrsp(module_.get()),
+        requester_rdata(module_.get()),
+        realmem_wrsp(module_.get()),
+        realmem_rdata(module_.get()),
+        realmem_waddr(module_.get()),
+        realmem_wdata(module_.get()),
+        realmem_raddr(module_.get()) {
+    // The messages would be packed with wrong field widths.
+    if (!simmem_dims::matches_model<ModulePkg>()) {
+      std::cerr << "Regenerate simmem_axi_dimensions.h with the overrides of "
+                   "the model (see SIMMEM_DEFINES)."
+                << std::endl;
+      exit(1);
+    }
+    wrsp_mask_ =
+        ~((1L << 63) >> (64 - WriteResponse::id_w - WriteResponse::rsp_w));
   }
 
   /**
-   * Checks whether the input request has been accepted.
+   * Releases all the inputs and resets the design, so that a new episode can
+   * run on the same model instance.
    */
-  bool simmem_requester_wdata_check() {
-    module_->eval();
+  void simmem_reset(void) {
+    simmem_stop_channels();
+    module_->cfg_valid_i = 0;
+    simmem_apply_channels();
 
-    return (bool)(module_->wdata_in_ready_o);
+    pulse_reset(kResetLength);
   }
 
   /**
-   * Stops applying a valid input write address request as the requester.
-   */
-  void simmem_requester_wdata_stop(void) { module_->wdata_in_valid_i = 0; }
-
-  /**
-   * Applies a valid input address request as the requester.
+   * Performs one or multiple clock cycles, with the signals of the channels.
    *
-   * @param raddr_req the input address request
+   * @param num_ticks the number of ticks to perform at once
    */
-  void simmem_requester_raddr_apply(ReadAddress raddr_req) {
-    module_->raddr_i = raddr_req.to_packed();
-    module_->raddr_in_valid_i = 1;
+  void simmem_tick(int num_ticks = 1) {
+    drive_channels();
+    tick(num_ticks);
   }
 
   /**
-   * Checks whether the input request has been accepted.
+   * Applies the signals of all the channels for the current cycle and settles
+   * the design, so that all the handshakes can then be checked until the next
+   * clock tick.
    */
-  bool simmem_requester_raddr_check() {
-    module_->eval();
-    return (bool)(module_->raddr_in_ready_o);
+  void simmem_apply_channels(void) {
+    drive_channels();
+    settle();
   }
 
   /**
-   * Stops applying a valid input read address request as the requester.
-   */
-  void simmem_requester_raddr_stop(void) { module_->raddr_in_valid_i = 0; }
-
-  /**
-   * Sets the ready signal to one on the DUT output side for the write response.
-   */
-  void simmem_requester_wrsp_request(void) { module_->wrsp_out_ready_i = 1; }
-
-  /**
-   * Fetches a write response as the requester. Requires the ready signal to be
-   * one at the DUT output.
-   *
-   * @param out_data the output write response from the DUT
-   *
-   * @return true iff the data is valid
+   * Stops all the channels: no valid payload and no ready signal.
    */
-  bool simmem_requester_wrsp_fetch(WriteResponse &out_data) {
-    module_->eval();
-    assert(module_->wrsp_out_ready_i);
-
-    out_data.from_packed(module_->wrsp_o);
-    return (bool)(module_->wrsp_out_valid_o);
+  void simmem_stop_channels(void) {
+    simmem_bfm::stop_all(requester_waddr, requester_wdata, requester_raddr,
+                         requester_wrsp, requester_rdata, realmem_wrsp,
+                         realmem_rdata, realmem_waddr, realmem_wdata,
+                         realmem_raddr);
   }
 
   /**
-   * Sets the ready signal to zero on the DUT output side for the write
-   * response.
-   */
-  void simmem_requester_wrsp_stop(void) { module_->wrsp_out_ready_i = 0; }
-
-  /**
-   * Sets the ready signal to one on the DUT output side for the read data.
-   */
-  void simmem_requester_rdata_request(void) { module_->rdata_out_ready_i = 1; }
-
-  /**
-   * Fetches a read data as the requester. Requires the ready signal to be one
-   * at the DUT output.
+   * Saves a checkpoint: the model state, which requires a model built with
+   * --savable, and the testbench-side state.
    *
-   * @param out_data the output read data from the DUT
-   *
-   * @return true iff the data is valid
-   */
-  bool simmem_requester_rdata_fetch(ReadData &out_data) {
-    module_->eval();
-    assert(module_->rdata_out_ready_i);
-
-    out_data.from_packed(module_->rdata_o);
-    return (bool)(module_->rdata_out_valid_o);
-  }
-
-  /**
-   * Sets the ready signal to zero on the DUT output side for the write
-   * response.
+   * @param path the checkpoint file
+   * @param state the testbench-side state of the randomized testbench
    */
-  void simmem_requester_rdata_stop(void) { module_->rdata_out_ready_i = 0; }
+  void save(const std::string &path, const RandomizedTestState &state);
 
   /**
-   * Applies a valid write response the real memory controller.
+   * Restores a checkpoint saved by the same binary.
    *
-   * @param wrsp the input write response
-   */
-  void simmem_realmem_wrsp_apply(WriteResponse wrsp) {
-    module_->wrsp_i = wrsp.to_packed();
-
-    module_->wrsp_in_valid_i = 1;
-  }
-
-  /**
-   * Checks whether the input request has been accepted.
-   */
-  bool simmem_realmem_wrsp_check() {
-    module_->eval();
-    return (bool)(module_->wrsp_in_ready_o);
-  }
-
-  /**
-   * Stops applying a valid input write response as the real memory controller.
+   * @param path the checkpoint file
+   * @param state the testbench-side state of the randomized testbench
    */
-  void simmem_realmem_wrsp_stop(void) { module_->wrsp_in_valid_i = 0; }
+  void restore(const std::string &path, RandomizedTestState &state);
 
   /**
-   * Applies a valid read data the real memory controller.
+   * Writes a configuration register of the delay calculator, in one clock
+   * cycle.
    *
-   * @param rdata the input read data
+   * @param addr the register address, as given by the register map in
+   * simmem_pkg
+   * @param data the value to write
    */
-  void simmem_realmem_rdata_apply(ReadData rdata) {
-    module_->rdata_i = rdata.to_packed();
-
-    module_->rdata_in_valid_i = 1;
+  void simmem_cfg_write(uint32_t addr, uint32_t data) {
+    module_->cfg_addr_i = addr;
+    module_->cfg_wdata_i = data;
+    module_->cfg_valid_i = 1;
+    simmem_tick();
+    module_->cfg_valid_i = 0;
   }
 
   /**
-   * Checks whether the input request has been accepted.
-   */
-  bool simmem_realmem_rdata_check() {
-    module_->eval();
-    return (bool)(module_->rdata_in_ready_o);
-  }
-
-  /**
-   * Stops applying a valid input read data as the real memory controller.
-   */
-  void simmem_realmem_rdata_stop(void) { module_->rdata_in_valid_i = 0; }
-
-  /**
-   * Sets the ready signal to one on the DUT output side for the write address.
+   * Mask getter.
    */
-  void simmem_realmem_waddr_request(void) { module_->waddr_out_ready_i = 1; }
+  uint32_t simmem_get_wrsp_mask(void) { return wrsp_mask_; }
 
   /**
-   * Fetches a write address as the real memory controller. Requires the ready
-   * signal to be one at the DUT output.
-   *
-   * @param out_data the output write address request from the DUT
-   *
-   * @return true iff the data is valid
+   * Reads the debug port of the design. Requires the design to be settled (see
+   * simmem_apply_channels). The multi-channel design has no debug port, and
+   * reports no event.
    */
-  bool simmem_realmem_waddr_fetch(WriteAddress &out_data) {
-    module_->eval();
-    assert(module_->waddr_out_ready_i);
-
-    out_data.from_packed(module_->waddr_o);
-    return (bool)(module_->waddr_out_valid_o);
+  DebugEvents simmem_get_debug_events(void) const {
+    DebugEvents events;
+#ifndef SIMMEM_MULTICHANNEL
+    events.wrsv_iid = module_->dbg_wrsv_iid_o;
+    events.rrsv_iid = module_->dbg_rrsv_iid_o;
+    events.wrsp_issued_mhot = module_->dbg_wrsp_issued_mhot_o;
+    events.rdata_issued_mhot = module_->dbg_rdata_issued_mhot_o;
+    events.wrsp_done_mhot = module_->dbg_wrsp_done_mhot_o;
+    events.rdata_done_mhot = module_->dbg_rdata_done_mhot_o;
+#endif  // SIMMEM_MULTICHANNEL
+    return events;
   }
 
   /**
-   * Sets the ready signal to zero on the DUT output side for the write address.
-   */
-  void simmem_realmem_waddr_stop(void) { module_->waddr_out_ready_i = 0; }
-
-  /**
-   * Sets the ready signal to one on the DUT output side for the write data.
+   * Reads the occupancy of the design from its debug port. Requires the design
+   * to be settled. The multi-channel design has no debug port, and reports an
+   * empty occupancy.
    */
-  void simmem_realmem_wdata_request(void) { module_->wdata_out_ready_i = 1; }
+  simmem_occ::Occupancy simmem_get_occupancy(void) const {
+    simmem_occ::Occupancy occ;
+#ifndef SIMMEM_MULTICHANNEL
+    occ.valid = true;
+    for (size_t i = 0; i < NumWSlots; i++) {
+      occ.wslots += (module_->dbg_wslt_v_mhot_o >> i) & 1;
+    }
+    for (size_t i = 0; i < NumRSlots; i++) {
+      occ.rslots += (module_->dbg_rslt_v_mhot_o >> i) & 1;
+    }
+    for (size_t i = 0; i < NumIds; i++) {
+      occ.wrsv_lens[i] = module_->dbg_wrsv_len_o[i];
+      occ.wrsp_lens[i] = module_->dbg_wrsp_len_o[i];
+      occ.rrsv_lens[i] = module_->dbg_rrsv_len_o[i];
+      occ.rdata_lens[i] = module_->dbg_rdata_len_o[i];
+    }
+#endif  // SIMMEM_MULTICHANNEL
+    return occ;
+  }
 
   /**
-   * Fetches a write data as the real memory controller. Requires the ready
-   * signal to be one at the DUT output.
-   *
-   * @param out_data the output write data request from the DUT
-   *
-   * @return true iff the data is valid
+   * Displays the command counts and the estimated DRAM energy. In the
+   * multi-channel design, the counters of all the channels are summed.
    */
-  bool simmem_realmem_wdata_fetch(WriteData &out_data) {
+  void simmem_display_energy(void) {
     module_->eval();
-    assert(module_->wdata_out_ready_i);
-
-    out_data.from_packed(module_->wdata_o);
-    return (bool)(module_->wdata_out_valid_o);
+    uint64_t cnts[NumPerfCnts] = {0};
+
+#ifdef SIMMEM_MULTICHANNEL
+    size_t num_channels =
+        sizeof(module_->ch_perf_cnts_o) / sizeof(module_->ch_perf_cnts_o[0]);
+    for (size_t i_ch = 0; i_ch < num_channels; i_ch++) {
+      for (size_t i_cnt = 0; i_cnt < NumPerfCnts; i_cnt++) {
+        cnts[i_cnt] += module_->ch_perf_cnts_o[i_ch][i_cnt];
+      }
+    }
+#else
+    for (size_t i_cnt = 0; i_cnt < NumPerfCnts; i_cnt++) {
+      cnts[i_cnt] = module_->perf_cnts_o[i_cnt];
+    }
+#endif  // SIMMEM_MULTICHANNEL
+
+    double cmd_energy = cnts[PERF_CNT_ACT] * kActEnergyPj +
+                        (cnts[PERF_CNT_PRE] + cnts[PERF_CNT_POLICY_PRE]) *
+                            kPreEnergyPj +
+                        cnts[PERF_CNT_RD_CAS] * kRdCasEnergyPj +
+                        cnts[PERF_CNT_WR_CAS] * kWrCasEnergyPj;
+    double bg_energy = cnts[PERF_CNT_ACT_STBY_CYCLES] * kActStbyEnergyPj +
+                       cnts[PERF_CNT_PRE_STBY_CYCLES] * kPreStbyEnergyPj;
+
+    std::cout << "\n\n#### Energy ####" << std::endl;
+    std::cout << std::dec << "Activations: " << cnts[PERF_CNT_ACT]
+              << ", precharges: " << cnts[PERF_CNT_PRE]
+              << " (row policy: " << cnts[PERF_CNT_POLICY_PRE] << ")"
+              << ", read CAS: " << cnts[PERF_CNT_RD_CAS]
+              << ", write CAS: " << cnts[PERF_CNT_WR_CAS] << std::endl;
+    // Every CAS which is not preceded by its own activation hits the open row.
+    uint64_t num_cas = cnts[PERF_CNT_RD_CAS] + cnts[PERF_CNT_WR_CAS];
+    std::cout << "Row hits: "
+              << (num_cas > cnts[PERF_CNT_ACT] ? num_cas - cnts[PERF_CNT_ACT]
+                                               : 0)
+              << " of " << num_cas << " CAS" << std::endl;
+    std::cout << "Active standby rank-cycles: "
+              << cnts[PERF_CNT_ACT_STBY_CYCLES]
+              << ", precharge standby rank-cycles: "
+              << cnts[PERF_CNT_PRE_STBY_CYCLES] << std::endl;
+    std::cout << "Stalled rank-cycles: tRRD: " << cnts[PERF_CNT_STALL_RRD]
+              << ", tFAW: " << cnts[PERF_CNT_STALL_FAW]
+              << ", tWTR: " << cnts[PERF_CNT_STALL_WTR]
+              << ", tRTW: " << cnts[PERF_CNT_STALL_RTW] << std::endl;
+    std::cout << "Command energy: " << cmd_energy
+              << " pJ, background energy: " << bg_energy
+              << " pJ, total: " << cmd_energy + bg_energy << " pJ" << std::endl;
   }
 
+#ifdef SIMMEM_MULTICHANNEL
   /**
-   * Sets the ready signal to zero on the DUT output side for the write data.
+   * Displays the per-channel counters of the multi-channel design.
    */
-  void simmem_realmem_wdata_stop(void) { module_->wdata_out_ready_i = 0; }
-
-  /**
-   * Sets the ready signal to one on the DUT output side for the read address.
-   */
-  void simmem_realmem_raddr_request(void) { module_->raddr_out_ready_i = 1; }
-
-  /**
-   * Fetches a read address as the real memory controller. Requires the ready
-   * signal to be one at the DUT output.
-   *
-   * @param out_data the output read address request from the DUT
-   *
-   * @return true iff the data is valid
-   */
-  bool simmem_realmem_raddr_fetch(ReadAddress &out_data) {
+  void simmem_display_channel_counters(void) {
     module_->eval();
-    assert(module_->raddr_out_ready_i);
-
-    out_data.from_packed(module_->raddr_o);
-    return (bool)(module_->raddr_out_valid_o);
+    size_t num_channels = sizeof(module_->ch_waddr_cnt_o) /
+                          sizeof(module_->ch_waddr_cnt_o[0]);
+
+    std::cout << "\n\n#### Channels ####" << std::endl;
+    for (size_t i_ch = 0; i_ch < num_channels; i_ch++) {
+      std::cout << "\n--- Channel " << std::dec << i_ch << " ---" << std::endl;
+      std::cout << "Write addresses: " << module_->ch_waddr_cnt_o[i_ch]
+                << ", stall cycles: " << module_->ch_wstall_cnt_o[i_ch]
+                << std::endl;
+      std::cout << "Read addresses:  " << module_->ch_raddr_cnt_o[i_ch]
+                << ", stall cycles: " << module_->ch_rstall_cnt_o[i_ch]
+                << std::endl;
+    }
   }
-
-  /**
-   * Sets the ready signal to zero on the DUT output side for the read address.
-   */
-  void simmem_realmem_raddr_stop(void) { module_->raddr_out_ready_i = 0; }
-
-  /**
-   * Mask getter.
-   */
-  uint32_t simmem_get_wrsp_mask(void) { return wrsp_mask_; }
+#endif  // SIMMEM_MULTICHANNEL
+
+  // Channels of the requester.
+  simmem_bfm::Driver<Module, WriteAddress, WAddrInPort> requester_waddr;
+  simmem_bfm::Driver<Module, WriteData, WDataInPort> requester_wdata;
+  simmem_bfm::Driver<Module, ReadAddress, RAddrInPort> requester_raddr;
+  simmem_bfm::Monitor<Module, WriteResponse, WRspOutPort> requester_wrsp;
+  simmem_bfm::Monitor<Module, ReadData, RDataOutPort> requester_rdata;
+
+  // Channels of the real memory controller.
+  simmem_bfm::Driver<Module, WriteResponse, WRspInPort> realmem_wrsp;
+  simmem_bfm::Driver<Module, ReadData, RDataInPort> realmem_rdata;
+  simmem_bfm::Monitor<Module, WriteAddress, WAddrOutPort> realmem_waddr;
+  simmem_bfm::Monitor<Module, WriteData, WDataOutPort> realmem_wdata;
+  simmem_bfm::Monitor<Module, ReadAddress, RAddrOutPort> realmem_raddr;
 
  private:
-  vluint32_t tick_count_;
-  bool record_trace_;
-  std::unique_ptr<Module> module_;
-  VerilatedFstC *trace_;
+  void drive_channels(void) {
+    simmem_bfm::drive_all(requester_waddr, requester_wdata, requester_raddr,
+                          requester_wrsp, requester_rdata, realmem_wrsp,
+                          realmem_rdata, realmem_waddr, realmem_wdata,
+                          realmem_raddr);
+  }
 
   // Mask that contains ones in the fields common between the write address
   // request and the response.
@@ -432,8 +570,8 @@ class RealMemoryController {
     WriteResponse newrsp;
     newrsp.id = waddr.id;
     // Copy the low order rsp of the incoming waddr in the corresponding wrsp
-    newrsp.rsp = (waddr.to_packed() >> WriteAddress::id_w) &
-                 ~((1L << (PackedW - 1)) >> (PackedW - WriteResponse::rsp_w));
+    newrsp.rsp =
+        waddr.to_packed().get_bits(WriteAddress::id_w, WriteResponse::rsp_w);
 
     wrsp_out_queues[waddr.id].push(newrsp);
 
@@ -567,6 +705,22 @@ class RealMemoryController {
     assert(false);
   }
 
+  void serialize(VerilatedSerialize &os) const {
+    simmem_ckpt::serialize(os, spare_wdata_cnt);
+    simmem_ckpt::serialize(os, wrsp_out_queues);
+    simmem_ckpt::serialize(os, releasable_wrsp_cnts);
+    simmem_ckpt::serialize(os, wids_expecting_data);
+    simmem_ckpt::serialize(os, rdata_out_queues);
+  }
+
+  void deserialize(VerilatedDeserialize &is) {
+    simmem_ckpt::deserialize(is, spare_wdata_cnt);
+    simmem_ckpt::deserialize(is, wrsp_out_queues);
+    simmem_ckpt::deserialize(is, releasable_wrsp_cnts);
+    simmem_ckpt::deserialize(is, wids_expecting_data);
+    simmem_ckpt::deserialize(is, rdata_out_queues);
+  }
+
  private:
   size_t spare_wdata_cnt;  // Counts received wdata
   // Not releasable until enabled using releasable_wrsp_cnts
@@ -602,7 +756,7 @@ void manual_testbench(SimmemTestbench *tb) {
   waddr_req.prot = 0;
   waddr_req.qos = 0;
 
-  tb->simmem_requester_waddr_apply(waddr_req);
+  tb->requester_waddr.apply(waddr_req);
 
   tb->simmem_tick();
 
@@ -610,44 +764,236 @@ void manual_testbench(SimmemTestbench *tb) {
   waddr_req.addr = 3;
   waddr_req.burst_len = 4;
 
-  tb->simmem_realmem_waddr_request();
+  tb->realmem_waddr.request();
   tb->simmem_tick(4);
 
   WriteData w_data;
   w_data.from_packed(0UL);
 
-  tb->simmem_requester_wdata_apply(w_data);
-  tb->simmem_realmem_wdata_request();
+  tb->requester_wdata.apply(w_data);
+  tb->realmem_wdata.request();
 
-  tb->simmem_requester_waddr_stop();
+  tb->requester_waddr.stop();
 
   tb->simmem_tick(600);
 }
-
 /**
- * This function implements a more complete, randomized and automatic testbench.
- *
- * @param tb A pointer the the already contructed SimmemTestbench object.
- * @param num_ids The number of AXI identifiers to involve. Must be at lest 1,
- * and lower than NumIds.
- * @param seed The seed for the randomized test.
- * @param num_cycles The number of simulated clock cycles.
+ * Holds the state of the randomized testbench that lives on the testbench
+ * side: the real memory controller emulator, the scoreboards, the next
+ * requester messages and the random number generator. Together with the model
+ * state, it makes up a checkpoint.
  */
-void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
-                          unsigned int seed, size_t num_cycles = 400) {
-  srand(seed);
+struct RandomizedTestState {
+  /**
+   * @param num_ids The number of AXI identifiers to involve.
+   * @param seed The seed of the random number generator.
+   * @param stimulus If not null, the bytes to decode the requester stimulus
+   * from.
+   * @param addr_pattern The address pattern of the requests.
+   */
+  RandomizedTestState(size_t num_ids, unsigned int seed,
+                      const std::vector<uint8_t> *stimulus = nullptr,
+                      addr_pattern_e addr_pattern = ADDR_PATTERN_RANDOM)
+      : num_ids(num_ids),
+        ids(make_ids(num_ids)),
+        rng(seed),
+        decode_stimulus(stimulus != nullptr),
+        addr_pattern(addr_pattern),
+        next_waddr_addr(0),
+        next_raddr_addr(GlobalMemCapa / 2),
+        realmem(ids),
+        curr_itern(0),
+        measure_start(0),
+        num_wrsp_delivered(0),
+        num_rdata_delivered(0),
+        num_wrsp_outstanding(0),
+        num_rdata_outstanding(0),
+        num_busy_cycles(0) {
+    if (decode_stimulus) {
+      stimulus_decoder = simmem_stim::StimulusDecoder(*stimulus);
+    }
+    for (size_t i = 0; i < num_ids; i++) {
+      waddr_in_queues[ids[i]];
+      waddr_out_queues[ids[i]];
+      raddr_in_queues[ids[i]];
+      raddr_out_queues[ids[i]];
+      rdata_in_queues[ids[i]];
+      rdata_out_queues[ids[i]];
+      wrsp_in_queues[ids[i]];
+      wrsp_out_queues[ids[i]];
+    }
 
-  // The AXI identifiers. During the testbench, we will always use the
-  // [0,..,num_ids) ids.
-  std::vector<uint64_t> ids;
-  for (size_t i = 0; i < num_ids; i++) {
-    ids.push_back(i);
+    renew_waddr();
+    renew_raddr();
+    renew_wdata();
+  }
+
+  /**
+   * The AXI identifiers. During the testbench, we will always use the
+   * [0,..,num_ids) ids.
+   */
+  static std::vector<uint64_t> make_ids(size_t num_ids) {
+    std::vector<uint64_t> ids;
+    for (size_t i = 0; i < num_ids; i++) {
+      ids.push_back(i);
+    }
+    return ids;
+  }
+
+  /**
+   * Address stride between two consecutive rows of the same rank (see
+   * simmem_addr_map). With the XOR hashing, the rank depends on the least
+   * significant row bits, which must then be kept.
+   */
+  static uint64_t row_stride(void) {
+    uint64_t rank_field_w = 0;
+    while ((1ULL << rank_field_w) < NumRanks) {
+      rank_field_w++;
+    }
+    uint64_t row_field_lsb = AddrMapScheme == ADDR_MAP_RANK_ROW_COL
+                                 ? RowBufLenW
+                                 : RowBufLenW + rank_field_w;
+    return (1ULL << row_field_lsb) << (AddrMapXorHash ? rank_field_w : 0);
+  }
+
+  /**
+   * Gives the address of the next request of a channel, following the address
+   * pattern.
+   *
+   * @param drawn_addr the drawn address, kept by the random pattern
+   * @param next_addr the next address of the stream of the channel
+   * @param burst_bytes the number of bytes of the burst
+   */
+  uint64_t next_address(uint64_t drawn_addr, uint64_t &next_addr,
+                        uint64_t burst_bytes) {
+    uint64_t addr = drawn_addr;
+    if (addr_pattern == ADDR_PATTERN_SEQUENTIAL) {
+      addr = next_addr;
+      next_addr += burst_bytes;
+    } else if (addr_pattern == ADDR_PATTERN_ROW_CONFLICT) {
+      // Both channels share the write stream, so that any two consecutive
+      // requests conflict.
+      addr = next_waddr_addr;
+      next_waddr_addr += row_stride();
+    }
+    return addr & (GlobalMemCapa - 1);
+  }
+
+  /**
+   * Draws the next write address request supplied by the requester.
+   */
+  void renew_waddr() {
+    if (decode_stimulus) {
+      requester_current_waddr.from_packed(stimulus_decoder.next_request());
+      requester_current_waddr.id = ids[requester_current_waddr.id % num_ids];
+    } else {
+      requester_current_waddr.from_packed(rng());
+      requester_current_waddr.id = ids[rng() % num_ids];
+    }
+    requester_current_waddr.addr =
+        next_address(requester_current_waddr.addr, next_waddr_addr,
+                     (kWBurstLenField + 1) << kWBurstSizeField);
+    requester_current_waddr.burst_len = kWBurstLenField;
+    requester_current_waddr.burst_type = BURST_INCR;
+    requester_current_waddr.burst_size = kWBurstSizeField;
+  }
+
+  /**
+   * Draws the next read address request supplied by the requester.
+   */
+  void renew_raddr() {
+    if (decode_stimulus) {
+      requester_current_raddr.from_packed(stimulus_decoder.next_request());
+      requester_current_raddr.id = ids[requester_current_raddr.id % num_ids];
+    } else {
+      requester_current_raddr.from_packed(rng());
+      requester_current_raddr.id = ids[rng() % num_ids];
+    }
+    requester_current_raddr.addr =
+        next_address(requester_current_raddr.addr, next_raddr_addr,
+                     (kRBurstLenField + 1) << kRBurstSizeField);
+    requester_current_raddr.burst_len = kRBurstLenField;
+    requester_current_raddr.burst_type = BURST_INCR;
+    requester_current_raddr.burst_size = kRBurstSizeField;
+  }
+
+  /**
+   * Draws the next write data supplied by the requester.
+   */
+  void renew_wdata() { requester_current_wdata.from_packed(rng()); }
+
+  void serialize(VerilatedSerialize &os) const {
+    simmem_ckpt::serialize(os, num_ids);
+    simmem_ckpt::serialize(os, ids);
+    simmem_ckpt::serialize(os, rng);
+    simmem_ckpt::serialize(os, decode_stimulus);
+    stimulus_decoder.serialize(os);
+    simmem_ckpt::serialize(os, addr_pattern);
+    simmem_ckpt::serialize(os, next_waddr_addr);
+    simmem_ckpt::serialize(os, next_raddr_addr);
+    realmem.serialize(os);
+    simmem_ckpt::serialize(os, waddr_in_queues);
+    simmem_ckpt::serialize(os, waddr_out_queues);
+    simmem_ckpt::serialize(os, raddr_in_queues);
+    simmem_ckpt::serialize(os, raddr_out_queues);
+    simmem_ckpt::serialize(os, rdata_in_queues);
+    simmem_ckpt::serialize(os, rdata_out_queues);
+    simmem_ckpt::serialize(os, wrsp_in_queues);
+    simmem_ckpt::serialize(os, wrsp_out_queues);
+    simmem_ckpt::serialize(os, requester_current_waddr);
+    simmem_ckpt::serialize(os, requester_current_raddr);
+    simmem_ckpt::serialize(os, requester_current_wdata);
+    simmem_ckpt::serialize(os, curr_itern);
+    simmem_ckpt::serialize(os, num_wrsp_outstanding);
+    simmem_ckpt::serialize(os, num_rdata_outstanding);
+    latency.serialize(os);
+    watchdog.serialize(os);
   }
 
-  // Instantiate a real memory controller emulator.
-  RealMemoryController realmem(ids);
+  void deserialize(VerilatedDeserialize &is) {
+    simmem_ckpt::deserialize(is, num_ids);
+    simmem_ckpt::deserialize(is, ids);
+    simmem_ckpt::deserialize(is, rng);
+    simmem_ckpt::deserialize(is, decode_stimulus);
+    stimulus_decoder.deserialize(is);
+    simmem_ckpt::deserialize(is, addr_pattern);
+    simmem_ckpt::deserialize(is, next_waddr_addr);
+    simmem_ckpt::deserialize(is, next_raddr_addr);
+    realmem.deserialize(is);
+    simmem_ckpt::deserialize(is, waddr_in_queues);
+    simmem_ckpt::deserialize(is, waddr_out_queues);
+    simmem_ckpt::deserialize(is, raddr_in_queues);
+    simmem_ckpt::deserialize(is, raddr_out_queues);
+    simmem_ckpt::deserialize(is, rdata_in_queues);
+    simmem_ckpt::deserialize(is, rdata_out_queues);
+    simmem_ckpt::deserialize(is, wrsp_in_queues);
+    simmem_ckpt::deserialize(is, wrsp_out_queues);
+    simmem_ckpt::deserialize(is, requester_current_waddr);
+    simmem_ckpt::deserialize(is, requester_current_raddr);
+    simmem_ckpt::deserialize(is, requester_current_wdata);
+    simmem_ckpt::deserialize(is, curr_itern);
+    simmem_ckpt::deserialize(is, num_wrsp_outstanding);
+    simmem_ckpt::deserialize(is, num_rdata_outstanding);
+    latency.deserialize(is);
+    watchdog.deserialize(is);
+  }
 
-  // These structures will store the input and output data, for comparison and
+  size_t num_ids;
+  std::vector<uint64_t> ids;
+  std::mt19937 rng;
+  // If set, the requester stimulus is decoded by stimulus_decoder instead of
+  // being drawn from rng.
+  bool decode_stimulus;
+  simmem_stim::StimulusDecoder stimulus_decoder;
+  // Address pattern, and next addresses of the write and read streams.
+  addr_pattern_e addr_pattern;
+  uint64_t next_waddr_addr;
+  uint64_t next_raddr_addr;
+
+  // Real memory controller emulator.
+  RealMemoryController realmem;
+
+  // These structures store the input and output data, for comparison and
   // delay measurement purposes.
   waddr_time_queue_map_t waddr_in_queues;
   waddr_time_queue_map_t waddr_out_queues;
@@ -658,32 +1004,212 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
   wrsp_time_queue_map_t wrsp_in_queues;
   wrsp_time_queue_map_t wrsp_out_queues;
 
-  for (size_t i = 0; i < num_ids; i++) {
-    waddr_in_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, WriteAddress>>>(
-            ids[i], std::queue<std::pair<size_t, WriteAddress>>()));
-    waddr_out_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, WriteAddress>>>(
-            ids[i], std::queue<std::pair<size_t, WriteAddress>>()));
-    raddr_in_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, ReadAddress>>>(
-            ids[i], std::queue<std::pair<size_t, ReadAddress>>()));
-    raddr_out_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, ReadAddress>>>(
-            ids[i], std::queue<std::pair<size_t, ReadAddress>>()));
-    rdata_in_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, ReadData>>>(
-            ids[i], std::queue<std::pair<size_t, ReadData>>()));
-    rdata_out_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, ReadData>>>(
-            ids[i], std::queue<std::pair<size_t, ReadData>>()));
-    wrsp_in_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, WriteResponse>>>(
-            ids[i], std::queue<std::pair<size_t, WriteResponse>>()));
-    wrsp_out_queues.insert(
-        std::pair<uint64_t, std::queue<std::pair<size_t, WriteResponse>>>(
-            ids[i], std::queue<std::pair<size_t, WriteResponse>>()));
+  // Attribution of the transaction latencies to their phases.
+  simmem_lat::LatencyTracker latency;
+  // Bounded latency check of the outstanding transactions.
+  simmem_wd::LivenessWatchdog watchdog;
+
+  // Next messages supplied by the requester.
+  WriteAddress requester_current_waddr;
+  ReadAddress requester_current_raddr;
+  WriteData requester_current_wdata;
+
+  // Current cycle, and first cycle of the measurement window.
+  size_t curr_itern;
+  size_t measure_start;
+
+  // Count the write responses and read data delivered to the requester during
+  // the measurement window, for bandwidth estimation.
+  size_t num_wrsp_delivered;
+  size_t num_rdata_delivered;
+
+  // Count the write bursts and read data accepted but not yet delivered, and
+  // the cycles of the measurement window where some are outstanding.
+  size_t num_wrsp_outstanding;
+  size_t num_rdata_outstanding;
+  size_t num_busy_cycles;
+};
+
+void SimmemTestbench::save(const std::string &path,
+                           const RandomizedTestState &state) {
+#ifdef SIMMEM_SAVABLE
+  VerilatedSave os;
+  os.open(path.c_str());
+  simmem_ckpt::serialize(os, tick_count_);
+  os << *module_;
+  state.serialize(os);
+#else
+  std::cerr << "Checkpoints require a model built with --savable (see the "
+               "sim_simmem_top_savable target)."
+            << std::endl;
+  exit(1);
+#endif  // SIMMEM_SAVABLE
+}
+
+void SimmemTestbench::restore(const std::string &path,
+                              RandomizedTestState &state) {
+#ifdef SIMMEM_SAVABLE
+  VerilatedRestore is;
+  is.open(path.c_str());
+  simmem_ckpt::deserialize(is, tick_count_);
+  is >> *module_;
+  state.deserialize(is);
+#else
+  std::cerr << "Checkpoints require a model built with --savable (see the "
+               "sim_simmem_top_savable target)."
+            << std::endl;
+  exit(1);
+#endif  // SIMMEM_SAVABLE
+}
+
+/**
+ * Checks whether a response was released before the response of the oldest
+ * outstanding request of its AXI identifier, i.e., whether its marker is the
+ * expected marker of a younger request of the same identifier. In the
+ * multi-channel design, this detects the responses of several channels merged
+ * out of the per-identifier order.
+ *
+ * @param requests the outstanding requests of the identifier, with their input
+ * times, oldest first
+ * @param marker the marker of the response
+ * @param expected_marker gives the expected response marker of a request
+ */
+template <typename Request, typename MarkerFunc>
+bool is_reordered(std::queue<std::pair<size_t, Request>> requests,
+                  uint64_t marker, MarkerFunc expected_marker) {
+  if (!requests.empty()) {
+    requests.pop();
+  }
+  for (; !requests.empty(); requests.pop()) {
+    if (expected_marker(requests.front().second) == marker) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Checks the latency of the recorded transactions against the fixed latency of
+ * their direction, with the fixed-latency delay engine.
+ *
+ * The write latency is measured from the last write data, and the read latency
+ * from the read address request: this is the issue of the transaction in the
+ * latency breakdown. The slot timer of simmem_delay_slots starts the cycle
+ * after the issue, at the latency minus kSlotRspLatency, so the mem phase lasts
+ * exactly the latency minus the kSlotRspLatency - 1 cycles to the output.
+ * From the issue to the last response, the transaction may not be faster than
+ * its latency, but may be slower, for instance when the read data of several
+ * bursts compete for the output.
+ *
+ * @param latency the latency breakdown of the run
+ * @param report whether to display the mismatches
+ *
+ * @return the number of transactions which do not meet their fixed latency
+ */
+size_t check_fixed_latencies(const simmem_lat::LatencyTracker &latency,
+                             bool report) {
+  const size_t fixed_lats[simmem_lat::NUM_LAT_CHANNELS] = {FixedWLat,
+                                                           FixedRLat};
+  const std::vector<simmem_lat::LatencyRecord> &records = latency.records();
+  size_t num_mismatches = 0;
+
+  for (size_t i = 0; i < records.size(); i++) {
+    const simmem_lat::LatencyRecord &rec = records[i];
+    if (!rec.located) {
+      continue;
+    }
+    size_t lat = std::max(fixed_lats[rec.channel], kSlotRspLatency);
+    size_t mem = rec.phases[simmem_lat::LAT_PHASE_MEM];
+    size_t from_issue = mem + rec.phases[simmem_lat::LAT_PHASE_REALMEM] +
+                        rec.phases[simmem_lat::LAT_PHASE_OUTPUT];
+    if (mem == lat - (kSlotRspLatency - 1) && from_issue >= lat) {
+      continue;
+    }
+    num_mismatches++;
+    if (report) {
+      std::cout << "Fixed latency mismatch: "
+                << simmem_lat::kLatChannelNames[rec.channel] << ", ID "
+                << std::dec << rec.axi_id << ", accepted at " << rec.accepted
+                << ", mem: " << mem << ", from issue: " << from_issue
+                << " (latency: " << lat << ")" << std::endl;
+    }
+  }
+  return num_mismatches;
+}
+
+/**
+ * This function implements a more complete, randomized and automatic testbench.
+ *
+ * The run is split into a warm-up phase and a measurement window, and only the
+ * transactions whose requests enter the design during the measurement window
+ * are reported. The state reached at the end of the warm-up can be saved as a
+ * checkpoint, from which many measurement runs can then be forked.
+ *
+ * The testbench-side state is built afresh and the design is reset at each
+ * call, so that successive episodes can run on the same model instance.
+ *
+ * @param tb A pointer the the already contructed SimmemTestbench object.
+ * @param opts The options of the run.
+ * @param sampler The occupancy sampler, which samples the measurement window
+ * if it is enabled.
+ *
+ * @return The statistics of the run.
+ */
+EpisodeStats randomized_testbench(SimmemTestbench *tb,
+                                  const RandomizedTestOptions &opts,
+                                  simmem_occ::OccupancySampler &sampler) {
+  simmem_prof::PhaseProfiler &prof = simmem_prof::profiler();
+  EpisodeStats stats;
+  RandomizedTestState state(opts.num_ids, opts.seed, opts.stimulus,
+                            opts.addr_pattern);
+
+  //////////////////////
+  // Simulation start //
+  //////////////////////
+
+  if (opts.restore_path.empty()) {
+    tb->simmem_reset();
+    state.measure_start = opts.warmup_cycles;
+  } else {
+    tb->restore(opts.restore_path, state);
+    if (opts.reseed) {
+      // Forked runs differ by their stimulus after the checkpoint.
+      state.rng.seed(opts.seed);
+    }
+    if (opts.stimulus) {
+      // The stimulus is decoded from the checkpoint on.
+      state.decode_stimulus = true;
+      state.stimulus_decoder = simmem_stim::StimulusDecoder(*opts.stimulus);
+    }
+    state.measure_start = state.curr_itern;
   }
+  state.latency.set_measure_start(state.measure_start);
+  if (opts.watchdog) {
+    state.watchdog.set_bound(opts.watchdog_bound
+                                 ? opts.watchdog_bound
+                                 : simmem_wd::default_watchdog_bound());
+  }
+
+  // Aliases of the state members, for readability.
+  const size_t num_ids = state.num_ids;
+  std::vector<uint64_t> &ids = state.ids;
+  std::mt19937 &rng = state.rng;
+  RealMemoryController &realmem = state.realmem;
+  simmem_lat::LatencyTracker &latency = state.latency;
+  simmem_wd::LivenessWatchdog &watchdog = state.watchdog;
+  waddr_time_queue_map_t &waddr_in_queues = state.waddr_in_queues;
+  waddr_time_queue_map_t &waddr_out_queues = state.waddr_out_queues;
+  raddr_time_queue_map_t &raddr_in_queues = state.raddr_in_queues;
+  raddr_time_queue_map_t &raddr_out_queues = state.raddr_out_queues;
+  rdata_time_queue_map_t &rdata_in_queues = state.rdata_in_queues;
+  rdata_time_queue_map_t &rdata_out_queues = state.rdata_out_queues;
+  wrsp_time_queue_map_t &wrsp_in_queues = state.wrsp_in_queues;
+  wrsp_time_queue_map_t &wrsp_out_queues = state.wrsp_out_queues;
+  WriteAddress &requester_current_waddr = state.requester_current_waddr;
+  ReadAddress &requester_current_raddr = state.requester_current_raddr;
+  WriteData &requester_current_wdata = state.requester_current_wdata;
+  const size_t measure_start = state.measure_start;
+  const size_t measure_end = measure_start + opts.num_cycles;
 
   // Signal whether some input is applied to the simmem.
   bool requester_apply_waddr_input;
@@ -701,31 +1227,6 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
 
   bool iteration_announced;  // Variable only used for display purposes.
 
-  ///////////////////////
-  // Requester signals //
-  ///////////////////////
-  // Initialization of the next messages that will be supplied.
-
-  // Input waddr from the requester
-  WriteAddress requester_current_waddr;
-  requester_current_waddr.from_packed(rand());
-  requester_current_waddr.id = ids[rand() % num_ids];
-  requester_current_waddr.burst_len = kWBurstLenField;
-  requester_current_waddr.burst_type = BURST_INCR;
-  requester_current_waddr.burst_size = kWBurstSizeField;
-
-  // Input raddr from the requester
-  ReadAddress requester_current_raddr;
-  requester_current_raddr.from_packed(rand());
-  requester_current_raddr.id = ids[rand() % num_ids];
-  requester_current_raddr.burst_len = kRBurstLenField;
-  requester_current_raddr.burst_type = BURST_INCR;
-  requester_current_raddr.burst_size = kRBurstSizeField;
-
-  // Input wdata from the requester
-  WriteData requester_current_wdata;
-  requester_current_wdata.from_packed(rand());
-
   // Outputs from the simmem to the requester
   WriteResponse requester_current_wrsp;  // Output wrsp to the requester
   ReadData requester_current_rdata;      // Output rdata to the requester
@@ -741,14 +1242,26 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
   ReadAddress realmem_current_raddr;   // Output to the realmem
   WriteData realmem_current_wdata;     // Output to the realmem
 
-  //////////////////////
-  // Simulation start //
-  //////////////////////
+  for (; state.curr_itern < measure_end; state.curr_itern++) {
+    size_t curr_itern = state.curr_itern;
 
-  tb->simmem_reset();
+    if (curr_itern == measure_start && !opts.save_path.empty()) {
+      // The checkpoint is taken between two clock cycles, at the end of the
+      // warm-up.
+      tb->save(opts.save_path, state);
+      std::cout << "Checkpoint saved to " << opts.save_path << " at step "
+                << std::dec << curr_itern << "." << std::endl;
+      return stats;
+    }
+
+    if (curr_itern >= measure_start &&
+        (state.num_wrsp_outstanding || state.num_rdata_outstanding)) {
+      state.num_busy_cycles++;
+    }
 
-  for (size_t curr_itern = 0; curr_itern < num_cycles; curr_itern++) {
+    prof.switch_to(simmem_prof::PHASE_STIMULUS);
     iteration_announced = false;
+    watchdog.begin_cycle(curr_itern);
 
     ///////////////////////////////////////////////////////////
     // Determine which signals to apply during the iteration //
@@ -759,16 +1272,26 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
     ///////////////////////
 
     // Randomize the boolean signals deciding which interactions will take place
-    // in this cycle
-    requester_apply_waddr_input = (bool)(rand() & 1);
-    requester_apply_raddr_input = (bool)(rand() & 1);
-    requester_apply_wdata_input = (bool)(rand() & 1);
+    // in this cycle, or decode them from the stimulus
+    if (state.decode_stimulus) {
+      uint8_t stimulus_bits = state.stimulus_decoder.next_cycle();
+      requester_apply_waddr_input = stimulus_bits & simmem_stim::kStimulusWAddr;
+      requester_apply_raddr_input = stimulus_bits & simmem_stim::kStimulusRAddr;
+      requester_apply_wdata_input = stimulus_bits & simmem_stim::kStimulusWData;
+    } else {
+      requester_apply_waddr_input =
+          (unsigned int)(rng() % 100) < opts.waddr_prob;
+      requester_apply_raddr_input =
+          (unsigned int)(rng() % 100) < opts.raddr_prob;
+      requester_apply_wdata_input =
+          (unsigned int)(rng() % 100) < opts.wdata_prob;
+    }
     // The requester is supposedly always ready to get data, for more accurate
     // delay calculation
     requester_req_wrsp_output =
-        kRequesterAlwaysReady ? true : (bool)(rand() & 1);
+        kRequesterAlwaysReady ? true : (bool)(rng() & 1);
     requester_req_rdata_output =
-        kRequesterAlwaysReady ? true : (bool)(rand() & 1);
+        kRequesterAlwaysReady ? true : (bool)(rng() & 1);
 
     /////////////////////
     // Realmem signals //
@@ -781,9 +1304,9 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
     realmem_apply_rdata_input = realmem.has_rdata_to_input();
     // The real memory controller is supposedly always ready to get data, for
     // more accurate delay calculation
-    realmem_req_waddr_output = kRealmemAlwaysReady ? true : (bool)(rand() & 1);
-    realmem_req_raddr_output = kRealmemAlwaysReady ? true : (bool)(rand() & 1);
-    realmem_req_wdata_output = kRealmemAlwaysReady ? true : (bool)(rand() & 1);
+    realmem_req_waddr_output = kRealmemAlwaysReady ? true : (bool)(rng() & 1);
+    realmem_req_raddr_output = kRealmemAlwaysReady ? true : (bool)(rng() & 1);
+    realmem_req_wdata_output = kRealmemAlwaysReady ? true : (bool)(rng() & 1);
 
     ////////////////////////////////////////////////////
     // Signal application and readiness for requester //
@@ -791,24 +1314,28 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
 
     if (requester_apply_waddr_input) {
       // Apply a given input
-      tb->simmem_requester_waddr_apply(requester_current_waddr);
+      tb->requester_waddr.apply(requester_current_waddr);
+      latency.present(simmem_lat::LAT_CH_WRITE, curr_itern);
+      watchdog.present(simmem_lat::LAT_CH_WRITE);
     }
     if (requester_apply_raddr_input) {
       // Apply a given input
-      tb->simmem_requester_raddr_apply(requester_current_raddr);
+      tb->requester_raddr.apply(requester_current_raddr);
+      latency.present(simmem_lat::LAT_CH_READ, curr_itern);
+      watchdog.present(simmem_lat::LAT_CH_READ);
     }
     if (requester_apply_wdata_input) {
       // Apply a given input
-      tb->simmem_requester_wdata_apply(requester_current_wdata);
+      tb->requester_wdata.apply(requester_current_wdata);
     }
 
     if (requester_req_wrsp_output) {
       // Express readiness
-      tb->simmem_requester_wrsp_request();
+      tb->requester_wrsp.request();
     }
     if (requester_req_rdata_output) {
       // Express readiness
-      tb->simmem_requester_rdata_request();
+      tb->requester_rdata.request();
     }
 
     //////////////////////////////////////////////////
@@ -817,23 +1344,43 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
 
     if (realmem_apply_wrsp_input) {
       // Apply the next available wrsp from the real memory controller
-      tb->simmem_realmem_wrsp_apply(realmem.get_next_wrsp());
+      tb->realmem_wrsp.apply(realmem.get_next_wrsp());
     }
     if (realmem_apply_rdata_input) {
       // Apply the next available rdata from the real memory controller
-      tb->simmem_realmem_rdata_apply(realmem.get_next_rdata());
+      tb->realmem_rdata.apply(realmem.get_next_rdata());
     }
     if (realmem_req_waddr_output) {
       // Express readiness
-      tb->simmem_realmem_waddr_request();
+      tb->realmem_waddr.request();
     }
     if (realmem_req_raddr_output) {
       // Express readiness
-      tb->simmem_realmem_raddr_request();
+      tb->realmem_raddr.request();
     }
     if (realmem_req_wdata_output) {
       // Express readiness
-      tb->simmem_realmem_wdata_request();
+      tb->realmem_wdata.request();
+    }
+
+    // Apply the signals of all the channels at once, before checking the
+    // handshakes.
+    prof.switch_to(simmem_prof::PHASE_EVAL);
+    tb->simmem_apply_channels();
+    prof.switch_to(simmem_prof::PHASE_SCOREBOARD);
+
+    // Locate the outstanding transactions in the delay calculator.
+    DebugEvents debug_events = tb->simmem_get_debug_events();
+    latency.apply_debug_events(simmem_lat::LAT_CH_WRITE,
+                               debug_events.wrsp_issued_mhot,
+                               debug_events.wrsp_done_mhot, curr_itern);
+    latency.apply_debug_events(simmem_lat::LAT_CH_READ,
+                               debug_events.rdata_issued_mhot,
+                               debug_events.rdata_done_mhot, curr_itern);
+
+    if (curr_itern >= measure_start && sampler.is_due(curr_itern)) {
+      simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
+      sampler.record(curr_itern, tb->simmem_get_occupancy());
     }
 
     ////////////////////////////////////
@@ -841,12 +1388,19 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
     ////////////////////////////////////
 
     // waddr handshake
-    if (requester_apply_waddr_input && tb->simmem_requester_waddr_check()) {
+    if (tb->requester_waddr.check()) {
       // If the input handshake between the requester and the simmem has been
       // successful for waddr, then accept the input.
       waddr_in_queues[requester_current_waddr.id].push(
           std::pair<size_t, WriteAddress>(curr_itern, requester_current_waddr));
-      if (kTransactionVerbose) {
+      latency.accept(simmem_lat::LAT_CH_WRITE, requester_current_waddr.id,
+                     debug_events.wrsv_iid, 1, curr_itern);
+      state.num_wrsp_outstanding++;
+      watchdog.accept(simmem_lat::LAT_CH_WRITE, requester_current_waddr.id,
+                      requester_current_waddr.addr, kWBurstLenField + 1,
+                      curr_itern);
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -857,19 +1411,22 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
 
       // Renew the input data if the input handshake has been successful
-      requester_current_waddr.from_packed(rand());
-      requester_current_waddr.id = ids[rand() % num_ids];
-      requester_current_waddr.burst_len = kWBurstLenField;
-      requester_current_waddr.burst_size = kWBurstSizeField;
-      requester_current_waddr.burst_type = BURST_INCR;
+      state.renew_waddr();
     }
     // raddr handshake
-    if (requester_apply_raddr_input && tb->simmem_requester_raddr_check()) {
+    if (tb->requester_raddr.check()) {
       // If the input handshake between the requester and the simmem has been
       // successful for raddr, then accept the input.
       raddr_in_queues[requester_current_raddr.id].push(
           std::pair<size_t, ReadAddress>(curr_itern, requester_current_raddr));
-      if (kTransactionVerbose) {
+      latency.accept(simmem_lat::LAT_CH_READ, requester_current_raddr.id,
+                     debug_events.rrsv_iid, kRBurstLenField + 1, curr_itern);
+      state.num_rdata_outstanding += kRBurstLenField + 1;
+      watchdog.accept(simmem_lat::LAT_CH_READ, requester_current_raddr.id,
+                      requester_current_raddr.addr, kRBurstLenField + 1,
+                      curr_itern);
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -879,17 +1436,22 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
                   << requester_current_raddr.to_packed() << std::endl;
       }
       // Renew the input data if the input handshake has been successful
-      requester_current_raddr.from_packed(rand());
-      requester_current_raddr.id = ids[rand() % num_ids];
-      requester_current_raddr.burst_len = kRBurstLenField;
-      requester_current_raddr.burst_size = kRBurstSizeField;
-      requester_current_raddr.burst_type = BURST_INCR;
+      state.renew_raddr();
     }
+    // A request may be issued as soon as it is accepted, for instance the read
+    // requests of the fixed-latency engine: their issue events are applied
+    // again once the new transactions are known.
+    latency.apply_debug_events(simmem_lat::LAT_CH_WRITE,
+                               debug_events.wrsp_issued_mhot, 0, curr_itern);
+    latency.apply_debug_events(simmem_lat::LAT_CH_READ,
+                               debug_events.rdata_issued_mhot, 0, curr_itern);
     // wdata handshake
-    if (requester_apply_wdata_input && tb->simmem_requester_wdata_check()) {
+    if (tb->requester_wdata.check()) {
       // If the input handshake between the requester and the simmem has been
       // successful for wdata, then accept the input.
-      if (kTransactionVerbose) {
+      watchdog.wdata(curr_itern);
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -899,17 +1461,20 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
                   << requester_current_wdata.to_packed() << std::endl;
       }
       // Renew the input data if the input handshake has been successful
-      requester_current_wdata.from_packed(rand());
+      state.renew_wdata();
     }
     // wrsp handshake
-    if (realmem_apply_wrsp_input && tb->simmem_realmem_wrsp_check()) {
+    if (tb->realmem_wrsp.check()) {
       // If the input handshake between the realmem and the simmem has been
       // successful, then accept the input.
       realmem_current_wrsp = realmem.get_next_wrsp();
       realmem.pop_next_wrsp();
       wrsp_in_queues[realmem_current_wrsp.id].push(
           std::pair<size_t, WriteResponse>(curr_itern, realmem_current_wrsp));
-      if (kTransactionVerbose) {
+      latency.realmem_response(simmem_lat::LAT_CH_WRITE,
+                               realmem_current_wrsp.id, curr_itern);
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -920,14 +1485,17 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
     }
     // rdata handshake
-    if (realmem_apply_rdata_input && tb->simmem_realmem_rdata_check()) {
+    if (tb->realmem_rdata.check()) {
       // If the input handshake between the realmem and the simmem has been
       // successful, then accept the input.
       realmem_current_rdata = realmem.get_next_rdata();
       realmem.pop_next_rdata();
       rdata_in_queues[realmem_current_rdata.id].push(
           std::pair<size_t, ReadData>(curr_itern, realmem_current_rdata));
-      if (kTransactionVerbose) {
+      latency.realmem_response(simmem_lat::LAT_CH_READ,
+                               realmem_current_rdata.id, curr_itern);
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -943,15 +1511,15 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
     ///////////////////////////////////////
 
     // waddr handshake
-    if (realmem_req_waddr_output &&
-        tb->simmem_realmem_waddr_fetch(realmem_current_waddr)) {
+    if (tb->realmem_waddr.fetch(realmem_current_waddr)) {
       // If the output handshake between the realmem and the simmem has been
       // successful, then accept the output.
       waddr_out_queues[ids[realmem_current_waddr.id]].push(
           std::pair<size_t, WriteAddress>(curr_itern, realmem_current_waddr));
       // Let the realmem treat the freshly received waddr
       realmem.accept_waddr(realmem_current_waddr);
-      if (kTransactionVerbose) {
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -962,8 +1530,7 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
     }
     // raddr handshake
-    if (realmem_req_raddr_output &&
-        tb->simmem_realmem_raddr_fetch(realmem_current_raddr)) {
+    if (tb->realmem_raddr.fetch(realmem_current_raddr)) {
       // If the output handshake between the realmem and the simmem has been
       // successful, then accept the output.
       raddr_out_queues[ids[realmem_current_raddr.id]].push(
@@ -972,7 +1539,8 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       // Let the realmem treat the freshly received raddr
       realmem.accept_raddr(realmem_current_raddr);
 
-      if (kTransactionVerbose) {
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -983,13 +1551,13 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
     }
     // wdata handshake
-    if (realmem_req_wdata_output &&
-        tb->simmem_realmem_wdata_fetch(realmem_current_wdata)) {
+    if (tb->realmem_wdata.fetch(realmem_current_wdata)) {
       // If the output handshake between the realmem and the simmem has been
       // successful, then accept the output. Let the realmem treat the freshly
       // received wdata.
       realmem.accept_wdata(realmem_current_wdata);
-      if (kTransactionVerbose) {
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -1000,14 +1568,22 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
     }
     // wrsp handshake
-    if (requester_req_wrsp_output &&
-        tb->simmem_requester_wrsp_fetch(requester_current_wrsp)) {
+    if (tb->requester_wrsp.fetch(requester_current_wrsp)) {
       // If the output handshake between the requester and the simmem has been
       // successful, then accept the output.
       wrsp_out_queues[ids[requester_current_wrsp.id]].push(
           std::pair<size_t, WriteResponse>(curr_itern, requester_current_wrsp));
+      latency.output(simmem_lat::LAT_CH_WRITE, requester_current_wrsp.id,
+                     curr_itern);
+      state.num_wrsp_outstanding--;
+      watchdog.output(simmem_lat::LAT_CH_WRITE, requester_current_wrsp.id,
+                      curr_itern);
+      if (curr_itern >= measure_start) {
+        state.num_wrsp_delivered++;
+      }
 
-      if (kTransactionVerbose) {
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -1018,14 +1594,22 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
     }
     // rdata handshake
-    if (requester_req_rdata_output &&
-        tb->simmem_requester_rdata_fetch(requester_current_rdata)) {
+    if (tb->requester_rdata.fetch(requester_current_rdata)) {
       // If the output handshake between the requester and the simmem has been
       // successful, then accept the output.
       rdata_out_queues[ids[requester_current_rdata.id]].push(
           std::pair<size_t, ReadData>(curr_itern, requester_current_rdata));
+      latency.output(simmem_lat::LAT_CH_READ, requester_current_rdata.id,
+                     curr_itern);
+      state.num_rdata_outstanding--;
+      watchdog.output(simmem_lat::LAT_CH_READ, requester_current_rdata.id,
+                      curr_itern);
+      if (curr_itern >= measure_start) {
+        state.num_rdata_delivered++;
+      }
 
-      if (kTransactionVerbose) {
+      if (opts.verbose) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
         if (!iteration_announced) {
           iteration_announced = true;
           std::cout << std::endl
@@ -1036,6 +1620,18 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
     }
 
+    // Checks the bounded latency of the outstanding transactions, while the
+    // design is still settled.
+    if (watchdog.check(curr_itern)) {
+      stats.num_watchdog_violations++;
+      if (opts.report) {
+        watchdog.display_violation(tb->simmem_get_occupancy());
+      }
+      tb->simmem_tick();
+      tb->simmem_stop_channels();
+      break;
+    }
+
     //////////////////////////////
     // Tick and disable signals //
     //////////////////////////////
@@ -1043,41 +1639,13 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
     // Reset all signals after tick. They may be set again before the next DUT
     // evaluation during the beginning of the next iteration.
 
+    prof.switch_to(simmem_prof::PHASE_EVAL);
     tb->simmem_tick();
 
-    // Disable requester signals
-    if (requester_apply_waddr_input) {
-      tb->simmem_requester_waddr_stop();
-    }
-    if (requester_apply_raddr_input) {
-      tb->simmem_requester_raddr_stop();
-    }
-    if (requester_apply_wdata_input) {
-      tb->simmem_requester_wdata_stop();
-    }
-    if (requester_req_wrsp_output) {
-      tb->simmem_requester_wrsp_stop();
-    }
-    if (requester_req_rdata_output) {
-      tb->simmem_requester_rdata_stop();
-    }
-    // Disable realmem signals
-    if (realmem_apply_wrsp_input) {
-      tb->simmem_realmem_wrsp_stop();
-    }
-    if (realmem_apply_rdata_input) {
-      tb->simmem_realmem_rdata_stop();
-    }
-    if (realmem_req_waddr_output) {
-      tb->simmem_realmem_waddr_stop();
-    }
-    if (realmem_req_raddr_output) {
-      tb->simmem_realmem_raddr_stop();
-    }
-    if (realmem_req_wdata_output) {
-      tb->simmem_realmem_wdata_stop();
-    }
+    prof.switch_to(simmem_prof::PHASE_STIMULUS);
+    tb->simmem_stop_channels();
   }
+  prof.switch_to(simmem_prof::PHASE_SCOREBOARD);
 
   //////////////////////
   // Delay assessment //
@@ -1092,12 +1660,22 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
   ReadAddress in_raddr;
   ReadData out_rdata;
 
-  // Counts the write response detected mismatches.
+  // Counts the write response detected mismatches, and among them the responses
+  // released out of the per-identifier order.
   size_t num_wrsp_mismatches = 0;
-  std::cout << "\n#### Write responses ####" << std::endl;
+  size_t num_wrsp_reorders = 0;
+  auto expected_wrsp_marker = [tb](const WriteAddress &waddr) {
+    return waddr.to_packed().low() & tb->simmem_get_wrsp_mask();
+  };
+  if (opts.report) {
+    std::cout << "\n#### Write responses ####" << std::endl;
+  }
 
   for (size_t curr_id = 0; curr_id < num_ids; curr_id++) {
-    std::cout << "\n--- AXI ID " << std::dec << curr_id << " ---" << std::endl;
+    if (opts.display_delays) {
+      std::cout << "\n--- AXI ID " << std::dec << curr_id << " ---"
+                << std::endl;
+    }
 
     while (!waddr_in_queues[curr_id].empty() &&
            !wrsp_out_queues[curr_id].empty()) {
@@ -1107,31 +1685,53 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       in_waddr = waddr_in_queues[curr_id].front().second;
       out_wrsp = wrsp_out_queues[curr_id].front().second;
 
+      // Displays the delay for the sent and received message for each write
+      // address request of the measurement window. The payload field helps
+      // identifying the message in the waveforms.
+      uint64_t expected_wrsp = expected_wrsp_marker(in_waddr);
+      if (expected_wrsp != out_wrsp.to_packed().low() &&
+          is_reordered(waddr_in_queues[curr_id], out_wrsp.to_packed().low(),
+                       expected_wrsp_marker)) {
+        num_wrsp_reorders++;
+      }
+
       waddr_in_queues[curr_id].pop();
       wrsp_out_queues[curr_id].pop();
-      // Displays the delay for the sent and received message for each write
-      // address request. The payload field helps identifying the message in the
-      // waveforms.
-      std::cout << "Delay: " << std::setw(4) << std::dec << out_time - in_time
-                << std::hex << " (waddr: " << in_waddr.to_packed()
-                << ", wrsp marker: " << out_wrsp.to_packed() << " (expected "
-                << (in_waddr.to_packed() & tb->simmem_get_wrsp_mask()) << "))."
-                << std::endl;
+      if (in_time >= measure_start) {
+        stats.num_wrsp++;
+        stats.wrsp_delay_sum += out_time - in_time;
+        stats.wrsp_delay_max =
+            std::max(stats.wrsp_delay_max, out_time - in_time);
+      }
+      if (in_time >= measure_start && opts.display_delays) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
+        std::cout << "Delay: " << std::setw(4) << std::dec
+                  << out_time - in_time << std::hex
+                  << " (waddr: " << in_waddr.to_packed()
+                  << ", wrsp marker: " << out_wrsp.to_packed()
+                  << " (expected " << expected_wrsp << "))." << std::endl;
+      }
 
-      if ((in_waddr.to_packed() & tb->simmem_get_wrsp_mask()) !=
-          out_wrsp.to_packed()) {
+      if (expected_wrsp != out_wrsp.to_packed().low()) {
         num_wrsp_mismatches++;
       }
     }
   }
   // Checks for response ordering.
-  std::cout << "\nWrite response mismatches: " << std::dec
-            << num_wrsp_mismatches << std::endl;
+  if (opts.report) {
+    std::cout << "\nWrite response mismatches: " << std::dec
+              << num_wrsp_mismatches << std::endl;
+    std::cout << "Write responses out of the per-ID order: "
+              << num_wrsp_reorders << std::endl;
+  }
 
   // Second, read data delays are checked. Implementation is simplified by
   // assuming a fixed burst length.
   size_t num_rdata_mismatches = 0;
-  std::cout << "\n\n#### Read data ####" << std::endl;
+  size_t num_rdata_reorders = 0;
+  if (opts.report) {
+    std::cout << "\n\n#### Read data ####" << std::endl;
+  }
 
   // rdata_id_in_burst stores the current position in a read burst, useful to
   // track the boundaries between (fixed-length) read bursts.
@@ -1140,7 +1740,10 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
   for (size_t curr_id = 0; curr_id < num_ids; curr_id++) {
     rdata_id_in_burst = 0;
 
-    std::cout << "\n--- AXI ID " << std::dec << curr_id << " ---" << std::endl;
+    if (opts.display_delays) {
+      std::cout << "\n--- AXI ID " << std::dec << curr_id << " ---"
+                << std::endl;
+    }
 
     while (!raddr_in_queues[curr_id].empty() &&
            !rdata_out_queues[curr_id].empty()) {
@@ -1152,6 +1755,25 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       in_raddr = raddr_in_queues[curr_id].front().second;
       out_rdata = rdata_out_queues[curr_id].front().second;
 
+      // Mask for the LSBs of the address embedded in the read data for testing
+      // purposes. This field is expected to be the address of the raddr plus
+      // the read data identifier in the burst.
+      uint64_t wdata_addr_bits_mask =
+          ~((1L << 63) >> (63 - MaxBurstEffSizeBytes));
+      auto expected_rdata_marker_of = [&](const ReadAddress &raddr) {
+        return ((raddr.to_packed().low() >> IDWidth) + curr_rdata_id) &
+               wdata_addr_bits_mask;
+      };
+
+      uint64_t rdata_marker =
+          (out_rdata.to_packed().low() >> IDWidth) & wdata_addr_bits_mask;
+      uint64_t expected_rdata_marker = expected_rdata_marker_of(in_raddr);
+      if (rdata_marker != expected_rdata_marker &&
+          is_reordered(raddr_in_queues[curr_id], rdata_marker,
+                       expected_rdata_marker_of)) {
+        num_rdata_reorders++;
+      }
+
       if (++rdata_id_in_burst == kRBurstLenField + 1) {
         // kRBurstLenField+1 because the effective burst length is the burst
         // length field plus one.
@@ -1160,49 +1782,403 @@ void randomized_testbench(SimmemTestbench *tb, size_t num_ids,
       }
       rdata_out_queues[curr_id].pop();
 
-      // Mask for the LSBs of the address embedded in the read data for testing
-      // purposes. This field is expected to be the address of the raddr plus
-      // the read data identifier in the burst.
-      uint64_t wdata_addr_bits_mask =
-          ~((1L << (PackedW - 1)) >> (PackedW - 1 - MaxBurstEffSizeBytes));
-
-      std::cout << "Delay: " << std::setw(4) << std::dec << out_time - in_time
-                << std::hex << " (raddr: " << in_raddr.to_packed()
-                << ", rdata marker: "
-                << ((out_rdata.to_packed() >> IDWidth) & wdata_addr_bits_mask)
-                << " (expected: "
-                << (((in_raddr.to_packed() >> IDWidth) + curr_rdata_id) &
-                    wdata_addr_bits_mask)
-                << "), rdata id: " << curr_rdata_id << ")." << std::endl;
-
-      if (((out_rdata.to_packed() >> IDWidth) & wdata_addr_bits_mask) !=
-          (((in_raddr.to_packed() >> IDWidth) + curr_rdata_id) &
-           wdata_addr_bits_mask)) {
+      if (in_time >= measure_start) {
+        stats.num_rdata++;
+        stats.rdata_delay_sum += out_time - in_time;
+        stats.rdata_delay_max =
+            std::max(stats.rdata_delay_max, out_time - in_time);
+      }
+      if (in_time >= measure_start && opts.display_delays) {
+        simmem_prof::PhaseScope log_scope(simmem_prof::PHASE_LOGGING);
+        std::cout << "Delay: " << std::setw(4) << std::dec
+                  << out_time - in_time << std::hex
+                  << " (raddr: " << in_raddr.to_packed()
+                  << ", rdata marker: " << rdata_marker
+                  << " (expected: " << expected_rdata_marker
+                  << "), rdata id: " << curr_rdata_id << ")." << std::endl;
+      }
+
+      if (rdata_marker != expected_rdata_marker) {
         num_rdata_mismatches++;
       }
     }
   }
 
   // Checks for response ordering.
-  std::cout << "\nRead data mismatches: " << std::dec << num_rdata_mismatches
-            << std::endl;
+  if (opts.report) {
+    std::cout << "\nRead data mismatches: " << std::dec << num_rdata_mismatches
+              << std::endl;
+    std::cout << "Read data out of the per-ID order: " << num_rdata_reorders
+              << std::endl;
+  }
+
+  prof.switch_to(simmem_prof::PHASE_LOGGING);
+
+  // Third, the bandwidth delivered to the requester during the measurement
+  // window is estimated from the constant burst lengths and sizes.
+  size_t wbytes = (state.num_wrsp_delivered * (kWBurstLenField + 1))
+                  << kWBurstSizeField;
+  size_t rbytes = state.num_rdata_delivered << kRBurstSizeField;
+  if (opts.report) {
+    std::cout << "\n\n#### Throughput ####" << std::endl;
+    std::cout << "Cycles: " << std::dec << opts.num_cycles
+              << ", write bursts: " << state.num_wrsp_delivered
+              << ", read beats: " << state.num_rdata_delivered << std::endl;
+    std::cout << "Write bandwidth: " << (double)wbytes / opts.num_cycles
+              << " B/cycle, read bandwidth: "
+              << (double)rbytes / opts.num_cycles << " B/cycle" << std::endl;
+
+#ifdef SIMMEM_MULTICHANNEL
+    tb->simmem_display_channel_counters();
+#else
+    // Fourth, the latencies are broken down into phases.
+    latency.display(opts.display_delays);
+#endif  // SIMMEM_MULTICHANNEL
+    tb->simmem_display_energy();
+  }
+
+#ifndef SIMMEM_MULTICHANNEL
+  // Fifth, the fixed-latency delay engine must meet its latencies.
+  if (DelayEngine == DELAY_ENGINE_FIXED) {
+    stats.num_fixed_lat_mismatches =
+        check_fixed_latencies(latency, opts.report);
+    if (opts.report) {
+      std::cout << "Fixed latency mismatches: " << std::dec
+                << stats.num_fixed_lat_mismatches << std::endl;
+    }
+  }
+#endif  // SIMMEM_MULTICHANNEL
+
+  prof.switch_to(simmem_prof::PHASE_OTHER);
+
+  stats.num_wrsp_mismatches = num_wrsp_mismatches;
+  stats.num_rdata_mismatches = num_rdata_mismatches;
+  stats.delivered_bytes = wbytes + rbytes;
+  stats.busy_cycles = state.num_busy_cycles;
+  return stats;
+}
+
+/**
+ * Reads a numeric plusarg, such as +seed=3.
+ *
+ * @param name The plusarg name, without the leading plus.
+ * @param default_val The value returned if the plusarg is absent.
+ */
+unsigned long get_plusarg(const std::string &name, unsigned long default_val) {
+  std::string match = Verilated::commandArgsPlusMatch((name + "=").c_str());
+  if (match.empty()) {
+    return default_val;
+  }
+  return strtoul(match.c_str() + name.size() + 2, NULL, 0);
+}
+
+/**
+ * Reads a string plusarg, such as +save=warm.ckpt.
+ *
+ * @param name The plusarg name, without the leading plus.
+ * @return The plusarg value, or an empty string if the plusarg is absent.
+ */
+std::string get_plusarg_str(const std::string &name) {
+  std::string match = Verilated::commandArgsPlusMatch((name + "=").c_str());
+  return match.empty() ? match : match.substr(name.size() + 2);
+}
+
+/**
+ * Checks whether a flag plusarg, such as +quiet, is present.
+ */
+bool has_plusarg(const std::string &name) {
+  return std::string(Verilated::commandArgsPlusMatch(name.c_str())) ==
+         "+" + name;
+}
+
+////////////////////////////////
+// Worst-case stimulus search //
+////////////////////////////////
+
+/**
+ * Scores a run for a worst-case objective. The higher the score, the worse the
+ * run.
+ *
+ * @param stats the statistics of the run
+ * @param objective the objective
+ *
+ * @return for the latency, the maximal delay of a transaction; for the
+ * throughput, the number of busy cycles per delivered byte, so that a run that
+ * never delivers its outstanding transactions scores worst.
+ */
+double fuzz_score(const EpisodeStats &stats,
+                  simmem_search::fuzz_objective_e objective) {
+  if (objective == simmem_search::FUZZ_LATENCY) {
+    return std::max(stats.wrsp_delay_max, stats.rdata_delay_max);
+  }
+  return (double)stats.busy_cycles / (stats.delivered_bytes + 1);
+}
+
+/**
+ * Runs the randomized testbench on a decoded stimulus, without any display.
+ *
+ * @param tb A pointer the the already contructed SimmemTestbench object.
+ * @param opts The options of the run.
+ * @param stimulus The bytes to decode the requester stimulus from.
+ *
+ * @return The statistics of the run.
+ */
+EpisodeStats run_stimulus(SimmemTestbench *tb, RandomizedTestOptions opts,
+                          const std::vector<uint8_t> &stimulus) {
+  simmem_occ::OccupancySampler disabled_sampler;
+  opts.stimulus = &stimulus;
+  opts.verbose = false;
+  opts.display_delays = false;
+  opts.report = false;
+  return randomized_testbench(tb, opts, disabled_sampler);
+}
+
+/**
+ * Searches for the stimulus that scores worst for an objective (see
+ * simmem_search::search_worst_stimulus), then replays the worst stimulus with
+ * the full report. A stimulus that produces response mismatches or a watchdog
+ * violation stops the search.
+ *
+ * @param tb A pointer the the already contructed SimmemTestbench object.
+ * @param opts The options of the runs. If opts.stimulus is set, the search
+ * starts from it, otherwise from random bytes.
+ * @param num_iterations The number of mutations to try.
+ * @param max_len The maximal length of the stimulus, in bytes.
+ * @param objective The objective.
+ * @param out_path The file where the worst stimulus is saved.
+ *
+ * @return 0, or 1 if a stimulus produced response mismatches or a watchdog
+ * violation.
+ */
+int fuzz_search(SimmemTestbench *tb, RandomizedTestOptions opts,
+                size_t num_iterations, size_t max_len,
+                simmem_search::fuzz_objective_e objective,
+                const std::string &out_path) {
+  auto run = [&](const std::vector<uint8_t> &stimulus)
+      -> simmem_search::RunOutcome {
+    EpisodeStats stats = run_stimulus(tb, opts, stimulus);
+    simmem_search::RunOutcome outcome;
+    outcome.failure = stats.num_mismatches()          ? "response mismatches"
+                      : stats.num_watchdog_violations ? "watchdog violation"
+                                                      : nullptr;
+    outcome.score = fuzz_score(stats, objective);
+    return outcome;
+  };
+  std::vector<uint8_t> worst;
+  if (simmem_search::search_worst_stimulus(run, opts.seed, opts.stimulus,
+                                           num_iterations, max_len, objective,
+                                           out_path, worst)) {
+    return 1;
+  }
+
+  // Replays the worst stimulus with the full report.
+  simmem_occ::OccupancySampler disabled_sampler;
+  opts.stimulus = &worst;
+  randomized_testbench(tb, opts, disabled_sampler);
+  return 0;
+}
+
+#ifdef SIMMEM_FUZZ
+// libFuzzer entry points (see the sim_simmem_top_fuzz target). Each input is
+// decoded as a stimulus (see StimulusDecoder) and run from reset. Besides the
+// code coverage of the model, the scores of the run are reported to libFuzzer
+// as extra coverage counters, so that the inputs reaching new score buckets
+// are kept in the corpus, and the search is driven towards the worst cases.
+// The worst input of each objective is saved as worst_<objective>.stim.
+
+// Number of cycles of each run, which must leave time to drain the
+// transactions of the longest inputs (see the -max_len option of libFuzzer).
+const size_t kFuzzCycles = 2000;
+
+// Number of score buckets per objective. The throughput score is scaled by
+// kFuzzThroughputScale before bucketing.
+const size_t kFuzzNumBuckets = 256;
+const double kFuzzThroughputScale = 16.;
+
+__attribute__((used, section("__libfuzzer_extra_counters"))) uint8_t
+    fuzz_extra_counters[simmem_search::NUM_FUZZ_OBJECTIVES][kFuzzNumBuckets];
+
+SimmemTestbench *fuzz_tb;
+double fuzz_worst_scores[simmem_search::NUM_FUZZ_OBJECTIVES];
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  Verilated::commandArgs(*argc, *argv);
+  fuzz_tb = new SimmemTestbench(false);
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  RandomizedTestOptions opts;
+  opts.num_cycles = kFuzzCycles;
+  EpisodeStats stats =
+      run_stimulus(fuzz_tb, opts, std::vector<uint8_t>(data, data + size));
+
+  if (stats.num_mismatches() || stats.num_watchdog_violations) {
+    // libFuzzer saves the input as a crash.
+    std::cerr << (stats.num_mismatches() ? "Response mismatches."
+                                         : "Watchdog violation.")
+              << std::endl;
+    abort();
+  }
+
+  for (size_t i = 0; i < simmem_search::NUM_FUZZ_OBJECTIVES; i++) {
+    double score = fuzz_score(stats, (simmem_search::fuzz_objective_e)i);
+    double bucket = i == simmem_search::FUZZ_THROUGHPUT
+                        ? score * kFuzzThroughputScale
+                        : score;
+    fuzz_extra_counters[i][std::min<size_t>(bucket, kFuzzNumBuckets - 1)] = 1;
+
+    if (score > fuzz_worst_scores[i]) {
+      fuzz_worst_scores[i] = score;
+      std::string path = std::string("worst_") +
+                         simmem_search::kFuzzObjectiveNames[i] + ".stim";
+      simmem_stim::write_stimulus(path,
+                                  std::vector<uint8_t>(data, data + size));
+      std::cerr << "Worst " << simmem_search::kFuzzObjectiveNames[i]
+                << " score: " << score << ", saved to " << path << std::endl;
+    }
+  }
+  return 0;
 }
+#endif  // SIMMEM_FUZZ
 
+#ifndef SIMMEM_FUZZ
 int main(int argc, char **argv, char **env) {
   Verilated::commandArgs(argc, argv);
   Verilated::traceEverOn(true);
 
-  SimmemTestbench *tb = new SimmemTestbench(true, "top.fst");
+  SimmemTestbench *tb = new SimmemTestbench(!has_plusarg("notrace"), "top.fst");
+  tb->set_legacy_clocking(has_plusarg("legacy_clocking"));
 
   if (kTestStrategy == MANUAL_TEST) {
     manual_testbench(tb);
   } else if (kTestStrategy == RANDOMIZED_TEST) {
-    randomized_testbench(tb, kNumIdentifiers, kSeed, kNumRandomTestSteps);
+    // Runs several episodes on the same model instance, with successive seeds.
+    size_t num_episodes = get_plusarg("episodes", 1);
+    EpisodeStats total_stats;
+
+    RandomizedTestOptions opts;
+    opts.num_ids = get_plusarg("ids", opts.num_ids);
+    opts.seed = get_plusarg("seed", opts.seed);
+    opts.num_cycles = get_plusarg("cycles", opts.num_cycles);
+    opts.warmup_cycles = get_plusarg("warmup", opts.warmup_cycles);
+    opts.waddr_prob = get_plusarg("waddr_prob", opts.waddr_prob);
+    opts.raddr_prob = get_plusarg("raddr_prob", opts.raddr_prob);
+    opts.wdata_prob = get_plusarg("wdata_prob", opts.wdata_prob);
+    std::string addr_pattern_name = get_plusarg_str("addr_pattern");
+    if (!addr_pattern_name.empty()) {
+      size_t i_pattern = 0;
+      while (i_pattern < NUM_ADDR_PATTERNS &&
+             addr_pattern_name != kAddrPatternNames[i_pattern]) {
+        i_pattern++;
+      }
+      if (i_pattern == NUM_ADDR_PATTERNS) {
+        std::cerr << "Unknown address pattern " << addr_pattern_name << "."
+                  << std::endl;
+        exit(1);
+      }
+      opts.addr_pattern = (addr_pattern_e)i_pattern;
+    }
+    opts.verbose = opts.verbose && !has_plusarg("quiet");
+    opts.save_path = get_plusarg_str("save");
+    opts.restore_path = get_plusarg_str("restore");
+    opts.reseed = has_plusarg("reseed");
+    opts.display_delays = !has_plusarg("brief");
+    opts.watchdog = !has_plusarg("nowatchdog");
+    opts.watchdog_bound = get_plusarg("watchdog", opts.watchdog_bound);
+
+    // Decodes the requester stimulus from a file given by +replay=<path>, for
+    // instance saved by the worst-case search.
+    std::vector<uint8_t> replay_stimulus;
+    std::string replay_path = get_plusarg_str("replay");
+    if (!replay_path.empty()) {
+      if (!simmem_stim::read_stimulus(replay_path, replay_stimulus)) {
+        std::cerr << "Cannot read the stimulus file " << replay_path << "."
+                  << std::endl;
+        exit(1);
+      }
+      opts.stimulus = &replay_stimulus;
+    }
+
+    // Searches for the worst-case stimulus for +fuzz=<n> iterations, if n is
+    // not zero, instead of running episodes.
+    size_t num_fuzz_iterations = get_plusarg("fuzz", 0);
+    if (num_fuzz_iterations) {
+      std::string objective_name = get_plusarg_str("fuzz_objective");
+      simmem_search::fuzz_objective_e objective = simmem_search::FUZZ_LATENCY;
+      if (objective_name ==
+          simmem_search::kFuzzObjectiveNames[simmem_search::FUZZ_THROUGHPUT]) {
+        objective = simmem_search::FUZZ_THROUGHPUT;
+      } else if (!objective_name.empty() &&
+                 objective_name != simmem_search::kFuzzObjectiveNames
+                                       [simmem_search::FUZZ_LATENCY]) {
+        std::cerr << "Unknown worst-case objective " << objective_name << "."
+                  << std::endl;
+        exit(1);
+      }
+      std::string out_path = get_plusarg_str("fuzz_out");
+      int ret = fuzz_search(tb, opts, num_fuzz_iterations,
+                            get_plusarg("fuzz_len", simmem_search::kFuzzLen),
+                            objective,
+                            out_path.empty() ? "worst.stim" : out_path);
+      delete tb;
+      exit(ret);
+    }
+
+    // Samples the occupancy every +occupancy=<n> cycles, if n is not zero.
+    simmem_occ::OccupancySampler sampler;
+    size_t occupancy_period = get_plusarg("occupancy", 0);
+    if (occupancy_period) {
+#ifdef SIMMEM_MULTICHANNEL
+      std::cerr << "The multi-channel design does not support occupancy "
+                   "sampling."
+                << std::endl;
+#else
+      std::string occupancy_path = get_plusarg_str("occupancy_csv");
+      sampler.open(occupancy_path.empty() ? "occupancy.csv" : occupancy_path,
+                   occupancy_period);
+#endif  // SIMMEM_MULTICHANNEL
+    }
+
+    unsigned int first_seed = opts.seed;
+    for (size_t episode = 0; episode < num_episodes; episode++) {
+      opts.seed = first_seed + episode;
+      if (num_episodes > 1) {
+        std::cout << "\n\n#### Episode " << std::dec << episode << " (seed "
+                  << opts.seed << ") ####" << std::endl;
+      }
+      sampler.set_episode(episode);
+      EpisodeStats stats = randomized_testbench(tb, opts, sampler);
+      total_stats.add(stats);
+      if (num_episodes > 1) {
+        std::ostringstream name;
+        name << "Episode " << episode << " (seed " << opts.seed << ")";
+        stats.display(name.str());
+      }
+    }
+    if (num_episodes > 1) {
+      std::cout << "\n\n#### Episodes ####" << std::endl;
+      total_stats.display("All episodes");
+    }
+    sampler.display();
+
+    if (total_stats.num_watchdog_violations) {
+      std::cout << "Testbench failed: watchdog violation." << std::endl;
+      delete tb;
+      exit(1);
+    }
+    if (total_stats.num_fixed_lat_mismatches) {
+      std::cout << "Testbench failed: fixed latency mismatch." << std::endl;
+      delete tb;
+      exit(1);
+    }
   }
 
+  simmem_prof::profiler().display();
   delete tb;
 
   std::cout << "Testbench complete!" << std::endl;
 
   exit(0);
 }
+#endif  // SIMMEM_FUZZ
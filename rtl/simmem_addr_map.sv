@@ -0,0 +1,73 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Address mapping for the simulated memory controller
+
+// The address mapping module decomposes a memory address into the identifiers used by the delay
+// calculator: the rank to which the address is assigned, and the row inside this rank. It is
+// purely combinatorial and is instantiated once per slot entry.
+//
+// An address is made of three fields: the column field (RowBufLenW bits), the rank field
+// ($clog2(NumRanks) bits, possibly empty) and the row field (all the remaining bits). The order of
+// the fields is given by the Scheme parameter:
+//  * ADDR_MAP_ROW_RANK_COL: {row, rank, column}. Consecutive rows are spread across the ranks.
+//  * ADDR_MAP_RANK_ROW_COL: {rank, row, column}. Each rank covers a contiguous address range.
+//  * ADDR_MAP_ROW_COL_RANK: {row, column, rank, beat offset}. Fine-grained interleaving,
+//    consecutive burst beats are spread across the ranks. The rank field is placed just above the
+//    offset of a byte in a beat (MaxBurstSizeField bits), which belongs to the column.
+//
+// XOR hashing: If XorHash is set, then the rank identifier is the rank field XORed with the least
+//  significant bits of the row field. This is the permutation-based interleaving scheme: addresses
+//  that share the rank field but map to different rows are spread across different ranks, which
+//  converts a part of the row conflicts into accesses to distinct row buffers. As the mapping
+//  remains a bijection, the row identifier is left untouched.
+//
+// The row identifier is zero-extended to RowIdWidth bits. It does not contain the rank bits, which
+// is fine as row identifiers are only compared between addresses of the same rank.
+
+module simmem_addr_map #(
+    // Must be a power of two.
+    parameter int unsigned NumRanks = 1,
+    parameter simmem_pkg::addr_map_e Scheme = simmem_pkg::ADDR_MAP_ROW_RANK_COL,
+    parameter bit XorHash = 1'b0,
+
+    localparam int unsigned NumRksW = NumRanks == 1 ? 1 : $clog2 (NumRanks)  // derived parameter
+) (
+    input  logic [simmem_pkg::GlobalMemCapaW-1:0] addr_i,
+    // The rank to which the address is assigned.
+    output logic [                   NumRksW-1:0] rank_id_o,
+    // The identifier of the row in the rank.
+    output logic [    simmem_pkg::RowIdWidth-1:0] row_id_o
+);
+
+  import simmem_pkg::*;
+
+  // Width of the rank field, zero if there is a single rank.
+  localparam int unsigned RankFieldW = $clog2(NumRanks);
+  localparam int unsigned RowFieldW = GlobalMemCapaW - RowBufLenW - RankFieldW;
+
+  // Positions of the least significant bit of the row and rank fields.
+  localparam int unsigned RowFieldLsb =
+      Scheme == ADDR_MAP_RANK_ROW_COL ? RowBufLenW : RowBufLenW + RankFieldW;
+  localparam int unsigned RankFieldLsb =
+      Scheme == ADDR_MAP_ROW_RANK_COL ? RowBufLenW :
+      Scheme == ADDR_MAP_RANK_ROW_COL ? RowBufLenW + RowFieldW : MaxBurstSizeField;
+
+  // The fields are extracted bit by bit, as the rank field may be empty.
+  always_comb begin
+    row_id_o = '0;
+    for (int unsigned i_bit = 0; i_bit < RowFieldW; i_bit = i_bit + 1) begin
+      row_id_o[i_bit] = addr_i[RowFieldLsb + i_bit];
+    end
+
+    rank_id_o = '0;
+    for (int unsigned i_bit = 0; i_bit < RankFieldW; i_bit = i_bit + 1) begin
+      rank_id_o[i_bit] = addr_i[RankFieldLsb + i_bit];
+      if (XorHash && i_bit < RowFieldW) begin
+        rank_id_o[i_bit] = rank_id_o[i_bit] ^ row_id_o[i_bit];
+      end
+    end
+  end
+
+endmodule
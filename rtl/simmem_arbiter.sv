@@ -0,0 +1,119 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Requester port arbiter for the simulated memory controller
+
+// The arbiter selects one of the NumPorts valid requests. The selection depends on the Mode
+// parameter:
+//  * ARB_ROUND_ROBIN: The first valid port, starting from the port following the last granted one.
+//  * ARB_WEIGHTED: Same as round-robin, but a port may be granted up to Weights[port] times in a
+//    row before the priority moves to the next port.
+//  * ARB_QOS: Only the valid ports with the highest AxQOS value are considered, and round-robin
+//    is applied among them.
+//
+// The grant is held while the selected request is valid but not accepted downstream, so the
+// arbitrated signals comply with the AXI handshake rules. The priority pointer is only updated on
+// downstream handshakes.
+
+module simmem_arbiter #(
+    parameter int unsigned NumPorts = 2,
+    parameter simmem_pkg::arb_mode_e Mode = simmem_pkg::ARB_ROUND_ROBIN,
+    // Only used in ARB_WEIGHTED mode. Each weight must be positive.
+    parameter logic [NumPorts-1:0][simmem_pkg::ArbWeightW-1:0] Weights = '{default: 1},
+
+    localparam int unsigned NumPortsW = NumPorts == 1 ? 1 : $clog2 (NumPorts)  // derived parameter
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    input logic [NumPorts-1:0] valid_i,
+    // Only used in ARB_QOS mode.
+    input logic [NumPorts-1:0][simmem_pkg::AxQoSWidth-1:0] qos_i,
+
+    // Downstream handshake
+    output logic valid_o,
+    input  logic ready_i,
+
+    // Index of the granted port, only meaningful if valid_o is set.
+    output logic [NumPortsW-1:0] gnt_idx_o
+);
+
+  import simmem_pkg::*;
+
+  // Priority pointer: the port considered first.
+  logic [NumPortsW-1:0] ptr_d, ptr_q;
+  // Number of consecutive grants to the port designated by the priority pointer.
+  logic [ArbWeightW-1:0] credit_d, credit_q;
+
+  // Held grant, if the last granted request has not been accepted yet.
+  logic hold_q;
+  logic [NumPortsW-1:0] hold_idx_q;
+
+  // Ports taking part in the arbitration.
+  logic [NumPorts-1:0] eligible;
+  logic [AxQoSWidth-1:0] max_qos;
+
+  // Arbitration result, if no grant is held.
+  logic [NumPortsW-1:0] arb_idx;
+
+  always_comb begin
+    max_qos = '0;
+    for (int unsigned i_port = 0; i_port < NumPorts; i_port = i_port + 1) begin
+      if (valid_i[i_port] && qos_i[i_port] > max_qos) begin
+        max_qos = qos_i[i_port];
+      end
+    end
+
+    for (int unsigned i_port = 0; i_port < NumPorts; i_port = i_port + 1) begin
+      eligible[i_port] = valid_i[i_port] && (Mode != ARB_QOS || qos_i[i_port] == max_qos);
+    end
+  end
+
+  always_comb begin
+    arb_idx = ptr_q;
+    // Iterate in reverse priority order, so that the highest-priority eligible port is kept.
+    for (int i_off = int'(NumPorts) - 1; i_off >= 0; i_off = i_off - 1) begin
+      if (eligible[(int'(ptr_q) + i_off) % NumPorts]) begin
+        arb_idx = NumPortsW'((int'(ptr_q) + i_off) % NumPorts);
+      end
+    end
+  end
+
+  assign gnt_idx_o = hold_q ? hold_idx_q : arb_idx;
+  assign valid_o = |valid_i;
+
+  // Priority pointer update
+  always_comb begin
+    logic [ArbWeightW-1:0] credit_next;
+
+    ptr_d = ptr_q;
+    credit_d = credit_q;
+    credit_next = (gnt_idx_o == ptr_q ? credit_q : '0) + ArbWeightW'(1);
+
+    if (valid_o && ready_i) begin
+      if (Mode == ARB_WEIGHTED && credit_next < Weights[gnt_idx_o]) begin
+        ptr_d = gnt_idx_o;
+        credit_d = credit_next;
+      end else begin
+        ptr_d = gnt_idx_o == NumPortsW'(NumPorts - 1) ? '0 : gnt_idx_o + NumPortsW'(1);
+        credit_d = '0;
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      ptr_q <= '0;
+      credit_q <= '0;
+      hold_q <= 1'b0;
+      hold_idx_q <= '0;
+    end else begin
+      ptr_q <= ptr_d;
+      credit_q <= credit_d;
+      hold_q <= valid_o && !ready_i;
+      hold_idx_q <= gnt_idx_o;
+    end
+  end
+
+endmodule
@@ -11,10 +11,13 @@
 // requests that do not have a write address yet. When the corresponding write address request comes
 // in, it is immediately transmitted to the delay calculator core, along with the corresponding
 // count of write data requests already (or concurrently) received.
+//
+// The delay engine behind the wrapper is selected by simmem_pkg::DelayEngine. All the engines share
+// the interface of simmem_delay_calculator_core, plus the runtime configuration port.
 
 module simmem_delay_calculator #(
-    // Must be a power of two, used for address interleaving
-    parameter int unsigned NumRanks = 1  // Must be one, as interleaving is not yet supported.
+    // Must be a power of two, used for address interleaving (see simmem_addr_map).
+    parameter int unsigned NumRanks = 1
 ) (
     input logic clk_i,
     input logic rst_ni,
@@ -62,7 +65,26 @@ module simmem_delay_calculator #(
 
     // Ready signals for the response banks
     output logic wrsp_bank_ready_o,
-    output logic rrsp_bank_ready_o
+    output logic rrsp_bank_ready_o,
+
+    // Configuration port (see the register map in simmem_pkg)
+    input logic                            cfg_valid_i,
+    input logic [simmem_pkg::CfgAddrW-1:0] cfg_addr_i,
+    input logic [simmem_pkg::CfgDataW-1:0] cfg_wdata_i,
+
+    // Performance counters, indexed by simmem_pkg::perf_cnt_e
+    output logic [simmem_pkg::PerfCntW-1:0] perf_cnts_o[simmem_pkg::NumPerfCnts],
+
+    // Debug outputs, only observed by the testbench (latency attribution): internal identifiers
+    // whose burst starts being served, and whose burst completes, in the current cycle. Their
+    // precise meaning depends on the delay engine.
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_issued_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_issued_mhot_o,
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_done_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_done_mhot_o,
+    // Valid bits of the write and read slots (occupancy sampling).
+    output logic [    simmem_pkg::NumWSlots-1:0] wslt_v_mhot_o,
+    output logic [    simmem_pkg::NumRSlots-1:0] rslt_v_mhot_o
 );
 
   import simmem_pkg::*;
@@ -135,29 +157,104 @@ module simmem_delay_calculator #(
     end
   end
 
-  simmem_delay_calculator_core #(
-      .NumRanks(NumRanks)
-  ) i_simmem_delay_calculator_core (
-      .clk_i                      (clk_i),
-      .rst_ni                     (rst_ni),
-      .waddr_iid_i                (waddr_iid_i),
-      .waddr_i                    (waddr_i),
-      .wdata_immediate_cnt_i      (wdata_immediate_cnt),
-      .waddr_valid_i              (waddr_valid_i),
-      .waddr_ready_o              (waddr_ready_o),
-      .wdata_valid_i              (core_wdata_valid_input),
-      .raddr_iid_i                (raddr_iid_i),
-      .raddr_i                    (raddr_i),
-      .raddr_valid_i              (raddr_valid_i),
-      .raddr_ready_o              (raddr_ready_o),
-      .wrsp_release_en_mhot_o     (wrsp_release_en_mhot_o),
-      .rdata_release_en_mhot_o    (rdata_release_en_mhot_o),
-      .wrsp_released_iid_onehot_i (wrsp_released_iid_onehot_i),
-      .rdata_released_iid_onehot_i(rdata_released_iid_onehot_i),
-      .wrsp_bank_ready_i          (wrsp_bank_ready_i),
-      .rrsp_bank_ready_i          (rrsp_bank_ready_i),
-      .wrsp_bank_ready_o          (wrsp_bank_ready_o),
-      .rrsp_bank_ready_o          (rrsp_bank_ready_o)
-  );
+  if (DelayEngine == DELAY_ENGINE_STAT) begin : gen_stat_engine
+    simmem_delay_calculator_stat i_simmem_delay_calculator_stat (
+        .clk_i                      (clk_i),
+        .rst_ni                     (rst_ni),
+        .waddr_iid_i                (waddr_iid_i),
+        .waddr_i                    (waddr_i),
+        .wdata_immediate_cnt_i      (wdata_immediate_cnt),
+        .waddr_valid_i              (waddr_valid_i),
+        .waddr_ready_o              (waddr_ready_o),
+        .wdata_valid_i              (core_wdata_valid_input),
+        .raddr_iid_i                (raddr_iid_i),
+        .raddr_i                    (raddr_i),
+        .raddr_valid_i              (raddr_valid_i),
+        .raddr_ready_o              (raddr_ready_o),
+        .wrsp_release_en_mhot_o     (wrsp_release_en_mhot_o),
+        .rdata_release_en_mhot_o    (rdata_release_en_mhot_o),
+        .wrsp_released_iid_onehot_i (wrsp_released_iid_onehot_i),
+        .rdata_released_iid_onehot_i(rdata_released_iid_onehot_i),
+        .wrsp_bank_ready_i          (wrsp_bank_ready_i),
+        .rrsp_bank_ready_i          (rrsp_bank_ready_i),
+        .wrsp_bank_ready_o          (wrsp_bank_ready_o),
+        .rrsp_bank_ready_o          (rrsp_bank_ready_o),
+        .cfg_valid_i                (cfg_valid_i),
+        .cfg_addr_i                 (cfg_addr_i),
+        .cfg_wdata_i                (cfg_wdata_i),
+        .perf_cnts_o                (perf_cnts_o),
+        .wrsp_issued_mhot_o         (wrsp_issued_mhot_o),
+        .rdata_issued_mhot_o        (rdata_issued_mhot_o),
+        .wrsp_done_mhot_o           (wrsp_done_mhot_o),
+        .rdata_done_mhot_o          (rdata_done_mhot_o),
+        .wslt_v_mhot_o              (wslt_v_mhot_o),
+        .rslt_v_mhot_o              (rslt_v_mhot_o)
+    );
+  end else if (DelayEngine == DELAY_ENGINE_FIXED) begin : gen_fixed_engine
+    simmem_delay_calculator_fixed i_simmem_delay_calculator_fixed (
+        .clk_i                      (clk_i),
+        .rst_ni                     (rst_ni),
+        .waddr_iid_i                (waddr_iid_i),
+        .waddr_i                    (waddr_i),
+        .wdata_immediate_cnt_i      (wdata_immediate_cnt),
+        .waddr_valid_i              (waddr_valid_i),
+        .waddr_ready_o              (waddr_ready_o),
+        .wdata_valid_i              (core_wdata_valid_input),
+        .raddr_iid_i                (raddr_iid_i),
+        .raddr_i                    (raddr_i),
+        .raddr_valid_i              (raddr_valid_i),
+        .raddr_ready_o              (raddr_ready_o),
+        .wrsp_release_en_mhot_o     (wrsp_release_en_mhot_o),
+        .rdata_release_en_mhot_o    (rdata_release_en_mhot_o),
+        .wrsp_released_iid_onehot_i (wrsp_released_iid_onehot_i),
+        .rdata_released_iid_onehot_i(rdata_released_iid_onehot_i),
+        .wrsp_bank_ready_i          (wrsp_bank_ready_i),
+        .rrsp_bank_ready_i          (rrsp_bank_ready_i),
+        .wrsp_bank_ready_o          (wrsp_bank_ready_o),
+        .rrsp_bank_ready_o          (rrsp_bank_ready_o),
+        .perf_cnts_o                (perf_cnts_o),
+        .wrsp_issued_mhot_o         (wrsp_issued_mhot_o),
+        .rdata_issued_mhot_o        (rdata_issued_mhot_o),
+        .wrsp_done_mhot_o           (wrsp_done_mhot_o),
+        .rdata_done_mhot_o          (rdata_done_mhot_o),
+        .wslt_v_mhot_o              (wslt_v_mhot_o),
+        .rslt_v_mhot_o              (rslt_v_mhot_o)
+    );
+  end else begin : gen_row_buf_engine
+    simmem_delay_calculator_core #(
+        .NumRanks(NumRanks)
+    ) i_simmem_delay_calculator_core (
+        .clk_i                      (clk_i),
+        .rst_ni                     (rst_ni),
+        .waddr_iid_i                (waddr_iid_i),
+        .waddr_i                    (waddr_i),
+        .wdata_immediate_cnt_i      (wdata_immediate_cnt),
+        .waddr_valid_i              (waddr_valid_i),
+        .waddr_ready_o              (waddr_ready_o),
+        .wdata_valid_i              (core_wdata_valid_input),
+        .raddr_iid_i                (raddr_iid_i),
+        .raddr_i                    (raddr_i),
+        .raddr_valid_i              (raddr_valid_i),
+        .raddr_ready_o              (raddr_ready_o),
+        .wrsp_release_en_mhot_o     (wrsp_release_en_mhot_o),
+        .rdata_release_en_mhot_o    (rdata_release_en_mhot_o),
+        .wrsp_released_iid_onehot_i (wrsp_released_iid_onehot_i),
+        .rdata_released_iid_onehot_i(rdata_released_iid_onehot_i),
+        .wrsp_bank_ready_i          (wrsp_bank_ready_i),
+        .rrsp_bank_ready_i          (rrsp_bank_ready_i),
+        .wrsp_bank_ready_o          (wrsp_bank_ready_o),
+        .rrsp_bank_ready_o          (rrsp_bank_ready_o),
+        .cfg_valid_i                (cfg_valid_i),
+        .cfg_addr_i                 (cfg_addr_i),
+        .cfg_wdata_i                (cfg_wdata_i),
+        .perf_cnts_o                (perf_cnts_o),
+        .wrsp_issued_mhot_o         (wrsp_issued_mhot_o),
+        .rdata_issued_mhot_o        (rdata_issued_mhot_o),
+        .wrsp_done_mhot_o           (wrsp_done_mhot_o),
+        .rdata_done_mhot_o          (rdata_done_mhot_o),
+        .wslt_v_mhot_o              (wslt_v_mhot_o),
+        .rslt_v_mhot_o              (rslt_v_mhot_o)
+    );
+  end
 
 endmodule
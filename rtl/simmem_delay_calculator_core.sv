@@ -60,23 +60,57 @@
 // than another write address request (or equivalently, write slot age), those are held in a
 // separate, smaller age matrix.
 //
-// Request cost: Three costs (measured in clock cycles) are supported by the delay calculator:
+// Request cost: Three costs (measured in memory clock cycles) are supported by the delay
+// calculator:
 // * Cost of row hit (RowHitCost): if the requested row was in the row buffer.
 // * Cost of activation + row hit (RowHitCost + ActivationCost): if no row was in the row buffer.
 // * Cost of precharge + activation + row hit (RowHitCost + ActivationCost + PrechargeCost): if
 //   another row was in the row buffer. DRAM refreshing is not simulated.
 //
+// Memory clock: The costs are converted to clk_i cycles using the fixed-point MemClkRatio. Each
+// rank holds the fractional part of its last delay, which is added to the next one, so the rank
+// timers do not drift from the memory time even if the clock ratio is not an integer. The
+// resulting delay is however never lower than 3 clk_i cycles (see the three-cycles-early mem_done
+// setting). A delay raised to this floor drops the carried fractional part, but the rank timer
+// still runs ahead of the memory time by the rest of the excess: delays shorter than 3 clk_i
+// cycles drift.
+//
+// Latency scaling: Before being loaded into a rank timer, each request cost is multiplied by the
+// runtime-programmable scale and increased by the runtime-programmable offset. The result saturates
+// at the maximal value, although DelayW is already sized for the maximal scale and offset.
+//
 // Cost categorization: As the entropy of the cost values is very low (takes only 3 values), they
 // are categorized on 2 bits to ease comparisons.
 //
-// Interleaving is not supported yet, but the basic structure to integrate interleaving is present:
-// candidate requests are split per rank. Additionally, relevant blocks are surrounded by `for
-// (genvar i_rk...` loops.
+// Row buffer policy: Depending on RowPolicy, the row of a rank is closed at the end of each access
+// (closed-page), after RowIdleTimeout idle memory cycles (adaptive), or only by a conflicting
+// access (open-page). In the adaptive policy, an optional per-rank 2-bit saturating predictor
+// learns whether the next access to the rank hits the last row, and closes the row right after the
+// access if it predicts a miss. Closing a row makes the next access cost C_ACT_CAS instead of
+// either C_CAS or C_PRECH_ACT_CAS.
+//
+// Inter-command constraints: The activations of all the ranks are spaced by at least ActToActCost
+// (tRRD), and at most 4 activations are issued in any FourActWindowCost window (tFAW). A read
+// access is issued at least WrToRdCost (tWTR) after the last write access, and conversely for
+// RdToWrCost (tRTW). The turnaround is measured from the issue of the access, not from the end of
+// its data burst, so within a rank it is absorbed by any access delay at least as long. The optimal
+// entry of an idle rank that would violate a constraint is not issued in the current cycle, and the
+// corresponding stall counter is incremented.
+//
+// Performance counters: Each time a rank starts treating a request, the emulated DRAM commands are
+// counted according to the request cost category: one column access (read or write) for C_CAS,
+// plus one activation for C_ACT_CAS, plus one precharge for C_PRECH_ACT_CAS. Additionally, the
+// number of rank-cycles with an open row and with no open row are counted, for background energy
+// estimation.
+//
+// Rank interleaving: Candidate requests are split per rank, and relevant blocks are surrounded by
+// `for (genvar i_rk...` loops. The rank and the row of each entry are given by the address mapping
+// module simmem_addr_map, which is instantiated once per slot entry.
 //
 
 module simmem_delay_calculator_core #(
     // NumRanks must be a power of two, used for address interleaving.
-    parameter int unsigned NumRanks = 1,  // Interleaving is not supported yet.
+    parameter int unsigned NumRanks = 1,
 
     localparam
         int unsigned NumRksW = NumRanks == 1 ? 1 : $clog2 (NumRanks)  // derived parameter
@@ -126,7 +160,25 @@ module simmem_delay_calculator_core #(
 
     // Ready signals for the response banks
     output logic wrsp_bank_ready_o,
-    output logic rrsp_bank_ready_o
+    output logic rrsp_bank_ready_o,
+
+    // Configuration port (see the register map in simmem_pkg)
+    input logic                            cfg_valid_i,
+    input logic [simmem_pkg::CfgAddrW-1:0] cfg_addr_i,
+    input logic [simmem_pkg::CfgDataW-1:0] cfg_wdata_i,
+
+    // Performance counters, indexed by simmem_pkg::perf_cnt_e
+    output logic [simmem_pkg::PerfCntW-1:0] perf_cnts_o[simmem_pkg::NumPerfCnts],
+
+    // Debug outputs, only observed by the testbench (latency attribution): internal identifiers
+    // whose burst has a memory request issued, and whose burst completes, in the current cycle.
+    output logic [simmem_pkg::WRspBankCapa-1:0] wrsp_issued_mhot_o,
+    output logic [ simmem_pkg::RDataBankCapa-1:0] rdata_issued_mhot_o,
+    output logic [simmem_pkg::WRspBankCapa-1:0] wrsp_done_mhot_o,
+    output logic [ simmem_pkg::RDataBankCapa-1:0] rdata_done_mhot_o,
+    // Debug outputs (occupancy sampling): valid bits of the write and read slots.
+    output logic [simmem_pkg::NumWSlots-1:0] wslt_v_mhot_o,
+    output logic [simmem_pkg::NumRSlots-1:0] rslt_v_mhot_o
 );
 
   import simmem_pkg::*;
@@ -153,19 +205,18 @@ module simmem_delay_calculator_core #(
   localparam int unsigned NumCostCatsW = $clog2(NumCostCats);
 
   /**
-  * Determines the cost of a request, depending on the requested address and the
+  * Determines the cost of a request, depending on the requested row and the
   * current status of the corresponding rank.
   *
-  * @param address the requested address.
+  * @param row_ident the identifier of the requested row, as given by the address mapping.
   * @param is_row_open 1'b1 iff a row is currently open in the corresponding rank.
-  * @param open_row_buf_ident the start address of the open row, if applicable.
+  * @param open_row_buf_ident the identifier of the open row, if applicable.
   * @return the cost category of the access, in clock cycles.
   */
   function automatic mem_cost_category_e det_cost_cat(
-      logic [GlobalMemCapaW-1:0] address, logic is_row_open,
+      logic [RowIdWidth-1:0] row_ident, logic is_row_open,
       logic [RowIdWidth-1:0] open_row_buf_ident);
-    if (is_row_open && address[GlobalMemCapaW-1:RowBufLenW] ==
-        open_row_buf_ident) begin
+    if (is_row_open && row_ident == open_row_buf_ident) begin
       return C_CAS;
     end else if (!is_row_open) begin
       return C_ACT_CAS;
@@ -174,23 +225,26 @@ module simmem_delay_calculator_core #(
     end
   endfunction : det_cost_cat
 
+  // Width of a delay in clk_i cycles, in fixed point with MemClkRatioFracW fractional bits.
+  localparam int unsigned DelayFixW = DelayW + MemClkRatioFracW;
+
   /**
   * Decategorizes a request cost to retrieve the actual value from its category.
   *
   * @param cost_category the cost category.
-  * @return the actual cost corresponding to this cost category.
+  * @return the actual cost corresponding to this cost category, in fixed-point clk_i cycles.
   */
-  function automatic logic [DelayW-1:0] decategorize_mem_cost(
+  function automatic logic [DelayFixW-1:0] decategorize_mem_cost(
       mem_cost_category_e cost_category);
     case (cost_category)
       C_CAS: begin
-        return DelayW'(RowHitCost);
+        return DelayFixW'(RowHitCost * MemClkRatio);
       end
       C_ACT_CAS: begin
-        return DelayW'(RowHitCost + ActivationCost);
+        return DelayFixW'((RowHitCost + ActivationCost) * MemClkRatio);
       end
       C_PRECH_ACT_CAS: begin
-        return DelayW'(RowHitCost + ActivationCost + PrechargeCost);
+        return DelayFixW'((RowHitCost + ActivationCost + PrechargeCost) * MemClkRatio);
       end
       default: begin  // COST_NO_CANDIDATE
         // If there is no candidate request for a given rank, then the corresponding counter remains
@@ -200,25 +254,50 @@ module simmem_delay_calculator_core #(
     endcase
   endfunction : decategorize_mem_cost
 
-  /////////////////////
-  // Rank assignment //
-  /////////////////////
+  // Width of a scaled delay, before saturation.
+  localparam int unsigned ScaledFixW = DelayFixW + LatScaleW;
 
   /**
-  * Determines to which rank a given address is assigned. It uses the least significant bits for
-  * interleaving. As NumRanks must be 1 as rank interleaving is currently not fully supported, it
-  * currently systematically returns 0.
+  * Scales a request cost and adds the offset and the carried fractional part, with saturation.
   *
-  * @param address the input address.
-  * @return the rank index to which the address is assigned.
+  * @param cost the request cost, in fixed-point clk_i cycles.
+  * @param frac the fractional part carried over from the previous delay of the rank.
+  * @param scale the latency scale, in fixed point with LatScaleFracW fractional bits.
+  * @param offset the latency offset, in clk_i cycles.
+  * @return the delay of the request, in fixed-point clk_i cycles.
   */
-  function automatic logic [NumRksW-1:0] get_assigned_rk_id(
-      logic [GlobalMemCapaW-1:0] address);
-    if (NumRanks == 1) begin
-      return 0;
+  function automatic logic [DelayFixW-1:0] scale_mem_cost(
+      logic [DelayFixW-1:0] cost, logic [MemClkRatioFracW-1:0] frac, logic [LatScaleW-1:0] scale,
+      logic [LatOffsetW-1:0] offset);
+    logic [ScaledFixW-1:0] scaled;
+    scaled = ((ScaledFixW'(cost) * ScaledFixW'(scale)) >> LatScaleFracW) +
+        (ScaledFixW'(offset) << MemClkRatioFracW) + ScaledFixW'(frac);
+    if (scaled > ScaledFixW'({DelayFixW{1'b1}})) begin
+      return '1;
     end
-    return address[NumRksW - 1:0];
-  endfunction : get_assigned_rk_id
+    return DelayFixW'(scaled);
+  endfunction : scale_mem_cost
+
+  ///////////////////////////////
+  // Latency scaling registers //
+  ///////////////////////////////
+
+  logic [LatScaleW-1:0] lat_scale_q;
+  logic [LatOffsetW-1:0] lat_offset_q;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      lat_scale_q <= LatScaleW'(1 << LatScaleFracW);
+      lat_offset_q <= '0;
+    end else if (cfg_valid_i) begin
+      if (cfg_addr_i == CfgLatScale) begin
+        lat_scale_q <= cfg_wdata_i[LatScaleW-1:0];
+      end
+      if (cfg_addr_i == CfgLatOffset) begin
+        lat_offset_q <= cfg_wdata_i[LatOffsetW-1:0];
+      end
+    end
+  end
 
   ///////////////////////////////////////////
   // Slot constants, types and declaration //
@@ -277,9 +356,9 @@ module simmem_delay_calculator_core #(
               // And the memory operation has not been performed yet
               ~wslt_q[i_slt].mem_done[i_bit] &
               // And the address corresponds to the right rank
-              NumRksW'(i_rk) == get_assigned_rk_id(slt_waddrs[i_slt][i_bit]) &
+              NumRksW'(i_rk) == slt_wrk_ids[i_slt][i_bit] &
               // And the address yields the right cost.
-              det_cost_cat(slt_waddrs[i_slt][i_bit], is_row_open_q[i_rk], row_buf_ident_q[i_rk])
+              det_cost_cat(slt_wrow_ids[i_slt][i_bit], is_row_open_q[i_rk], row_buf_ident_q[i_rk])
               == NumCostCatsW'(i_cat);
         end : candidates_w_bit
       end : candidates_w_inner
@@ -289,8 +368,8 @@ module simmem_delay_calculator_core #(
           // slots and replaced by the slot .v signal.
           assign is_rdata_cand_cat_mhot[i_rk][i_cat][i_slt][i_bit] = rslt_q[i_slt].v &
           ~rslt_q[i_slt].mem_pending[i_bit] & ~rslt_q[i_slt].mem_done[i_bit] &
-          NumRksW'(i_rk) == get_assigned_rk_id(slt_raddrs[i_slt][i_bit]) &
-          det_cost_cat(slt_raddrs[i_slt][i_bit], is_row_open_q[i_rk], row_buf_ident_q[i_rk]) ==
+          NumRksW'(i_rk) == slt_rrk_ids[i_slt][i_bit] &
+          det_cost_cat(slt_rrow_ids[i_slt][i_bit], is_row_open_q[i_rk], row_buf_ident_q[i_rk]) ==
           NumCostCatsW'(i_cat);
         end : candidates_r_bit
       end : candidates_r_inner
@@ -575,35 +654,35 @@ module simmem_delay_calculator_core #(
         {MainAgeMatrixSide{~|oldest_entry_of_category[i_rk][C_ACT_CAS]}});
   end
 
-  // Find the row buffer index (the RowIdWidth MSBs) of the optimal entry. The LSBs below this are
-  // not regarded, as they map to addresses inside the row.
+  // Find the row buffer identifier of the optimal entry, as given by the address mapping.
   logic [RowIdWidth-1:0][MaxNumWEntries+MaxNumREntries-1:0] opti_rbuf_interm[NumRanks];
   logic [RowIdWidth-1:0] opti_rbuf[NumRanks];
 
   for (genvar i_rk = 0; i_rk < NumRanks; i_rk = i_rk + 1) begin : opti_rbuf_rk
     // The row buffer identifier is obtained bit by bit.
-    for (genvar i_rbb = RowBufLenW; i_rbb < GlobalMemCapaW; i_rbb = i_rbb + 1) begin : opti_rbuf_rbb
+    for (genvar i_rbb = 0; i_rbb < RowIdWidth; i_rbb = i_rbb + 1) begin : opti_rbuf_rbb
       // For write entries
       for (genvar i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin : opti_rbuf_wslt
         for (genvar i_bit = 0; i_bit < MaxBurstEffLen; i_bit = i_bit + 1) begin : opti_rbuf_wd
-          // Take the address bit of a write data entry if it is the optimal entry.
-          assign opti_rbuf_interm[i_rk][i_rbb-RowBufLenW][i_slt*MaxBurstEffLen + i_bit] =
-              opti_entry_onehot[i_rk][i_slt*MaxBurstEffLen + i_bit] & slt_waddrs[i_slt][i_bit][i_rbb];
+          // Take the row identifier bit of a write data entry if it is the optimal entry.
+          assign opti_rbuf_interm[i_rk][i_rbb][i_slt*MaxBurstEffLen + i_bit] =
+              opti_entry_onehot[i_rk][i_slt*MaxBurstEffLen + i_bit] &
+              slt_wrow_ids[i_slt][i_bit][i_rbb];
         end : opti_rbuf_wd
       end : opti_rbuf_wslt
       // For read entries
       for (genvar i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin : opti_rbuf_rslt
         for (genvar i_bit = 0; i_bit < MaxBurstEffLen; i_bit = i_bit + 1) begin : opti_rbuf_rslt_bit
-          // Take the address bit of a read data entry if its slot is the optimal entry according to
-          // the main age matrix, and if the current entry is the optimal in the slot.
-          assign opti_rbuf_interm[i_rk][i_rbb-RowBufLenW][MAgeMRSltStart+i_slt*MaxBurstEffLen+i_bit] =
+          // Take the row identifier bit of a read data entry if its slot is the optimal entry
+          // according to the main age matrix, and if the current entry is the optimal in the slot.
+          assign opti_rbuf_interm[i_rk][i_rbb][MAgeMRSltStart+i_slt*MaxBurstEffLen+i_bit] =
               opti_entry_onehot[i_rk][MAgeMRSltStart+i_slt] &
-              slt_nxt_data_onehot[i_rk][i_slt][i_bit] & slt_raddrs[i_slt][i_bit][i_rbb];
+              slt_nxt_data_onehot[i_rk][i_slt][i_bit] & slt_rrow_ids[i_slt][i_bit][i_rbb];
         end : opti_rbuf_rslt_bit
       end : opti_rbuf_rslt
 
       // Aggregate the bit for all the entries.
-      assign opti_rbuf[i_rk][i_rbb-RowBufLenW] = |opti_rbuf_interm[i_rk][i_rbb-RowBufLenW];
+      assign opti_rbuf[i_rk][i_rbb] = |opti_rbuf_interm[i_rk][i_rbb];
     end : opti_rbuf_rbb
   end : opti_rbuf_rk
 
@@ -705,6 +784,46 @@ module simmem_delay_calculator_core #(
     end : gen_raddrs
   end : gen_raddrs_perslt
 
+  /////////////////////
+  // Address mapping //
+  /////////////////////
+
+  // In this part, the rank and the row identifier of each write and read slot entry are determined
+  // from the entry addresses.
+
+  logic [NumRksW-1:0] slt_wrk_ids[NumWSlots][MaxBurstEffLen];
+  logic [NumRksW-1:0] slt_rrk_ids[NumRSlots][MaxBurstEffLen];
+  logic [RowIdWidth-1:0] slt_wrow_ids[NumWSlots][MaxBurstEffLen];
+  logic [RowIdWidth-1:0] slt_rrow_ids[NumRSlots][MaxBurstEffLen];
+
+  for (genvar i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin : gen_wmap_perslt
+    for (genvar i_bit = 0; i_bit < MaxBurstEffLen; i_bit = i_bit + 1) begin : gen_wmap
+      simmem_addr_map #(
+          .NumRanks(NumRanks),
+          .Scheme  (AddrMapScheme),
+          .XorHash (AddrMapXorHash)
+      ) i_simmem_addr_map (
+          .addr_i   (slt_waddrs[i_slt][i_bit]),
+          .rank_id_o(slt_wrk_ids[i_slt][i_bit]),
+          .row_id_o (slt_wrow_ids[i_slt][i_bit])
+      );
+    end : gen_wmap
+  end : gen_wmap_perslt
+
+  for (genvar i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin : gen_rmap_perslt
+    for (genvar i_bit = 0; i_bit < MaxBurstEffLen; i_bit = i_bit + 1) begin : gen_rmap
+      simmem_addr_map #(
+          .NumRanks(NumRanks),
+          .Scheme  (AddrMapScheme),
+          .XorHash (AddrMapXorHash)
+      ) i_simmem_addr_map (
+          .addr_i   (slt_raddrs[i_slt][i_bit]),
+          .rank_id_o(slt_rrk_ids[i_slt][i_bit]),
+          .row_id_o (slt_rrow_ids[i_slt][i_bit])
+      );
+    end : gen_rmap
+  end : gen_rmap_perslt
+
   //////////////////
   // Rank signals //
   //////////////////
@@ -727,6 +846,173 @@ module simmem_delay_calculator_core #(
   logic [DelayW-1:0] rank_delay_cnt_d[NumRanks];
   logic [DelayW-1:0] rank_delay_cnt_q[NumRanks];
 
+  // Number of consecutive idle cycles with an open row, for the adaptive row buffer policy. The
+  // timeout is converted to clk_i cycles, rounded up, and is at least one cycle.
+  localparam int unsigned RowIdleTimeoutRaw =
+      (RowIdleTimeout * MemClkRatio + (1 << MemClkRatioFracW) - 1) >> MemClkRatioFracW;
+  localparam int unsigned RowIdleDelay = RowIdleTimeoutRaw == 0 ? 1 : RowIdleTimeoutRaw;
+  localparam int unsigned RowIdleCntW = $clog2(RowIdleDelay + 1);
+  logic [RowIdleCntW-1:0] rank_idle_cnt_d[NumRanks];
+  logic [RowIdleCntW-1:0] rank_idle_cnt_q[NumRanks];
+
+  // Row hit predictor for the adaptive row buffer policy. The MSB is set iff the next access is
+  // predicted to hit the last accessed row.
+  logic [1:0] row_pred_d[NumRanks];
+  logic [1:0] row_pred_q[NumRanks];
+
+  // Set when the row buffer policy closes the row of a rank.
+  logic rank_policy_close[NumRanks];
+
+  // Fractional part of the last delay of the rank, in clk_i cycles, carried over to the next one.
+  logic [MemClkRatioFracW-1:0] rank_delay_frac_d[NumRanks];
+  logic [MemClkRatioFracW-1:0] rank_delay_frac_q[NumRanks];
+  // Delay of the next request of the rank, scaled and including the carried fractional part.
+  logic [DelayFixW-1:0] rank_delay_fix[NumRanks];
+
+  ///////////////////////////////
+  // Inter-command constraints //
+  ///////////////////////////////
+
+  // Constraint delays in clk_i cycles, rounded up. A zero delay disables the constraint.
+  localparam int unsigned ActToActDelay =
+      (ActToActCost * MemClkRatio + (1 << MemClkRatioFracW) - 1) >> MemClkRatioFracW;
+  localparam int unsigned FourActWindowDelay =
+      (FourActWindowCost * MemClkRatio + (1 << MemClkRatioFracW) - 1) >> MemClkRatioFracW;
+  localparam int unsigned WrToRdDelay =
+      (WrToRdCost * MemClkRatio + (1 << MemClkRatioFracW) - 1) >> MemClkRatioFracW;
+  localparam int unsigned RdToWrDelay =
+      (RdToWrCost * MemClkRatio + (1 << MemClkRatioFracW) - 1) >> MemClkRatioFracW;
+
+  localparam int unsigned ActDelayMax =
+      ActToActDelay > FourActWindowDelay ? ActToActDelay : FourActWindowDelay;
+  localparam int unsigned TurnDelayMax = WrToRdDelay > RdToWrDelay ? WrToRdDelay : RdToWrDelay;
+  localparam int unsigned ConstrCntW =
+      $clog2((ActDelayMax > TurnDelayMax ? ActDelayMax : TurnDelayMax) + 2);
+
+  // Number of activations in a tFAW window.
+  localparam int unsigned NumFawActs = 4;
+
+  // Decreasing counters, which are zero iff the corresponding command is allowed. There is one tFAW
+  // counter per activation in the window.
+  logic [ConstrCntW-1:0] act_gap_cnt_d, act_gap_cnt_q;
+  logic [ConstrCntW-1:0] faw_cnt_d[NumFawActs];
+  logic [ConstrCntW-1:0] faw_cnt_q[NumFawActs];
+  logic [ConstrCntW-1:0] wr_to_rd_cnt_d, wr_to_rd_cnt_q;
+  logic [ConstrCntW-1:0] rd_to_wr_cnt_d, rd_to_wr_cnt_q;
+
+  // Properties of the optimal entry of each rank.
+  logic opti_is_write[NumRanks];
+  logic opti_needs_act[NumRanks];
+
+  // Constraints stalling the optimal entry of each rank in the current cycle.
+  logic rank_stall_rrd[NumRanks];
+  logic rank_stall_faw[NumRanks];
+  logic rank_stall_wtr[NumRanks];
+  logic rank_stall_rtw[NumRanks];
+
+  // Cost category and one-hot entry issued by each rank in the current cycle. They are identical to
+  // the optimal ones, except that a stalled rank issues nothing (COST_NO_CANDIDATE).
+  mem_cost_category_e issue_cost_cat[NumRanks];
+  logic [MainAgeMatrixSide-1:0] issue_entry_onehot[NumRanks];
+
+  // The ranks are considered in increasing index order, so that the commands issued by the lower
+  // ranks in the current cycle are taken into account by the higher ranks.
+  always_comb begin
+    logic act_issued;
+    logic wr_issued;
+    logic rd_issued;
+    logic faw_claimed;
+    logic [NumFawActs-1:0] faw_free;
+
+    act_issued = 1'b0;
+    wr_issued = 1'b0;
+    rd_issued = 1'b0;
+
+    act_gap_cnt_d = act_gap_cnt_q == '0 ? '0 : act_gap_cnt_q - 1;
+    wr_to_rd_cnt_d = wr_to_rd_cnt_q == '0 ? '0 : wr_to_rd_cnt_q - 1;
+    rd_to_wr_cnt_d = rd_to_wr_cnt_q == '0 ? '0 : rd_to_wr_cnt_q - 1;
+    for (int unsigned i_act = 0; i_act < NumFawActs; i_act = i_act + 1) begin
+      faw_cnt_d[i_act] = faw_cnt_q[i_act] == '0 ? '0 : faw_cnt_q[i_act] - 1;
+      faw_free[i_act] = faw_cnt_q[i_act] == '0;
+    end
+
+    for (int unsigned i_rk = 0; i_rk < NumRanks; i_rk = i_rk + 1) begin
+      opti_is_write[i_rk] = |opti_entry_onehot[i_rk][MAgeMRSltStart-1:0];
+      opti_needs_act[i_rk] =
+          opti_cost_cat[i_rk] == C_ACT_CAS || opti_cost_cat[i_rk] == C_PRECH_ACT_CAS;
+
+      rank_stall_rrd[i_rk] = 1'b0;
+      rank_stall_faw[i_rk] = 1'b0;
+      rank_stall_wtr[i_rk] = 1'b0;
+      rank_stall_rtw[i_rk] = 1'b0;
+
+      if (rank_delay_cnt_q[i_rk] == '0 && opti_cost_cat[i_rk] != COST_NO_CANDIDATE) begin
+        if (opti_needs_act[i_rk]) begin
+          rank_stall_rrd[i_rk] = ActToActDelay != 0 && (act_issued || act_gap_cnt_q != '0);
+          rank_stall_faw[i_rk] = FourActWindowDelay != 0 && ~|faw_free;
+        end
+        if (opti_is_write[i_rk]) begin
+          rank_stall_rtw[i_rk] = RdToWrDelay != 0 && (rd_issued || rd_to_wr_cnt_q != '0);
+        end else begin
+          rank_stall_wtr[i_rk] = WrToRdDelay != 0 && (wr_issued || wr_to_rd_cnt_q != '0);
+        end
+      end
+
+      if (rank_stall_rrd[i_rk] || rank_stall_faw[i_rk] || rank_stall_wtr[i_rk] ||
+          rank_stall_rtw[i_rk]) begin
+        issue_cost_cat[i_rk] = COST_NO_CANDIDATE;
+        issue_entry_onehot[i_rk] = '0;
+      end else begin
+        issue_cost_cat[i_rk] = opti_cost_cat[i_rk];
+        issue_entry_onehot[i_rk] = opti_entry_onehot[i_rk];
+      end
+
+      // Update the constraint counters if the rank issues a command.
+      if (rank_delay_cnt_q[i_rk] == '0 && issue_cost_cat[i_rk] != COST_NO_CANDIDATE) begin
+        if (opti_needs_act[i_rk]) begin
+          act_issued = 1'b1;
+          if (ActToActDelay != 0) begin
+            act_gap_cnt_d = ConstrCntW'(ActToActDelay - 1);
+          end
+          // Occupy one of the free tFAW counters.
+          faw_claimed = 1'b0;
+          for (int unsigned i_act = 0; i_act < NumFawActs; i_act = i_act + 1) begin
+            if (FourActWindowDelay != 0 && faw_free[i_act] && !faw_claimed) begin
+              faw_cnt_d[i_act] = ConstrCntW'(FourActWindowDelay - 1);
+              faw_free[i_act] = 1'b0;
+              faw_claimed = 1'b1;
+            end
+          end
+        end
+        if (opti_is_write[i_rk]) begin
+          wr_issued = 1'b1;
+          if (WrToRdDelay != 0) begin
+            wr_to_rd_cnt_d = ConstrCntW'(WrToRdDelay - 1);
+          end
+        end else begin
+          rd_issued = 1'b1;
+          if (RdToWrDelay != 0) begin
+            rd_to_wr_cnt_d = ConstrCntW'(RdToWrDelay - 1);
+          end
+        end
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      act_gap_cnt_q <= '0;
+      faw_cnt_q <= '{default: '0};
+      wr_to_rd_cnt_q <= '0;
+      rd_to_wr_cnt_q <= '0;
+    end else begin
+      act_gap_cnt_q <= act_gap_cnt_d;
+      faw_cnt_q <= faw_cnt_d;
+      wr_to_rd_cnt_q <= wr_to_rd_cnt_d;
+      rd_to_wr_cnt_q <= rd_to_wr_cnt_d;
+    end
+  end
+
   /////////////
   // Outputs //
   /////////////
@@ -756,6 +1042,9 @@ module simmem_delay_calculator_core #(
     for (int unsigned i_rk = 0; i_rk < NumRanks; i_rk = i_rk + 1) begin
       is_row_open_d[i_rk] = is_row_open_q[i_rk];
       row_buf_ident_d[i_rk] = row_buf_ident_q[i_rk];
+      rank_delay_frac_d[i_rk] = rank_delay_frac_q[i_rk];
+      rank_idle_cnt_d[i_rk] = rank_idle_cnt_q[i_rk];
+      row_pred_d[i_rk] = row_pred_q[i_rk];
     end
 
     wrsp_release_en_mhot_d = wrsp_release_en_mhot_o;
@@ -885,29 +1174,73 @@ module simmem_delay_calculator_core #(
     // This part is dedicated to updating the rank counters and row state signals.
 
     for (int unsigned i_rk = 0; i_rk < NumRanks; i_rk = i_rk + 1) begin
+      rank_delay_fix[i_rk] = '0;
+      rank_policy_close[i_rk] = 1'b0;
+
       // If the rank counter is not zero, then decrement it.
       if (rank_delay_cnt_q[i_rk] != 0) begin
         // A row is now open in the corresponding rank.
         is_row_open_d[i_rk] = 1'b1;
+        rank_idle_cnt_d[i_rk] = '0;
 
         rank_delay_cnt_d[i_rk] = rank_delay_cnt_q[i_rk] - 1;
+
+        // Auto-precharge at the end of the access, for the closed-page policy, or if the predictor
+        // of the adaptive policy expects the next access to miss the row.
+        if (rank_delay_cnt_q[i_rk] == 1 && (RowPolicy == ROW_POLICY_CLOSED ||
+            (RowPolicy == ROW_POLICY_ADAPTIVE && RowPolicyPredictor && !row_pred_q[i_rk][1]))) begin
+          is_row_open_d[i_rk] = 1'b0;
+          rank_policy_close[i_rk] = 1'b1;
+        end
       end else begin
         // The case where rank_delay_cnt_q has to remain zero is treated through COST_NO_CANDIDATE.
-        rank_delay_cnt_d[i_rk] = decategorize_mem_cost(opti_cost_cat[i_rk]);
+        rank_delay_fix[i_rk] = scale_mem_cost(decategorize_mem_cost(issue_cost_cat[i_rk]),
+            rank_delay_frac_q[i_rk], lat_scale_q, lat_offset_q);
+        if (issue_cost_cat[i_rk] == COST_NO_CANDIDATE) begin
+          rank_delay_cnt_d[i_rk] = '0;
+        end else begin
+          // Keep the integer part, which must be at least 3, and carry the fractional part over.
+          // If the floor applies, then it already exceeds the fractional part, which is dropped.
+          rank_delay_cnt_d[i_rk] = DelayW'(rank_delay_fix[i_rk] >> MemClkRatioFracW);
+          rank_delay_frac_d[i_rk] = rank_delay_fix[i_rk][MemClkRatioFracW-1:0];
+          if (rank_delay_cnt_d[i_rk] < DelayW'(3)) begin
+            rank_delay_cnt_d[i_rk] = DelayW'(3);
+            rank_delay_frac_d[i_rk] = '0;
+          end
+        end
 
         // Set the memory pending bit in the case of a write data entry.
         for (int unsigned i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin
-          wslt_d[i_slt].mem_pending |= opti_entry_onehot[i_rk][i_slt*MaxBurstEffLen +: MaxBurstEffLen];
+          wslt_d[i_slt].mem_pending |= issue_entry_onehot[i_rk][i_slt*MaxBurstEffLen +: MaxBurstEffLen];
         end
         // Set the memory pending bit in the case of a read data entry.
         for (int unsigned i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin
           rslt_d[i_slt].mem_pending |=
-              {MaxBurstEffLen{opti_entry_onehot[i_rk][MAgeMRSltStart+i_slt]}} &
+              {MaxBurstEffLen{issue_entry_onehot[i_rk][MAgeMRSltStart+i_slt]}} &
                   slt_nxt_data_onehot[i_rk][i_slt];
         end
 
-        // Update the row start address.
-        row_buf_ident_d[i_rk] = opti_rbuf[i_rk];
+        if (issue_cost_cat[i_rk] != COST_NO_CANDIDATE) begin
+          // Train the predictor: would the access hit the last row if it had been kept open?
+          if (opti_rbuf[i_rk] == row_buf_ident_q[i_rk]) begin
+            row_pred_d[i_rk] = row_pred_q[i_rk] == 2'b11 ? 2'b11 : row_pred_q[i_rk] + 2'b01;
+          end else begin
+            row_pred_d[i_rk] = row_pred_q[i_rk] == 2'b00 ? 2'b00 : row_pred_q[i_rk] - 2'b01;
+          end
+
+          // Update the row start address. It is kept during idle cycles, as the row remains open.
+          row_buf_ident_d[i_rk] = opti_rbuf[i_rk];
+        end else if (RowPolicy == ROW_POLICY_ADAPTIVE && is_row_open_q[i_rk] &&
+                     opti_cost_cat[i_rk] == COST_NO_CANDIDATE) begin
+          // Close the row after RowIdleDelay idle cycles. A stalled rank is not idle.
+          if (rank_idle_cnt_q[i_rk] == RowIdleCntW'(RowIdleDelay - 1)) begin
+            is_row_open_d[i_rk] = 1'b0;
+            rank_policy_close[i_rk] = 1'b1;
+            rank_idle_cnt_d[i_rk] = '0;
+          end else begin
+            rank_idle_cnt_d[i_rk] = rank_idle_cnt_q[i_rk] + RowIdleCntW'(1);
+          end
+        end
       end
     end
 
@@ -931,10 +1264,10 @@ module simmem_delay_calculator_core #(
             // Mark memory operation done if already done, or was pending.
             wslt_d[i_slt].mem_done[i_bit] = wslt_d[i_slt].mem_done[i_bit] |
                 (wslt_q[i_slt].mem_pending[i_bit] &
-                (get_assigned_rk_id(slt_waddrs[i_slt][i_bit])==NumRksW'(i_rk)));
+                (slt_wrk_ids[i_slt][i_bit] == NumRksW'(i_rk)));
             // Unset the potential corresponding memory pending bit.
             wslt_d[i_slt].mem_pending[i_bit] = wslt_d[i_slt].mem_pending[i_bit] &
-                get_assigned_rk_id(slt_waddrs[i_slt][i_bit])!=NumRksW'(i_rk);
+                slt_wrk_ids[i_slt][i_bit] != NumRksW'(i_rk);
           end
         end
         for (int unsigned i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin
@@ -942,10 +1275,10 @@ module simmem_delay_calculator_core #(
             // Mark memory operation done if already done, or was pending.
             rslt_d[i_slt].mem_done[i_bit] = rslt_d[i_slt].mem_done[i_bit] |
                 (rslt_q[i_slt].mem_pending[i_bit] &
-                (get_assigned_rk_id(slt_raddrs[i_slt][i_bit])==NumRksW'(i_rk)));
+                (slt_rrk_ids[i_slt][i_bit] == NumRksW'(i_rk)));
             // Unset the potential corresponding memory pending bit.
             rslt_d[i_slt].mem_pending[i_bit] = rslt_d[i_slt].mem_pending[i_bit] &
-                get_assigned_rk_id(slt_raddrs[i_slt][i_bit])!=NumRksW'(i_rk);
+                slt_rrk_ids[i_slt][i_bit] != NumRksW'(i_rk);
           end
         end
       end
@@ -1006,6 +1339,114 @@ module simmem_delay_calculator_core #(
     end
   end
 
+  ///////////////////
+  // Debug outputs //
+  ///////////////////
+
+  for (genvar i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin : gen_wslt_v
+    assign wslt_v_mhot_o[i_slt] = wslt_q[i_slt].v;
+  end : gen_wslt_v
+  for (genvar i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin : gen_rslt_v
+    assign rslt_v_mhot_o[i_slt] = rslt_q[i_slt].v;
+  end : gen_rslt_v
+
+  // A burst is issued in the cycles where one of its entries is issued to a rank, and it completes
+  // in the cycle where its slot is freed.
+  always_comb begin
+    wrsp_issued_mhot_o = '0;
+    rdata_issued_mhot_o = '0;
+    wrsp_done_mhot_o = '0;
+    rdata_done_mhot_o = '0;
+
+    for (int unsigned i_rk = 0; i_rk < NumRanks; i_rk = i_rk + 1) begin
+      if (rank_delay_cnt_q[i_rk] == '0) begin
+        for (int unsigned i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin
+          if (wslt_q[i_slt].v &&
+              |issue_entry_onehot[i_rk][i_slt*MaxBurstEffLen +: MaxBurstEffLen]) begin
+            wrsp_issued_mhot_o[wslt_q[i_slt].iid] = 1'b1;
+          end
+        end
+        for (int unsigned i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin
+          if (rslt_q[i_slt].v && issue_entry_onehot[i_rk][MAgeMRSltStart+i_slt]) begin
+            rdata_issued_mhot_o[rslt_q[i_slt].iid] = 1'b1;
+          end
+        end
+      end
+    end
+
+    for (int unsigned i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin
+      if (wslt_q[i_slt].v && &wslt_q[i_slt].mem_done) begin
+        wrsp_done_mhot_o[wslt_q[i_slt].iid] = 1'b1;
+      end
+    end
+    for (int unsigned i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin
+      if (rslt_q[i_slt].v && &rslt_q[i_slt].mem_done) begin
+        rdata_done_mhot_o[rslt_q[i_slt].iid] = 1'b1;
+      end
+    end
+  end
+
+  //////////////////////////
+  // Performance counters //
+  //////////////////////////
+
+  // Number of commands, stalls and standby rank-cycles in the current cycle.
+  logic [NumRksW:0] perf_cnt_incr[NumPerfCnts];
+
+  always_comb begin
+    perf_cnt_incr = '{default: '0};
+
+    for (int unsigned i_rk = 0; i_rk < NumRanks; i_rk = i_rk + 1) begin
+      if (rank_delay_cnt_q[i_rk] == 0 && issue_cost_cat[i_rk] != COST_NO_CANDIDATE) begin
+        // Column access: the optimal entry is either a write data entry or a read slot.
+        if (opti_is_write[i_rk]) begin
+          perf_cnt_incr[PERF_CNT_WR_CAS] += 1;
+        end else begin
+          perf_cnt_incr[PERF_CNT_RD_CAS] += 1;
+        end
+        if (issue_cost_cat[i_rk] != C_CAS) begin
+          perf_cnt_incr[PERF_CNT_ACT] += 1;
+        end
+        if (issue_cost_cat[i_rk] == C_PRECH_ACT_CAS) begin
+          perf_cnt_incr[PERF_CNT_PRE] += 1;
+        end
+      end
+
+      if (rank_policy_close[i_rk]) begin
+        perf_cnt_incr[PERF_CNT_POLICY_PRE] += 1;
+      end
+
+      if (rank_stall_rrd[i_rk]) begin
+        perf_cnt_incr[PERF_CNT_STALL_RRD] += 1;
+      end
+      if (rank_stall_faw[i_rk]) begin
+        perf_cnt_incr[PERF_CNT_STALL_FAW] += 1;
+      end
+      if (rank_stall_wtr[i_rk]) begin
+        perf_cnt_incr[PERF_CNT_STALL_WTR] += 1;
+      end
+      if (rank_stall_rtw[i_rk]) begin
+        perf_cnt_incr[PERF_CNT_STALL_RTW] += 1;
+      end
+
+      if (is_row_open_q[i_rk]) begin
+        perf_cnt_incr[PERF_CNT_ACT_STBY_CYCLES] += 1;
+      end else begin
+        perf_cnt_incr[PERF_CNT_PRE_STBY_CYCLES] += 1;
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      perf_cnts_o <= '{default: '0};
+    end else begin
+      for (int unsigned i_cnt = 0; i_cnt < NumPerfCnts; i_cnt = i_cnt + 1) begin
+        perf_cnts_o[i_cnt] <= perf_cnts_o[i_cnt] + PerfCntW'(perf_cnt_incr[i_cnt]);
+      end
+    end
+  end
+
   always_ff @(posedge clk_i or negedge rst_ni) begin
     if (!rst_ni) begin
       wslt_q <= '{default: '0};
@@ -1013,6 +1454,9 @@ module simmem_delay_calculator_core #(
       is_row_open_q <= '{default: '0};
       row_buf_ident_q <= '{default: '0};
       rank_delay_cnt_q <= '{default: '0};
+      rank_delay_frac_q <= '{default: '0};
+      rank_idle_cnt_q <= '{default: '0};
+      row_pred_q <= '{default: 2'b10};
       wrsp_release_en_mhot_o <= '0;
       rdata_release_en_cnts_q <= '0;
     end else begin
@@ -1021,6 +1465,9 @@ module simmem_delay_calculator_core #(
       is_row_open_q <= is_row_open_d;
       row_buf_ident_q <= row_buf_ident_d;
       rank_delay_cnt_q <= rank_delay_cnt_d;
+      rank_delay_frac_q <= rank_delay_frac_d;
+      rank_idle_cnt_q <= rank_idle_cnt_d;
+      row_pred_q <= row_pred_d;
       wrsp_release_en_mhot_o <= wrsp_release_en_mhot_d;
       rdata_release_en_cnts_q <= rdata_release_en_cnts_d;
     end
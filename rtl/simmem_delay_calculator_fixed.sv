@@ -0,0 +1,114 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Fixed-latency delay engine for the simulated memory controller
+
+// This delay engine replaces the row buffer model of simmem_delay_calculator_core when
+// DelayEngine is DELAY_ENGINE_FIXED. It bypasses the cost logic, and releases each response a fixed
+// number of cycles after its request: FixedWLat cycles after the last write data of a write burst,
+// and FixedRLat cycles after a read address request. It is meant for sensitivity studies, where
+// only the memory latency varies.
+//
+// The request latencies are applied by simmem_delay_slots, and the per-identifier ordering is
+// preserved by the response banks. This engine does not drive the performance counters.
+
+module simmem_delay_calculator_fixed (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Write address request from the requester.
+    input simmem_pkg::waddr_t                                         waddr_i,
+    // Internal identifier corresponding to the write address request (issued by the write response
+    // bank).
+    input simmem_pkg::write_iid_t                                     waddr_iid_i,
+    // Number of write data packets that come with the write address.
+    input logic                   [simmem_pkg::MaxBurstLenField-1:0] wdata_immediate_cnt_i,
+
+    // Write address request valid from the requester.
+    input  logic waddr_valid_i,
+    // Blocks the write address request if there is no free write slot.
+    output logic waddr_ready_o,
+
+    // Write data request valid from the requester.
+    input logic wdata_valid_i,
+
+    // Read address request from the requester.
+    input simmem_pkg::raddr_t    raddr_i,
+    // Internal identifier corresponding to the read address request (issued by the read response
+    // bank).
+    input simmem_pkg::read_iid_t raddr_iid_i,
+
+    // Read address request valid from the requester.
+    input  logic raddr_valid_i,
+    // Blocks the read address request if there is no free read slot.
+    output logic raddr_ready_o,
+
+    // Release enable output signals and released address feedback.
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_release_en_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_release_en_mhot_o,
+
+    // Release confirmations sent by the message banks
+    input logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_released_iid_onehot_i,
+    input logic [simmem_pkg::RDataBankCapa-1:0] rdata_released_iid_onehot_i,
+
+    // Ready signals from the response banks
+    input logic wrsp_bank_ready_i,
+    input logic rrsp_bank_ready_i,
+
+    // Ready signals for the response banks
+    output logic wrsp_bank_ready_o,
+    output logic rrsp_bank_ready_o,
+
+    // Performance counters, indexed by simmem_pkg::perf_cnt_e
+    output logic [simmem_pkg::PerfCntW-1:0] perf_cnts_o[simmem_pkg::NumPerfCnts],
+
+    // Debug outputs, only observed by the testbench (see simmem_delay_slots).
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_issued_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_issued_mhot_o,
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_done_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_done_mhot_o,
+    output logic [    simmem_pkg::NumWSlots-1:0] wslt_v_mhot_o,
+    output logic [    simmem_pkg::NumRSlots-1:0] rslt_v_mhot_o
+);
+
+  import simmem_pkg::*;
+
+  localparam int unsigned FixedLatW = $clog2((FixedWLat > FixedRLat ? FixedWLat : FixedRLat) + 1);
+
+  assign perf_cnts_o = '{default: '0};
+
+  simmem_delay_slots #(
+      .LatW(FixedLatW)
+  ) i_simmem_delay_slots (
+      .clk_i                      (clk_i),
+      .rst_ni                     (rst_ni),
+      .waddr_i                    (waddr_i),
+      .waddr_iid_i                (waddr_iid_i),
+      .wdata_immediate_cnt_i      (wdata_immediate_cnt_i),
+      .wlat_i                     (FixedLatW'(FixedWLat)),
+      .waddr_valid_i              (waddr_valid_i),
+      .waddr_ready_o              (waddr_ready_o),
+      .wdata_valid_i              (wdata_valid_i),
+      .raddr_i                    (raddr_i),
+      .raddr_iid_i                (raddr_iid_i),
+      .rlat_i                     (FixedLatW'(FixedRLat)),
+      .raddr_valid_i              (raddr_valid_i),
+      .raddr_ready_o              (raddr_ready_o),
+      .wrsp_release_en_mhot_o     (wrsp_release_en_mhot_o),
+      .rdata_release_en_mhot_o    (rdata_release_en_mhot_o),
+      .wrsp_released_iid_onehot_i (wrsp_released_iid_onehot_i),
+      .rdata_released_iid_onehot_i(rdata_released_iid_onehot_i),
+      .wrsp_bank_ready_i          (wrsp_bank_ready_i),
+      .rrsp_bank_ready_i          (rrsp_bank_ready_i),
+      .wrsp_bank_ready_o          (wrsp_bank_ready_o),
+      .rrsp_bank_ready_o          (rrsp_bank_ready_o),
+      .wrsp_issued_mhot_o         (wrsp_issued_mhot_o),
+      .rdata_issued_mhot_o        (rdata_issued_mhot_o),
+      .wrsp_done_mhot_o           (wrsp_done_mhot_o),
+      .rdata_done_mhot_o          (rdata_done_mhot_o),
+      .wslt_v_mhot_o              (wslt_v_mhot_o),
+      .rslt_v_mhot_o              (rslt_v_mhot_o)
+  );
+
+endmodule
@@ -0,0 +1,207 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Statistical delay engine for the simulated memory controller
+
+// This delay engine replaces the row buffer model of simmem_delay_calculator_core when
+// DelayEngine is DELAY_ENGINE_STAT. Instead of scheduling the requests, it draws the latency of
+// each address request from an empirical distribution, for instance measured on the real system.
+// It is much cheaper in area than the age matrices of the row buffer model.
+//
+// Distribution: The distribution is a table of StatNumBins bins. Each bin holds a cumulative
+// probability, as a StatLfsrW-bit fraction of one, and a latency in clk_i cycles. The cumulative
+// probabilities must be nondecreasing. A random value r is drawn from a Galois LFSR, and the
+// latency of the first bin whose cumulative probability is not lower than r is selected. If there
+// is no such bin, then the latency of the last bin is selected.
+//
+// The table and the LFSR seed are runtime-programmable through the configuration port (see the
+// register map in simmem_pkg), so that one bitstream can replay several distributions. At reset,
+// the cumulative probabilities are uniform and all the latencies are StatResetLat.
+//
+// Random values: The LFSR is stepped twice per cycle, to provide independent values to the write
+// and read address requests of the same cycle.
+//
+// The request latencies are then applied by simmem_delay_slots, and the per-identifier ordering is
+// preserved by the response banks. This engine does not drive the performance counters.
+
+module simmem_delay_calculator_stat (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Write address request from the requester.
+    input simmem_pkg::waddr_t                                         waddr_i,
+    // Internal identifier corresponding to the write address request (issued by the write response
+    // bank).
+    input simmem_pkg::write_iid_t                                     waddr_iid_i,
+    // Number of write data packets that come with the write address.
+    input logic                   [simmem_pkg::MaxBurstLenField-1:0] wdata_immediate_cnt_i,
+
+    // Write address request valid from the requester.
+    input  logic waddr_valid_i,
+    // Blocks the write address request if there is no free write slot.
+    output logic waddr_ready_o,
+
+    // Write data request valid from the requester.
+    input logic wdata_valid_i,
+
+    // Read address request from the requester.
+    input simmem_pkg::raddr_t    raddr_i,
+    // Internal identifier corresponding to the read address request (issued by the read response
+    // bank).
+    input simmem_pkg::read_iid_t raddr_iid_i,
+
+    // Read address request valid from the requester.
+    input  logic raddr_valid_i,
+    // Blocks the read address request if there is no free read slot.
+    output logic raddr_ready_o,
+
+    // Release enable output signals and released address feedback.
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_release_en_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_release_en_mhot_o,
+
+    // Release confirmations sent by the message banks
+    input logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_released_iid_onehot_i,
+    input logic [simmem_pkg::RDataBankCapa-1:0] rdata_released_iid_onehot_i,
+
+    // Ready signals from the response banks
+    input logic wrsp_bank_ready_i,
+    input logic rrsp_bank_ready_i,
+
+    // Ready signals for the response banks
+    output logic wrsp_bank_ready_o,
+    output logic rrsp_bank_ready_o,
+
+    // Configuration port
+    input logic                            cfg_valid_i,
+    input logic [simmem_pkg::CfgAddrW-1:0] cfg_addr_i,
+    input logic [simmem_pkg::CfgDataW-1:0] cfg_wdata_i,
+
+    // Performance counters, indexed by simmem_pkg::perf_cnt_e
+    output logic [simmem_pkg::PerfCntW-1:0] perf_cnts_o[simmem_pkg::NumPerfCnts],
+
+    // Debug outputs, only observed by the testbench (see simmem_delay_slots).
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_issued_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_issued_mhot_o,
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_done_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_done_mhot_o,
+    output logic [    simmem_pkg::NumWSlots-1:0] wslt_v_mhot_o,
+    output logic [    simmem_pkg::NumRSlots-1:0] rslt_v_mhot_o
+);
+
+  import simmem_pkg::*;
+
+  /**
+  * Steps the Galois LFSR once.
+  *
+  * @param state the current LFSR state.
+  * @return the next LFSR state.
+  */
+  function automatic logic [StatLfsrW-1:0] step_lfsr(logic [StatLfsrW-1:0] state);
+    return state[0] ? (state >> 1) ^ StatLfsrTaps : state >> 1;
+  endfunction : step_lfsr
+
+  ////////////////////////////
+  // Distribution registers //
+  ////////////////////////////
+
+  logic [StatLfsrW-1:0] cdf_q[StatNumBins];
+  logic [StatLatW-1:0] lat_q[StatNumBins];
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      for (int unsigned i_bin = 0; i_bin < StatNumBins; i_bin = i_bin + 1) begin
+        cdf_q[i_bin] <= StatLfsrW'((((i_bin + 1) << StatLfsrW) / StatNumBins) - 1);
+        lat_q[i_bin] <= StatLatW'(StatResetLat);
+      end
+    end else if (cfg_valid_i) begin
+      for (int unsigned i_bin = 0; i_bin < StatNumBins; i_bin = i_bin + 1) begin
+        if (cfg_addr_i == CfgAddrW'(CfgStatCdfBase + i_bin)) begin
+          cdf_q[i_bin] <= cfg_wdata_i[StatLfsrW-1:0];
+        end
+        if (cfg_addr_i == CfgAddrW'(CfgStatLatBase + i_bin)) begin
+          lat_q[i_bin] <= cfg_wdata_i[StatLatW-1:0];
+        end
+      end
+    end
+  end
+
+  /////////////////////
+  // Latency drawing //
+  /////////////////////
+
+  logic [StatLfsrW-1:0] lfsr_d, lfsr_q;
+  // Random values for the write and read address requests.
+  logic [StatLfsrW-1:0] wrnd, rrnd;
+  // Drawn latencies.
+  logic [StatLatW-1:0] wlat, rlat;
+
+  assign wrnd = lfsr_q;
+  assign rrnd = step_lfsr(lfsr_q);
+
+  always_comb begin
+    lfsr_d = step_lfsr(rrnd);
+    // A zero seed would lock the LFSR, so it is replaced with the default seed.
+    if (cfg_valid_i && cfg_addr_i == CfgStatSeed) begin
+      lfsr_d = |cfg_wdata_i[StatLfsrW-1:0] ? cfg_wdata_i[StatLfsrW-1:0] : StatLfsrSeed;
+    end
+  end
+
+  // Iterate in decreasing bin order, so that the first matching bin is kept.
+  always_comb begin
+    wlat = lat_q[StatNumBins - 1];
+    rlat = lat_q[StatNumBins - 1];
+    for (int i_bin = int'(StatNumBins) - 1; i_bin >= 0; i_bin = i_bin - 1) begin
+      if (wrnd <= cdf_q[i_bin]) begin
+        wlat = lat_q[i_bin];
+      end
+      if (rrnd <= cdf_q[i_bin]) begin
+        rlat = lat_q[i_bin];
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      lfsr_q <= StatLfsrSeed;
+    end else begin
+      lfsr_q <= lfsr_d;
+    end
+  end
+
+  assign perf_cnts_o = '{default: '0};
+
+  simmem_delay_slots #(
+      .LatW(StatLatW)
+  ) i_simmem_delay_slots (
+      .clk_i                      (clk_i),
+      .rst_ni                     (rst_ni),
+      .waddr_i                    (waddr_i),
+      .waddr_iid_i                (waddr_iid_i),
+      .wdata_immediate_cnt_i      (wdata_immediate_cnt_i),
+      .wlat_i                     (wlat),
+      .waddr_valid_i              (waddr_valid_i),
+      .waddr_ready_o              (waddr_ready_o),
+      .wdata_valid_i              (wdata_valid_i),
+      .raddr_i                    (raddr_i),
+      .raddr_iid_i                (raddr_iid_i),
+      .rlat_i                     (rlat),
+      .raddr_valid_i              (raddr_valid_i),
+      .raddr_ready_o              (raddr_ready_o),
+      .wrsp_release_en_mhot_o     (wrsp_release_en_mhot_o),
+      .rdata_release_en_mhot_o    (rdata_release_en_mhot_o),
+      .wrsp_released_iid_onehot_i (wrsp_released_iid_onehot_i),
+      .rdata_released_iid_onehot_i(rdata_released_iid_onehot_i),
+      .wrsp_bank_ready_i          (wrsp_bank_ready_i),
+      .rrsp_bank_ready_i          (rrsp_bank_ready_i),
+      .wrsp_bank_ready_o          (wrsp_bank_ready_o),
+      .rrsp_bank_ready_o          (rrsp_bank_ready_o),
+      .wrsp_issued_mhot_o         (wrsp_issued_mhot_o),
+      .rdata_issued_mhot_o        (rdata_issued_mhot_o),
+      .wrsp_done_mhot_o           (wrsp_done_mhot_o),
+      .rdata_done_mhot_o          (rdata_done_mhot_o),
+      .wslt_v_mhot_o              (wslt_v_mhot_o),
+      .rslt_v_mhot_o              (rslt_v_mhot_o)
+  );
+
+endmodule
@@ -0,0 +1,301 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Latency slots for the lightweight delay engines
+
+// This module delays each address request by a latency provided along with the address request,
+// without modeling the state of the memory. It is shared by the delay engines which do not require
+// the row buffer model of simmem_delay_calculator_core, and it exposes the same interface as the
+// latter towards the delay calculator wrapper and the response banks.
+//
+// Write slots: Each write address request occupies a write slot. Its timer only starts when all the
+// write data of the burst have been received, as the write response must not precede the last
+// write data. The write data are attributed to the write slots in the order of the write address
+// requests, using a FIFO of the write slots that still expect write data.
+//
+// Read slots: Each read address request occupies a read slot, and its timer starts immediately.
+// When the timer expires, the release of all the read data of the burst is enabled at once. The
+// response bank still releases them one at a time.
+//
+// The release is enabled RspLatency cycles before the latency expires, to compensate for the slot
+// liberation and the response bank latency. Therefore, latencies lower than RspLatency behave as
+// RspLatency.
+//
+// AXI ordering: The per-identifier order is preserved by the response banks, which only release
+// the oldest response of each AXI identifier, once its release is enabled.
+
+module simmem_delay_slots #(
+    // Width of the latencies, in clk_i cycles.
+    parameter int unsigned LatW = 8
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // Write address request from the requester.
+    input simmem_pkg::waddr_t                                         waddr_i,
+    // Internal identifier corresponding to the write address request (issued by the write response
+    // bank).
+    input simmem_pkg::write_iid_t                                     waddr_iid_i,
+    // Number of write data packets that come with the write address.
+    input logic                   [simmem_pkg::MaxBurstLenField-1:0] wdata_immediate_cnt_i,
+    // Latency of the write address request, from its last write data to its write response.
+    input logic                   [                       LatW-1:0] wlat_i,
+
+    // Write address request valid from the requester.
+    input  logic waddr_valid_i,
+    // Blocks the write address request if there is no free write slot.
+    output logic waddr_ready_o,
+
+    // Write data request valid from the requester.
+    input logic wdata_valid_i,
+
+    // Read address request from the requester.
+    input simmem_pkg::raddr_t                 raddr_i,
+    // Internal identifier corresponding to the read address request (issued by the read response
+    // bank).
+    input simmem_pkg::read_iid_t              raddr_iid_i,
+    // Latency of the read address request, from the request to its read data.
+    input logic                  [LatW-1:0] rlat_i,
+
+    // Read address request valid from the requester.
+    input  logic raddr_valid_i,
+    // Blocks the read address request if there is no free read slot.
+    output logic raddr_ready_o,
+
+    // Release enable output signals and released address feedback.
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_release_en_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_release_en_mhot_o,
+
+    // Release confirmations sent by the message banks
+    input logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_released_iid_onehot_i,
+    input logic [simmem_pkg::RDataBankCapa-1:0] rdata_released_iid_onehot_i,
+
+    // Ready signals from the response banks
+    input logic wrsp_bank_ready_i,
+    input logic rrsp_bank_ready_i,
+
+    // Ready signals for the response banks
+    output logic wrsp_bank_ready_o,
+    output logic rrsp_bank_ready_o,
+
+    // Debug outputs, only observed by the testbench (latency attribution): internal identifiers
+    // whose slot timer starts, and whose slot timer expires, in the current cycle.
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_issued_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_issued_mhot_o,
+    output logic [ simmem_pkg::WRspBankCapa-1:0] wrsp_done_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] rdata_done_mhot_o,
+    // Debug outputs (occupancy sampling): valid bits of the write and read slots.
+    output logic [simmem_pkg::NumWSlots-1:0] wslt_v_mhot_o,
+    output logic [simmem_pkg::NumRSlots-1:0] rslt_v_mhot_o
+);
+
+  import simmem_pkg::*;
+
+  // Number of cycles between the release enable and the response output.
+  localparam int unsigned RspLatency = 3;
+
+  localparam int unsigned NumWSlotsW = NumWSlots == 1 ? 1 : $clog2(NumWSlots);
+  localparam int unsigned NumRSlotsW = NumRSlots == 1 ? 1 : $clog2(NumRSlots);
+
+  /**
+  * Determines the initial value of a slot timer.
+  *
+  * @param lat the latency of the request, in clk_i cycles.
+  * @return the number of cycles before enabling the release of the response.
+  */
+  function automatic logic [LatW-1:0] get_init_cnt(logic [LatW-1:0] lat);
+    return lat > LatW'(RspLatency) ? lat - LatW'(RspLatency) : '0;
+  endfunction : get_init_cnt
+
+  ///////////
+  // Slots //
+  ///////////
+
+  typedef struct packed {
+    logic v;
+    write_iid_t iid;
+    // Number of write data still expected.
+    logic [XBurstEffLenW-1:0] data_left;
+    // Decreasing timer, only running when all the write data have been received.
+    logic [LatW-1:0] cnt;
+  } wslt_t;
+
+  typedef struct packed {
+    logic v;
+    read_iid_t iid;
+    logic [XBurstEffLenW-1:0] burst_len;
+    // Decreasing timer.
+    logic [LatW-1:0] cnt;
+  } rslt_t;
+
+  wslt_t wslt_d[NumWSlots];
+  wslt_t wslt_q[NumWSlots];
+  rslt_t rslt_d[NumRSlots];
+  rslt_t rslt_q[NumRSlots];
+
+  // FIFO of the write slots expecting write data, the oldest one being at index 0.
+  logic [NumWSlotsW-1:0] wdata_fifo_d[NumWSlots];
+  logic [NumWSlotsW-1:0] wdata_fifo_q[NumWSlots];
+  logic [NumWSlotsW:0] wdata_fifo_cnt_d;
+  logic [NumWSlotsW:0] wdata_fifo_cnt_q;
+
+  // Lowest free slots.
+  logic [NumWSlotsW-1:0] nxt_free_wslt;
+  logic [NumRSlotsW-1:0] nxt_free_rslt;
+  logic free_wslt_exists;
+  logic free_rslt_exists;
+
+  always_comb begin
+    nxt_free_wslt = '0;
+    free_wslt_exists = 1'b0;
+    for (int i_slt = int'(NumWSlots) - 1; i_slt >= 0; i_slt = i_slt - 1) begin
+      if (!wslt_q[i_slt].v) begin
+        nxt_free_wslt = NumWSlotsW'(i_slt);
+        free_wslt_exists = 1'b1;
+      end
+    end
+
+    nxt_free_rslt = '0;
+    free_rslt_exists = 1'b0;
+    for (int i_slt = int'(NumRSlots) - 1; i_slt >= 0; i_slt = i_slt - 1) begin
+      if (!rslt_q[i_slt].v) begin
+        nxt_free_rslt = NumRSlotsW'(i_slt);
+        free_rslt_exists = 1'b1;
+      end
+    end
+  end
+
+  for (genvar i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin : gen_wslt_v
+    assign wslt_v_mhot_o[i_slt] = wslt_q[i_slt].v;
+  end : gen_wslt_v
+  for (genvar i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin : gen_rslt_v
+    assign rslt_v_mhot_o[i_slt] = rslt_q[i_slt].v;
+  end : gen_rslt_v
+
+  assign wrsp_bank_ready_o = free_wslt_exists;
+  assign rrsp_bank_ready_o = free_rslt_exists;
+
+  assign waddr_ready_o = wrsp_bank_ready_o & wrsp_bank_ready_i;
+  assign raddr_ready_o = rrsp_bank_ready_o & rrsp_bank_ready_i;
+
+  /////////////
+  // Outputs //
+  /////////////
+
+  logic [WRspBankCapa-1:0] wrsp_release_en_mhot_d;
+  // A finished read slot enables the release of its whole burst at once, so the counters must hold
+  // the effective burst length, which exceeds the burst length field by one.
+  logic [RDataBankCapa-1:0][XBurstEffLenW-1:0] rdata_release_en_cnts_d;
+  logic [RDataBankCapa-1:0][XBurstEffLenW-1:0] rdata_release_en_cnts_q;
+
+  for (genvar i_iid = 0; i_iid < RDataBankCapa; i_iid = i_iid + 1) begin : en_rdata_release
+    assign rdata_release_en_mhot_o[i_iid] = |rdata_release_en_cnts_q[i_iid];
+  end : en_rdata_release
+
+  ////////////////////////////////////
+  // Management combinatorial logic //
+  ////////////////////////////////////
+
+  always_comb begin
+    logic [NumWSlotsW-1:0] wdata_slt;
+
+    wslt_d = wslt_q;
+    rslt_d = rslt_q;
+    wdata_fifo_d = wdata_fifo_q;
+    wdata_fifo_cnt_d = wdata_fifo_cnt_q;
+    wrsp_issued_mhot_o = '0;
+    rdata_issued_mhot_o = '0;
+    wrsp_done_mhot_o = '0;
+    rdata_done_mhot_o = '0;
+
+    // Input signals from message banks about the released iid.
+    wrsp_release_en_mhot_d = wrsp_release_en_mhot_o ^ wrsp_released_iid_onehot_i;
+    rdata_release_en_cnts_d = rdata_release_en_cnts_q;
+    for (int unsigned i_iid = 0; i_iid < RDataBankCapa; i_iid = i_iid + 1) begin
+      if (rdata_released_iid_onehot_i[i_iid]) begin
+        rdata_release_en_cnts_d[i_iid] -= 1;
+      end
+    end
+
+    // Timers and slot liberation.
+    for (int unsigned i_slt = 0; i_slt < NumWSlots; i_slt = i_slt + 1) begin
+      if (wslt_q[i_slt].v && wslt_q[i_slt].data_left == '0) begin
+        if (wslt_q[i_slt].cnt == '0) begin
+          wslt_d[i_slt].v = 1'b0;
+          wrsp_release_en_mhot_d[wslt_q[i_slt].iid] = 1'b1;
+          wrsp_done_mhot_o[wslt_q[i_slt].iid] = 1'b1;
+        end else begin
+          wslt_d[i_slt].cnt = wslt_q[i_slt].cnt - 1;
+        end
+      end
+    end
+    for (int unsigned i_slt = 0; i_slt < NumRSlots; i_slt = i_slt + 1) begin
+      if (rslt_q[i_slt].v) begin
+        if (rslt_q[i_slt].cnt == '0) begin
+          rslt_d[i_slt].v = 1'b0;
+          rdata_release_en_cnts_d[rslt_q[i_slt].iid] += rslt_q[i_slt].burst_len;
+          rdata_done_mhot_o[rslt_q[i_slt].iid] = 1'b1;
+        end else begin
+          rslt_d[i_slt].cnt = rslt_q[i_slt].cnt - 1;
+        end
+      end
+    end
+
+    // Write data input: the data belongs to the oldest write slot expecting data.
+    wdata_slt = wdata_fifo_q[0];
+    if (wdata_valid_i && wdata_fifo_cnt_q != '0) begin
+      wslt_d[wdata_slt].data_left = wslt_q[wdata_slt].data_left - 1;
+      if (wslt_q[wdata_slt].data_left == XBurstEffLenW'(1)) begin
+        wrsp_issued_mhot_o[wslt_q[wdata_slt].iid] = 1'b1;
+        for (int unsigned i_pos = 0; i_pos < NumWSlots - 1; i_pos = i_pos + 1) begin
+          wdata_fifo_d[i_pos] = wdata_fifo_q[i_pos + 1];
+        end
+        wdata_fifo_cnt_d = wdata_fifo_cnt_q - 1;
+      end
+    end
+
+    // Write address request input.
+    if (waddr_valid_i && waddr_ready_o) begin
+      wslt_d[nxt_free_wslt].v = 1'b1;
+      wslt_d[nxt_free_wslt].iid = waddr_iid_i;
+      wslt_d[nxt_free_wslt].data_left = get_effective_burst_len(waddr_i.burst_len) -
+          XBurstEffLenW'(wdata_immediate_cnt_i);
+      wslt_d[nxt_free_wslt].cnt = get_init_cnt(wlat_i);
+      if (wslt_d[nxt_free_wslt].data_left != '0) begin
+        wdata_fifo_d[wdata_fifo_cnt_d[NumWSlotsW-1:0]] = nxt_free_wslt;
+        wdata_fifo_cnt_d = wdata_fifo_cnt_d + 1;
+      end else begin
+        wrsp_issued_mhot_o[waddr_iid_i] = 1'b1;
+      end
+    end
+
+    // Read address request input.
+    if (raddr_valid_i && raddr_ready_o) begin
+      rslt_d[nxt_free_rslt].v = 1'b1;
+      rslt_d[nxt_free_rslt].iid = raddr_iid_i;
+      rslt_d[nxt_free_rslt].burst_len = get_effective_burst_len(raddr_i.burst_len);
+      rslt_d[nxt_free_rslt].cnt = get_init_cnt(rlat_i);
+      rdata_issued_mhot_o[raddr_iid_i] = 1'b1;
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      wslt_q <= '{default: '0};
+      rslt_q <= '{default: '0};
+      wdata_fifo_q <= '{default: '0};
+      wdata_fifo_cnt_q <= '0;
+      wrsp_release_en_mhot_o <= '0;
+      rdata_release_en_cnts_q <= '0;
+    end else begin
+      wslt_q <= wslt_d;
+      rslt_q <= rslt_d;
+      wdata_fifo_q <= wdata_fifo_d;
+      wdata_fifo_cnt_q <= wdata_fifo_cnt_d;
+      wrsp_release_en_mhot_o <= wrsp_release_en_mhot_d;
+      rdata_release_en_cnts_q <= rdata_release_en_cnts_d;
+    end
+  end
+
+endmodule
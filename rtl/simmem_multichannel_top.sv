@@ -0,0 +1,426 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Multi-channel simulated memory controller top-level module
+
+// This top-level module emulates a memory system made of NumChannels DRAM channels, interleaved on
+// address bits. Its interface is identical to the one of simmem_top, with additional per-channel
+// counter outputs.
+//
+// Channel selection: The channel of an address request is given by the $clog2(NumChannels)
+//  address bits starting at ChannelAddrLsb. A whole burst is assigned to the channel of its base
+//  address, so ChannelAddrLsb should not be lower than the log2 of the largest burst footprint.
+//
+// Delay calculators: There is one delay calculator per channel. Address requests are only
+//  submitted to the delay calculator of their channel, which must have a free slot for the request
+//  to be accepted. The delay calculators emulate independent channels, and therefore each of them
+//  has its own ranks.
+//
+// Response banks: The response banks are shared by all the channels. As the response banks hold
+//  one linked list per AXI identifier, in the order of the reservations, the responses from all the
+//  channels are merged while preserving the per-identifier AXI ordering. A response that completes
+//  early in a lightly loaded channel may therefore wait for an older response with the same AXI
+//  identifier in a more loaded channel.
+//
+// Release enable and feedback: Each internal identifier (response bank RAM address) is owned by
+//  the channel that reserved it. The release enable signals of all the delay calculators are ORed,
+//  while the release feedback from the response banks is only forwarded to the owner channel.
+//
+// Write data routing: As write data requests do not carry an AXI identifier, they are routed in
+//  the order of the write address requests. A small FIFO holds the channel and the burst length of
+//  each accepted write address request whose write data has not been fully received yet. Write
+//  data are only accepted when this FIFO is not empty, i.e., write data never precede the
+//  corresponding write address request in the delay calculators. The FIFO cannot overflow, as the
+//  number of its entries never exceeds the number of outstanding write bursts, which is bounded by
+//  the write response bank capacity.
+//
+// Per-channel counters: For each channel, the following counters are maintained:
+//  * ch_waddr_cnt_o, ch_raddr_cnt_o: The number of accepted write and read address requests.
+//  * ch_wstall_cnt_o, ch_rstall_cnt_o: The number of cycles during which a valid write (resp. read)
+//    address request to this channel was blocked because the channel had no free slot.
+//  * ch_perf_cnts_o: The performance counters of the channel's delay calculator.
+
+module simmem_multichannel_top #(
+    // Must be a power of two.
+    parameter int unsigned NumChannels = 2,
+    // Position of the least significant address bit used for channel selection.
+    parameter int unsigned ChannelAddrLsb = simmem_pkg::BurstAddrLSBs,
+
+    localparam int unsigned NumChsW = NumChannels == 1 ? 1 : $clog2 (NumChannels)  // derived parameter
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // AXI slave interface
+
+    input  logic               raddr_in_valid_i,
+    output logic               raddr_in_ready_o,
+    input  simmem_pkg::raddr_t raddr_i,
+
+    input  logic               waddr_in_valid_i,
+    output logic               waddr_in_ready_o,
+    input  simmem_pkg::waddr_t waddr_i,
+
+    input  logic               wdata_in_valid_i,
+    output logic               wdata_in_ready_o,
+    input  simmem_pkg::wdata_t wdata_i,
+
+    input  logic               rdata_out_ready_i,
+    output logic               rdata_out_valid_o,
+    output simmem_pkg::rdata_t rdata_o,
+
+    input  logic              wrsp_out_ready_i,
+    output logic              wrsp_out_valid_o,
+    output simmem_pkg::wrsp_t wrsp_o,
+
+    // AXI master interface
+
+    input  logic               waddr_out_ready_i,
+    output logic               waddr_out_valid_o,
+    output simmem_pkg::waddr_t waddr_o,
+
+    input  logic               raddr_out_ready_i,
+    output logic               raddr_out_valid_o,
+    output simmem_pkg::raddr_t raddr_o,
+
+    input  logic               wdata_out_ready_i,
+    output logic               wdata_out_valid_o,
+    output simmem_pkg::wdata_t wdata_o,
+
+    input  logic               rdata_in_valid_i,
+    output logic               rdata_in_ready_o,
+    input  simmem_pkg::rdata_t rdata_i,
+
+    input  logic              wrsp_in_valid_i,
+    output logic              wrsp_in_ready_o,
+    input  simmem_pkg::wrsp_t wrsp_i,
+
+    // Configuration port, broadcast to the delay calculators of all the channels
+
+    input logic                            cfg_valid_i,
+    input logic [simmem_pkg::CfgAddrW-1:0] cfg_addr_i,
+    input logic [simmem_pkg::CfgDataW-1:0] cfg_wdata_i,
+
+    // Per-channel counters
+
+    output logic [simmem_pkg::PerfCntW-1:0] ch_waddr_cnt_o [NumChannels],
+    output logic [simmem_pkg::PerfCntW-1:0] ch_raddr_cnt_o [NumChannels],
+    output logic [simmem_pkg::PerfCntW-1:0] ch_wstall_cnt_o[NumChannels],
+    output logic [simmem_pkg::PerfCntW-1:0] ch_rstall_cnt_o[NumChannels],
+
+    // Per-channel performance counters of the delay calculators, indexed by simmem_pkg::perf_cnt_e
+    output logic [simmem_pkg::PerfCntW-1:0] ch_perf_cnts_o [NumChannels][simmem_pkg::NumPerfCnts]
+);
+
+  import simmem_pkg::*;
+
+  ///////////////////////
+  // Channel selection //
+  ///////////////////////
+
+  logic [NumChsW-1:0] waddr_ch;
+  logic [NumChsW-1:0] raddr_ch;
+
+  if (NumChannels == 1) begin : gen_single_channel
+    assign waddr_ch = '0;
+    assign raddr_ch = '0;
+  end else begin : gen_multi_channel
+    assign waddr_ch = waddr_i.addr[ChannelAddrLsb +: NumChsW];
+    assign raddr_ch = raddr_i.addr[ChannelAddrLsb +: NumChsW];
+  end
+
+  // Reservation identifier
+  logic [NumIds-1:0] wrsv_req_id_onehot;
+  logic [NumIds-1:0] rrsv_req_id_onehot;
+
+  for (genvar i_bit = 0; i_bit < NumIds; i_bit = i_bit + 1) begin : rsv_req_id_to_onehot
+    assign wrsv_req_id_onehot[i_bit] = i_bit == waddr_i.id;
+    assign rrsv_req_id_onehot[i_bit] = i_bit == raddr_i.id;
+  end : rsv_req_id_to_onehot
+
+  // Reserved IID (RAM address)
+  logic [WRspBankAddrW-1:0] wrsv_iid;
+  logic [RDataBankAddrW-1:0] rrsv_iid;
+
+  // Reservation handshakes on the response banks
+  logic wrsv_valid_in;
+  logic rrsv_valid_in;
+  logic wrsv_ready_out;
+  logic rrsv_ready_out;
+
+  assign wrsv_valid_in = waddr_out_ready_i & waddr_in_valid_i;
+  assign rrsv_valid_in = raddr_out_ready_i & raddr_in_valid_i;
+
+  // Release enable signals, aggregated over all the channels
+  logic [WRspBankCapa-1:0] wrsp_release_en_mhot;
+  logic [RDataBankCapa-1:0] rdata_release_en_mhot;
+
+  // Released addresses feedback
+  logic [WRspBankCapa-1:0] wrsp_released_onehot;
+  logic [RDataBankCapa-1:0] rdata_released_onehot;
+
+  // Mutual ready signals (directions are given in the point of view of the response banks
+  logic w_delay_calc_ready_in;  // From the delay calculator of the selected channel
+  logic r_delay_calc_ready_in;  // From the delay calculator of the selected channel
+  logic w_delay_calc_ready_out;  // From the response banks
+  logic r_delay_calc_ready_out;  // From the response banks
+
+  ////////////////////////
+  // Write data routing //
+  ////////////////////////
+
+  typedef struct packed {
+    logic [NumChsW-1:0] ch;
+    logic [XBurstEffLenW-1:0] burst_len;  // Effective burst length
+  } wdata_route_t;
+
+  localparam int unsigned WRouteDepth = WRspBankCapa;
+  localparam int unsigned WRoutePtrW = WRouteDepth == 1 ? 1 : $clog2(WRouteDepth);
+  localparam int unsigned WRouteLenW = WRoutePtrW + 1;
+
+  wdata_route_t wroute_q[WRouteDepth];
+  logic [WRoutePtrW-1:0] wroute_rptr_q, wroute_rptr_d;
+  logic [WRoutePtrW-1:0] wroute_wptr_q, wroute_wptr_d;
+  logic [WRouteLenW-1:0] wroute_len_q, wroute_len_d;
+  // Number of write data already received for the burst at the head of the FIFO.
+  logic [XBurstEffLenW-1:0] wroute_beat_cnt_q, wroute_beat_cnt_d;
+
+  logic wroute_push;
+  logic wroute_pop;
+  logic wdata_in_handshake;
+
+  assign wroute_push = waddr_in_valid_i & waddr_in_ready_o;
+  assign wdata_in_handshake = wdata_in_valid_i & wdata_in_ready_o;
+  assign wroute_pop = wdata_in_handshake &&
+      (wroute_beat_cnt_q + XBurstEffLenW'(1)) == wroute_q[wroute_rptr_q].burst_len;
+
+  always_comb begin
+    wroute_rptr_d = wroute_rptr_q;
+    wroute_wptr_d = wroute_wptr_q;
+    wroute_len_d = wroute_len_q;
+    wroute_beat_cnt_d = wroute_beat_cnt_q;
+
+    if (wroute_push) begin
+      wroute_wptr_d = wroute_wptr_q == WRoutePtrW'(WRouteDepth - 1) ? '0 :
+          wroute_wptr_q + WRoutePtrW'(1);
+      wroute_len_d = wroute_len_d + WRouteLenW'(1);
+    end
+
+    if (wroute_pop) begin
+      wroute_rptr_d = wroute_rptr_q == WRoutePtrW'(WRouteDepth - 1) ? '0 :
+          wroute_rptr_q + WRoutePtrW'(1);
+      wroute_len_d = wroute_len_d - WRouteLenW'(1);
+      wroute_beat_cnt_d = '0;
+    end else if (wdata_in_handshake) begin
+      wroute_beat_cnt_d = wroute_beat_cnt_q + XBurstEffLenW'(1);
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      wroute_q <= '{default: '0};
+      wroute_rptr_q <= '0;
+      wroute_wptr_q <= '0;
+      wroute_len_q <= '0;
+      wroute_beat_cnt_q <= '0;
+    end else begin
+      if (wroute_push) begin
+        wroute_q[wroute_wptr_q].ch <= waddr_ch;
+        wroute_q[wroute_wptr_q].burst_len <= get_effective_burst_len(waddr_i.burst_len);
+      end
+      wroute_rptr_q <= wroute_rptr_d;
+      wroute_wptr_q <= wroute_wptr_d;
+      wroute_len_q <= wroute_len_d;
+      wroute_beat_cnt_q <= wroute_beat_cnt_d;
+    end
+  end
+
+  ///////////////////////////////
+  // Internal identifier owner //
+  ///////////////////////////////
+
+  // Channel owning each internal identifier, set at reservation time.
+  logic [NumChsW-1:0] wiid_owner_q[WRspBankCapa];
+  logic [NumChsW-1:0] riid_owner_q[RDataBankCapa];
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      wiid_owner_q <= '{default: '0};
+      riid_owner_q <= '{default: '0};
+    end else begin
+      if (waddr_in_valid_i && waddr_in_ready_o) begin
+        wiid_owner_q[wrsv_iid] <= waddr_ch;
+      end
+      if (raddr_in_valid_i && raddr_in_ready_o) begin
+        riid_owner_q[rrsv_iid] <= raddr_ch;
+      end
+    end
+  end
+
+  //////////////////////
+  // Upstream signals //
+  //////////////////////
+
+  // Output hanshake signals for upstream signals (from the requester to the real memory controller).
+  assign waddr_in_ready_o = waddr_out_ready_i & wrsv_ready_out;
+  assign raddr_in_ready_o = raddr_out_ready_i & rrsv_ready_out;
+  assign waddr_out_valid_o = waddr_in_valid_i & wrsv_ready_out;
+  assign raddr_out_valid_o = raddr_in_valid_i & rrsv_ready_out;
+  assign wdata_in_ready_o = wdata_out_ready_i & |wroute_len_q;
+  assign wdata_out_valid_o = wdata_in_valid_i & |wroute_len_q;
+
+  // Output upstream signals
+  assign wdata_o = wdata_i;
+  assign raddr_o = raddr_i;
+  assign waddr_o = waddr_i;
+
+  ///////////////////////////
+  // Per-channel instances //
+  ///////////////////////////
+
+  logic [WRspBankCapa-1:0] ch_wrsp_release_en_mhot[NumChannels];
+  logic [RDataBankCapa-1:0] ch_rdata_release_en_mhot[NumChannels];
+  logic [WRspBankCapa-1:0] ch_wrsp_released_onehot[NumChannels];
+  logic [RDataBankCapa-1:0] ch_rdata_released_onehot[NumChannels];
+  logic [NumChannels-1:0] ch_wrsp_bank_ready;
+  logic [NumChannels-1:0] ch_rrsp_bank_ready;
+
+  for (genvar i_ch = 0; i_ch < NumChannels; i_ch = i_ch + 1) begin : gen_channels
+    // Ready signals from the delay calculator, unused as they are also given to the response banks
+    // through the ch_*rsp_bank_ready signals.
+    logic waddr_ready_out_delay_calc;
+    logic raddr_ready_out_delay_calc;
+    logic wdata_ready_out_delay_calc;
+
+    // Release feedback, only forwarded to the owner channel.
+    for (genvar i_iid = 0; i_iid < WRspBankCapa; i_iid = i_iid + 1) begin : gen_wfeedback
+      assign ch_wrsp_released_onehot[i_ch][i_iid] =
+          wrsp_released_onehot[i_iid] & (wiid_owner_q[i_iid] == NumChsW'(i_ch));
+    end : gen_wfeedback
+    for (genvar i_iid = 0; i_iid < RDataBankCapa; i_iid = i_iid + 1) begin : gen_rfeedback
+      assign ch_rdata_released_onehot[i_ch][i_iid] =
+          rdata_released_onehot[i_iid] & (riid_owner_q[i_iid] == NumChsW'(i_ch));
+    end : gen_rfeedback
+
+    simmem_delay_calculator #(
+        .NumRanks(NumRanks)
+    ) i_simmem_delay_calculator (
+        .clk_i                      (clk_i),
+        .rst_ni                     (rst_ni),
+        .waddr_i                    (waddr_i),
+        .waddr_iid_i                (wrsv_iid),
+        .waddr_valid_i              (wrsv_valid_in && waddr_ch == NumChsW'(i_ch)),
+        .waddr_ready_o              (waddr_ready_out_delay_calc),
+        .wdata_valid_i              (wdata_in_handshake &&
+                                     wroute_q[wroute_rptr_q].ch == NumChsW'(i_ch)),
+        .wdata_ready_o              (wdata_ready_out_delay_calc),
+        .raddr_i                    (raddr_i),
+        .raddr_iid_i                (rrsv_iid),
+        .raddr_valid_i              (rrsv_valid_in && raddr_ch == NumChsW'(i_ch)),
+        .raddr_ready_o              (raddr_ready_out_delay_calc),
+        .wrsp_release_en_mhot_o     (ch_wrsp_release_en_mhot[i_ch]),
+        .rdata_release_en_mhot_o    (ch_rdata_release_en_mhot[i_ch]),
+        .wrsp_released_iid_onehot_i (ch_wrsp_released_onehot[i_ch]),
+        .rdata_released_iid_onehot_i(ch_rdata_released_onehot[i_ch]),
+        .wrsp_bank_ready_o          (ch_wrsp_bank_ready[i_ch]),
+        .rrsp_bank_ready_o          (ch_rrsp_bank_ready[i_ch]),
+        .wrsp_bank_ready_i          (w_delay_calc_ready_out),
+        .rrsp_bank_ready_i          (r_delay_calc_ready_out),
+        .cfg_valid_i                (cfg_valid_i),
+        .cfg_addr_i                 (cfg_addr_i),
+        .cfg_wdata_i                (cfg_wdata_i),
+        .perf_cnts_o                (ch_perf_cnts_o[i_ch]),
+        .wrsp_issued_mhot_o         (),
+        .rdata_issued_mhot_o        (),
+        .wrsp_done_mhot_o           (),
+        .rdata_done_mhot_o          (),
+        .wslt_v_mhot_o              (),
+        .rslt_v_mhot_o              ()
+    );
+
+    //////////////////////////
+    // Per-channel counters //
+    //////////////////////////
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        ch_waddr_cnt_o[i_ch] <= '0;
+        ch_raddr_cnt_o[i_ch] <= '0;
+        ch_wstall_cnt_o[i_ch] <= '0;
+        ch_rstall_cnt_o[i_ch] <= '0;
+      end else begin
+        if (waddr_ch == NumChsW'(i_ch)) begin
+          if (waddr_in_valid_i && waddr_in_ready_o) begin
+            ch_waddr_cnt_o[i_ch] <= ch_waddr_cnt_o[i_ch] + 1;
+          end
+          if (wrsv_valid_in && !ch_wrsp_bank_ready[i_ch]) begin
+            ch_wstall_cnt_o[i_ch] <= ch_wstall_cnt_o[i_ch] + 1;
+          end
+        end
+        if (raddr_ch == NumChsW'(i_ch)) begin
+          if (raddr_in_valid_i && raddr_in_ready_o) begin
+            ch_raddr_cnt_o[i_ch] <= ch_raddr_cnt_o[i_ch] + 1;
+          end
+          if (rrsv_valid_in && !ch_rrsp_bank_ready[i_ch]) begin
+            ch_rstall_cnt_o[i_ch] <= ch_rstall_cnt_o[i_ch] + 1;
+          end
+        end
+      end
+    end
+  end : gen_channels
+
+  // Aggregate the release enable signals. Each internal identifier is owned by a single channel.
+  always_comb begin
+    wrsp_release_en_mhot = '0;
+    rdata_release_en_mhot = '0;
+    for (int unsigned i_ch = 0; i_ch < NumChannels; i_ch = i_ch + 1) begin
+      wrsp_release_en_mhot |= ch_wrsp_release_en_mhot[i_ch];
+      rdata_release_en_mhot |= ch_rdata_release_en_mhot[i_ch];
+    end
+  end
+
+  // The response banks accept a reservation iff the selected channel has a free slot.
+  assign w_delay_calc_ready_in = ch_wrsp_bank_ready[waddr_ch];
+  assign r_delay_calc_ready_in = ch_rrsp_bank_ready[raddr_ch];
+
+  // Response banks instance
+  simmem_rsp_banks i_simmem_rsp_banks (
+      .clk_i                   (clk_i),
+      .rst_ni                  (rst_ni),
+      .wrsv_req_id_onehot_i    (wrsv_req_id_onehot),
+      .rrsv_req_id_onehot_i    (rrsv_req_id_onehot),
+      .wrsv_iid_o              (wrsv_iid),
+      .rrsv_iid_o              (rrsv_iid),
+      .rrsv_burst_len_i        (MaxBurstLenFieldW'(raddr_i.burst_len)),
+      .wrsv_valid_i            (wrsv_valid_in),
+      .wrsv_ready_o            (wrsv_ready_out),
+      .rrsv_valid_i            (rrsv_valid_in),
+      .rrsv_ready_o            (rrsv_ready_out),
+      .w_release_en_i          (wrsp_release_en_mhot),
+      .r_release_en_i          (rdata_release_en_mhot),
+      .w_released_addr_onehot_o(wrsp_released_onehot),
+      .r_released_addr_onehot_o(rdata_released_onehot),
+      .wrsp_i                  (wrsp_i),
+      .wrsp_o                  (wrsp_o),
+      .rdata_i                 (rdata_i),
+      .rdata_o                 (rdata_o),
+      .w_in_rsp_valid_i        (wrsp_in_valid_i),
+      .w_in_rsp_ready_o        (wrsp_in_ready_o),
+      .r_in_data_valid_i       (rdata_in_valid_i),
+      .r_in_data_ready_o       (rdata_in_ready_o),
+      .w_out_rsp_ready_i       (wrsp_out_ready_i),
+      .w_out_rsp_valid_o       (wrsp_out_valid_o),
+      .r_out_data_ready_i      (rdata_out_ready_i),
+      .r_out_data_valid_o      (rdata_out_valid_o),
+      .w_delay_calc_ready_i    (w_delay_calc_ready_in),
+      .r_delay_calc_ready_i    (r_delay_calc_ready_in),
+      .w_delay_calc_ready_o    (w_delay_calc_ready_out),
+      .r_delay_calc_ready_o    (r_delay_calc_ready_out),
+      .wrsv_len_o              (),
+      .wrsp_len_o              (),
+      .rrsv_len_o              (),
+      .rdata_len_o             ()
+  );
+
+endmodule
@@ -0,0 +1,339 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Multi-port simulated memory controller top-level module
+
+// This top-level module emulates a memory controller shared by NumPorts requesters. It arbitrates
+// the requests of its NumPorts AXI slave ports, forwards them to a single simmem_top instance, and
+// routes the responses back to the requester ports.
+//
+// Identifier tagging: The log2(NumPorts) most significant bits of the AXI identifier are replaced
+//  with the port index when a request is forwarded. Requesters must therefore only use the
+//  IDWidth-log2(NumPorts) least significant identifier bits. Responses are routed according to the
+//  tag, which is cleared before the responses are delivered to the requester ports. As the
+//  response banks preserve the per-identifier ordering and distinct ports use distinct identifiers,
+//  the requests of distinct ports may be served out of order.
+//
+// Arbitration: Write and read address requests are arbitrated independently by two simmem_arbiter
+//  instances, configured by ArbMode and ArbWeights.
+//
+// Write data routing: As write data requests do not carry an AXI identifier, they are forwarded in
+//  the order of the write address grants. A FIFO holds the port index and the burst length of each
+//  granted write address request whose write data has not been fully forwarded yet. Write data of a
+//  port are only accepted after its write address request has been granted, which AXI permits.
+
+module simmem_multiport_top #(
+    // Must be between 2 and NumIds/2.
+    parameter int unsigned NumPorts = simmem_pkg::NumPorts,
+    parameter simmem_pkg::arb_mode_e ArbMode = simmem_pkg::ARB_ROUND_ROBIN,
+    // Only used in ARB_WEIGHTED mode. Each weight must be positive.
+    parameter logic [NumPorts-1:0][simmem_pkg::ArbWeightW-1:0] ArbWeights = '{default: 1},
+
+    localparam int unsigned PortIdW = $clog2(NumPorts)  // derived parameter
+) (
+    input logic clk_i,
+    input logic rst_ni,
+
+    // AXI slave interfaces
+
+    input  logic               [NumPorts-1:0] raddr_in_valid_i,
+    output logic               [NumPorts-1:0] raddr_in_ready_o,
+    input  simmem_pkg::raddr_t [NumPorts-1:0] raddr_i,
+
+    input  logic               [NumPorts-1:0] waddr_in_valid_i,
+    output logic               [NumPorts-1:0] waddr_in_ready_o,
+    input  simmem_pkg::waddr_t [NumPorts-1:0] waddr_i,
+
+    input  logic               [NumPorts-1:0] wdata_in_valid_i,
+    output logic               [NumPorts-1:0] wdata_in_ready_o,
+    input  simmem_pkg::wdata_t [NumPorts-1:0] wdata_i,
+
+    input  logic               [NumPorts-1:0] rdata_out_ready_i,
+    output logic               [NumPorts-1:0] rdata_out_valid_o,
+    output simmem_pkg::rdata_t [NumPorts-1:0] rdata_o,
+
+    input  logic              [NumPorts-1:0] wrsp_out_ready_i,
+    output logic              [NumPorts-1:0] wrsp_out_valid_o,
+    output simmem_pkg::wrsp_t [NumPorts-1:0] wrsp_o,
+
+    // AXI master interface
+
+    input  logic               waddr_out_ready_i,
+    output logic               waddr_out_valid_o,
+    output simmem_pkg::waddr_t waddr_o,
+
+    input  logic               raddr_out_ready_i,
+    output logic               raddr_out_valid_o,
+    output simmem_pkg::raddr_t raddr_o,
+
+    input  logic               wdata_out_ready_i,
+    output logic               wdata_out_valid_o,
+    output simmem_pkg::wdata_t wdata_o,
+
+    input  logic               rdata_in_valid_i,
+    output logic               rdata_in_ready_o,
+    input  simmem_pkg::rdata_t rdata_i,
+
+    input  logic              wrsp_in_valid_i,
+    output logic              wrsp_in_ready_o,
+    input  simmem_pkg::wrsp_t wrsp_i,
+
+    // Configuration port of the delay calculator (see the register map in simmem_pkg)
+
+    input logic                            cfg_valid_i,
+    input logic [simmem_pkg::CfgAddrW-1:0] cfg_addr_i,
+    input logic [simmem_pkg::CfgDataW-1:0] cfg_wdata_i,
+
+    // Performance counters of the delay calculator, indexed by simmem_pkg::perf_cnt_e
+
+    output logic [simmem_pkg::PerfCntW-1:0] perf_cnts_o[simmem_pkg::NumPerfCnts]
+);
+
+  import simmem_pkg::*;
+
+  // Signals between the arbitration logic and the simmem_top instance.
+  logic waddr_valid;
+  logic waddr_ready;
+  waddr_t waddr;
+
+  logic raddr_valid;
+  logic raddr_ready;
+  raddr_t raddr;
+
+  logic wdata_valid;
+  logic wdata_ready;
+
+  logic rdata_valid;
+  logic rdata_ready;
+  rdata_t rdata;
+
+  logic wrsp_valid;
+  logic wrsp_ready;
+  wrsp_t wrsp;
+
+  /////////////////
+  // Arbitration //
+  /////////////////
+
+  logic [NumPorts-1:0][AxQoSWidth-1:0] waddr_qos;
+  logic [NumPorts-1:0][AxQoSWidth-1:0] raddr_qos;
+
+  for (genvar i_port = 0; i_port < NumPorts; i_port = i_port + 1) begin : gen_qos
+    assign waddr_qos[i_port] = waddr_i[i_port].qos;
+    assign raddr_qos[i_port] = raddr_i[i_port].qos;
+  end : gen_qos
+
+  logic [PortIdW-1:0] waddr_gnt_idx;
+  logic [PortIdW-1:0] raddr_gnt_idx;
+
+  // Write address arbitration is blocked if the write data routing FIFO is full.
+  logic waddr_arb_valid;
+  logic waddr_arb_ready;
+  logic wroute_full;
+
+  assign waddr_valid = waddr_arb_valid & ~wroute_full;
+  assign waddr_arb_ready = waddr_ready & ~wroute_full;
+
+  simmem_arbiter #(
+      .NumPorts(NumPorts),
+      .Mode    (ArbMode),
+      .Weights (ArbWeights)
+  ) i_simmem_waddr_arbiter (
+      .clk_i    (clk_i),
+      .rst_ni   (rst_ni),
+      .valid_i  (waddr_in_valid_i),
+      .qos_i    (waddr_qos),
+      .valid_o  (waddr_arb_valid),
+      .ready_i  (waddr_arb_ready),
+      .gnt_idx_o(waddr_gnt_idx)
+  );
+
+  simmem_arbiter #(
+      .NumPorts(NumPorts),
+      .Mode    (ArbMode),
+      .Weights (ArbWeights)
+  ) i_simmem_raddr_arbiter (
+      .clk_i    (clk_i),
+      .rst_ni   (rst_ni),
+      .valid_i  (raddr_in_valid_i),
+      .qos_i    (raddr_qos),
+      .valid_o  (raddr_valid),
+      .ready_i  (raddr_ready),
+      .gnt_idx_o(raddr_gnt_idx)
+  );
+
+  // Address request multiplexing and identifier tagging.
+  always_comb begin
+    waddr = waddr_i[waddr_gnt_idx];
+    waddr.id[IDWidth-1 -: PortIdW] = waddr_gnt_idx;
+    raddr = raddr_i[raddr_gnt_idx];
+    raddr.id[IDWidth-1 -: PortIdW] = raddr_gnt_idx;
+  end
+
+  for (genvar i_port = 0; i_port < NumPorts; i_port = i_port + 1) begin : gen_addr_ready
+    assign waddr_in_ready_o[i_port] = waddr_arb_ready && waddr_gnt_idx == PortIdW'(i_port);
+    assign raddr_in_ready_o[i_port] = raddr_ready && raddr_gnt_idx == PortIdW'(i_port);
+  end : gen_addr_ready
+
+  ////////////////////////
+  // Write data routing //
+  ////////////////////////
+
+  typedef struct packed {
+    logic [PortIdW-1:0] port;
+    logic [XBurstEffLenW-1:0] burst_len;  // Effective burst length
+  } wdata_route_t;
+
+  localparam int unsigned WRouteDepth = WRspBankCapa;
+  localparam int unsigned WRoutePtrW = WRouteDepth == 1 ? 1 : $clog2(WRouteDepth);
+
+  wdata_route_t wroute_q[WRouteDepth];
+  logic [WRoutePtrW-1:0] wroute_rptr_q, wroute_rptr_d;
+  logic [WRoutePtrW-1:0] wroute_wptr_q, wroute_wptr_d;
+  logic [WRoutePtrW:0] wroute_len_q, wroute_len_d;
+  // Number of write data already forwarded for the burst at the head of the FIFO.
+  logic [XBurstEffLenW-1:0] wroute_beat_cnt_q, wroute_beat_cnt_d;
+
+  logic wroute_push;
+  logic wroute_pop;
+  logic wdata_handshake;
+  logic [PortIdW-1:0] wdata_port;
+
+  assign wroute_full = wroute_len_q == (WRoutePtrW + 1)'(WRouteDepth);
+  assign wroute_push = waddr_valid & waddr_ready;
+  assign wdata_handshake = wdata_valid & wdata_ready;
+  assign wdata_port = wroute_q[wroute_rptr_q].port;
+  assign wroute_pop = wdata_handshake &&
+      (wroute_beat_cnt_q + XBurstEffLenW'(1)) == wroute_q[wroute_rptr_q].burst_len;
+
+  always_comb begin
+    wroute_rptr_d = wroute_rptr_q;
+    wroute_wptr_d = wroute_wptr_q;
+    wroute_len_d = wroute_len_q;
+    wroute_beat_cnt_d = wroute_beat_cnt_q;
+
+    if (wroute_push) begin
+      wroute_wptr_d = wroute_wptr_q == WRoutePtrW'(WRouteDepth - 1) ? '0 :
+          wroute_wptr_q + WRoutePtrW'(1);
+      wroute_len_d = wroute_len_d + 1;
+    end
+
+    if (wroute_pop) begin
+      wroute_rptr_d = wroute_rptr_q == WRoutePtrW'(WRouteDepth - 1) ? '0 :
+          wroute_rptr_q + WRoutePtrW'(1);
+      wroute_len_d = wroute_len_d - 1;
+      wroute_beat_cnt_d = '0;
+    end else if (wdata_handshake) begin
+      wroute_beat_cnt_d = wroute_beat_cnt_q + XBurstEffLenW'(1);
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      wroute_q <= '{default: '0};
+      wroute_rptr_q <= '0;
+      wroute_wptr_q <= '0;
+      wroute_len_q <= '0;
+      wroute_beat_cnt_q <= '0;
+    end else begin
+      if (wroute_push) begin
+        wroute_q[wroute_wptr_q].port <= waddr_gnt_idx;
+        wroute_q[wroute_wptr_q].burst_len <= get_effective_burst_len(waddr.burst_len);
+      end
+      wroute_rptr_q <= wroute_rptr_d;
+      wroute_wptr_q <= wroute_wptr_d;
+      wroute_len_q <= wroute_len_d;
+      wroute_beat_cnt_q <= wroute_beat_cnt_d;
+    end
+  end
+
+  assign wdata_valid = |wroute_len_q & wdata_in_valid_i[wdata_port];
+
+  for (genvar i_port = 0; i_port < NumPorts; i_port = i_port + 1) begin : gen_wdata_ready
+    assign wdata_in_ready_o[i_port] =
+        |wroute_len_q && wdata_ready && wdata_port == PortIdW'(i_port);
+  end : gen_wdata_ready
+
+  //////////////////////
+  // Response routing //
+  //////////////////////
+
+  logic [PortIdW-1:0] rdata_port;
+  logic [PortIdW-1:0] wrsp_port;
+
+  assign rdata_port = rdata.all_fields.id[IDWidth-1 -: PortIdW];
+  assign wrsp_port = wrsp.merged_payload.id[IDWidth-1 -: PortIdW];
+
+  assign rdata_ready = rdata_out_ready_i[rdata_port];
+  assign wrsp_ready = wrsp_out_ready_i[wrsp_port];
+
+  for (genvar i_port = 0; i_port < NumPorts; i_port = i_port + 1) begin : gen_rsp_routing
+    assign rdata_out_valid_o[i_port] = rdata_valid && rdata_port == PortIdW'(i_port);
+    assign wrsp_out_valid_o[i_port] = wrsp_valid && wrsp_port == PortIdW'(i_port);
+
+    // Clear the port tag in the delivered responses.
+    always_comb begin
+      rdata_o[i_port] = rdata;
+      rdata_o[i_port].all_fields.id[IDWidth-1 -: PortIdW] = '0;
+      wrsp_o[i_port] = wrsp;
+      wrsp_o[i_port].merged_payload.id[IDWidth-1 -: PortIdW] = '0;
+    end
+  end : gen_rsp_routing
+
+  //////////////////////////////////////////
+  // Simulated memory controller instance //
+  //////////////////////////////////////////
+
+  simmem_top i_simmem_top (
+      .clk_i                  (clk_i),
+      .rst_ni                 (rst_ni),
+      .raddr_in_valid_i       (raddr_valid),
+      .raddr_in_ready_o       (raddr_ready),
+      .raddr_i                (raddr),
+      .waddr_in_valid_i       (waddr_valid),
+      .waddr_in_ready_o       (waddr_ready),
+      .waddr_i                (waddr),
+      .wdata_in_valid_i       (wdata_valid),
+      .wdata_in_ready_o       (wdata_ready),
+      .wdata_i                (wdata_i[wdata_port]),
+      .rdata_out_ready_i      (rdata_ready),
+      .rdata_out_valid_o      (rdata_valid),
+      .rdata_o                (rdata),
+      .wrsp_out_ready_i       (wrsp_ready),
+      .wrsp_out_valid_o       (wrsp_valid),
+      .wrsp_o                 (wrsp),
+      .waddr_out_ready_i      (waddr_out_ready_i),
+      .waddr_out_valid_o      (waddr_out_valid_o),
+      .waddr_o                (waddr_o),
+      .raddr_out_ready_i      (raddr_out_ready_i),
+      .raddr_out_valid_o      (raddr_out_valid_o),
+      .raddr_o                (raddr_o),
+      .wdata_out_ready_i      (wdata_out_ready_i),
+      .wdata_out_valid_o      (wdata_out_valid_o),
+      .wdata_o                (wdata_o),
+      .rdata_in_valid_i       (rdata_in_valid_i),
+      .rdata_in_ready_o       (rdata_in_ready_o),
+      .rdata_i                (rdata_i),
+      .wrsp_in_valid_i        (wrsp_in_valid_i),
+      .wrsp_in_ready_o        (wrsp_in_ready_o),
+      .wrsp_i                 (wrsp_i),
+      .cfg_valid_i            (cfg_valid_i),
+      .cfg_addr_i             (cfg_addr_i),
+      .cfg_wdata_i            (cfg_wdata_i),
+      .perf_cnts_o            (perf_cnts_o),
+      .dbg_wrsv_iid_o         (),
+      .dbg_rrsv_iid_o         (),
+      .dbg_wrsp_issued_mhot_o (),
+      .dbg_rdata_issued_mhot_o(),
+      .dbg_wrsp_done_mhot_o   (),
+      .dbg_rdata_done_mhot_o  (),
+      .dbg_wslt_v_mhot_o      (),
+      .dbg_rslt_v_mhot_o      (),
+      .dbg_wrsv_len_o         (),
+      .dbg_wrsp_len_o         (),
+      .dbg_rrsv_len_o         (),
+      .dbg_rdata_len_o        ()
+  );
+
+endmodule
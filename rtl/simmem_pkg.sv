@@ -9,9 +9,14 @@
 //  * AXI signals structure definitions
 //  * Helper function definitions
 //
-// Only the first of the three parts should be modified for configuration.
+// Only the first of the three parts should be modified for configuration. The most commonly swept
+// parameters take their values from the SIMMEM_* macros of simmem_config.svh, which can be
+// overridden at build time without editing this package.
 //
-// Parameters must match those in dv/simmem_top/simmem_axi_dimensions.h
+// The C++ testbenches read the parameters from simmem_axi_dimensions.h, which is generated from
+// this package (see util/gen_simmem_axi_dimensions.py).
+
+`include "simmem_config.svh"
 
 package simmem_pkg;
 
@@ -19,24 +24,79 @@ package simmem_pkg;
   // Simmem parameters //
   ///////////////////////
 
-  // The capacity of the global memory
-  parameter int unsigned GlobalMemCapaW = 19; // Width
+  // The width of the capacity of the global memory, and the capacity.
+  parameter int unsigned GlobalMemCapaW /*verilator public*/ = `SIMMEM_GLOBAL_MEM_CAPA_W;
   parameter int unsigned GlobalMemCapa = 1 << GlobalMemCapaW;  // Bytes.
 
   // The log2 of the bank row length.
-  parameter int unsigned RowBufLenW = 10;
+  parameter int unsigned RowBufLenW /*verilator public*/ = `SIMMEM_ROW_BUF_LEN_W;
   // The number of MSBs that uniquely define a bank row in an address.
   parameter int unsigned RowIdWidth = GlobalMemCapaW - RowBufLenW;
 
-  parameter int unsigned RowHitCost = 4;  // Cycles (must be at least 3)
-  parameter int unsigned PrechargeCost = 2;  // Cycles
-  parameter int unsigned ActivationCost = 1;  // Cycles
+  // Address mapping: an address is split into a row, a rank and a column field. The column field
+  // is always RowBufLenW bits wide. The enumeration names give the field order, from MSB to LSB,
+  // except that ADDR_MAP_ROW_COL_RANK keeps the byte offset in a beat below the rank field.
+  typedef enum logic [1:0] {
+    ADDR_MAP_ROW_RANK_COL = 0,
+    ADDR_MAP_RANK_ROW_COL = 1,
+    ADDR_MAP_ROW_COL_RANK = 2
+  } addr_map_e;
+
+  // The number of ranks, i.e., of independently scheduled row buffers. Must be a power of two.
+  parameter int unsigned NumRanks /*verilator public*/ = `SIMMEM_NUM_RANKS;
+  parameter addr_map_e AddrMapScheme /*verilator public*/ = addr_map_e'(`SIMMEM_ADDR_MAP_SCHEME);
+  // If set, the rank field is XORed with the row field LSBs (permutation-based interleaving), which
+  // spreads row conflicts across the ranks.
+  parameter bit AddrMapXorHash /*verilator public*/ = `SIMMEM_ADDR_MAP_XOR_HASH;
+
+  // Clock periods of the AXI fabric (clk_i) and of the emulated memory. The costs below are
+  // expressed in memory clock cycles and converted to clk_i cycles by the delay calculator, so
+  // changing the fabric clock only requires updating ClkPeriodPs. Both are in picoseconds.
+  parameter int unsigned ClkPeriodPs /*verilator public*/ = `SIMMEM_CLK_PERIOD_PS;
+  parameter int unsigned MemClkPeriodPs /*verilator public*/ = `SIMMEM_MEM_CLK_PERIOD_PS;
+
+  // Row buffer policy: the open-page policy keeps the rows open until a conflicting access. The
+  // closed-page policy precharges the row at the end of each access. The adaptive policy closes a
+  // row after RowIdleTimeout idle memory cycles or, if RowPolicyPredictor is set, right after an
+  // access when a per-rank 2-bit saturating counter predicts that the next access will not hit the
+  // row.
+  typedef enum logic [1:0] {
+    ROW_POLICY_OPEN = 0,
+    ROW_POLICY_CLOSED = 1,
+    ROW_POLICY_ADAPTIVE = 2
+  } row_policy_e;
+
+  parameter row_policy_e RowPolicy /*verilator public*/ = row_policy_e'(`SIMMEM_ROW_POLICY);
+  parameter int unsigned RowIdleTimeout = 16;  // Memory cycles, must be positive
+  parameter bit RowPolicyPredictor = 1'b0;
+
+  // Command costs, in memory cycles. RowHitCost must be at least 3 clk_i cycles.
+  parameter int unsigned RowHitCost /*verilator public*/ = `SIMMEM_ROW_HIT_COST;
+  parameter int unsigned PrechargeCost /*verilator public*/ = `SIMMEM_PRECHARGE_COST;
+  parameter int unsigned ActivationCost /*verilator public*/ = `SIMMEM_ACTIVATION_COST;
+
+  // Inter-command constraints, shared by all the ranks, in memory cycles. A zero value disables the
+  // corresponding constraint.
+  // tRRD: minimal delay between two activations
+  parameter int unsigned ActToActCost /*verilator public*/ = `SIMMEM_ACT_TO_ACT_COST;
+  // tFAW: window containing at most 4 activations
+  parameter int unsigned FourActWindowCost /*verilator public*/ = `SIMMEM_FOUR_ACT_WINDOW_COST;
+  // tWTR: minimal delay from a write to a read access
+  parameter int unsigned WrToRdCost /*verilator public*/ = `SIMMEM_WR_TO_RD_COST;
+  // tRTW: minimal delay from a read to a write access
+  parameter int unsigned RdToWrCost /*verilator public*/ = `SIMMEM_RD_TO_WR_COST;
+
+  // Number of clk_i cycles per memory clock cycle, in fixed point with MemClkRatioFracW fractional
+  // bits. The fractional parts of the delays are accumulated per rank, so no time is lost over
+  // consecutive requests.
+  parameter int unsigned MemClkRatioFracW = 8;
+  parameter int unsigned MemClkRatio = (MemClkPeriodPs << MemClkRatioFracW) / ClkPeriodPs;
 
   // Log2 of the boundary that cannot be crossed by bursts.
   parameter int unsigned BurstAddrLSBs = 12;
 
   // Maximal value of any burst_size field, must be positive.
-  parameter int unsigned MaxBurstSizeField = 2;
+  parameter int unsigned MaxBurstSizeField /*verilator public*/ = `SIMMEM_MAX_BURST_SIZE_FIELD;
 
   // Effective max burst size (in number of elements)
   parameter int unsigned MaxBurstEffSizeBytes = 1 << MaxBurstSizeField;
@@ -45,7 +105,8 @@ package simmem_pkg;
   parameter int unsigned WStrbWidth = MaxBurstEffSizeBytes;
 
   // Maximal allowed burst length field value, must be positive.
-  parameter int unsigned MaxBurstLenField = 3; // Must be of the form 2^n-1
+  // Must be of the form 2^n-1
+  parameter int unsigned MaxBurstLenField /*verilator public*/ = `SIMMEM_MAX_BURST_LEN_FIELD;
   parameter int unsigned MaxBurstLenFieldW = $clog2(MaxBurstLenField); // Width
 
   // Effective max burst length (in number of elements)
@@ -57,8 +118,8 @@ package simmem_pkg;
   localparam int unsigned XBurstEffLenW = $clog2(MaxBurstEffLen + 1);
 
   // Capacities in extended cells (number of outstanding bursts).
-  parameter int unsigned WRspBankCapa = 3;
-  parameter int unsigned RDataBankCapa = 2;
+  parameter int unsigned WRspBankCapa /*verilator public*/ = `SIMMEM_WRSP_BANK_CAPA;
+  parameter int unsigned RDataBankCapa /*verilator public*/ = `SIMMEM_RDATA_BANK_CAPA;
 
   parameter int unsigned WRspBankAddrW = $clog2(WRspBankCapa);
   parameter int unsigned RDataBankAddrW = $clog2(RDataBankCapa);
@@ -68,17 +129,113 @@ package simmem_pkg;
   typedef logic [RDataBankAddrW-1:0] read_iid_t;
 
   // Delay calculator slot constants definition.
-  parameter int unsigned NumWSlots = WRspBankCapa;
-  parameter int unsigned NumRSlots = RDataBankCapa;
-
+  parameter int unsigned NumWSlots /*verilator public*/ = `SIMMEM_NUM_WSLOTS;
+  parameter int unsigned NumRSlots /*verilator public*/ = `SIMMEM_NUM_RSLOTS;
+
+  // Latency scaling, for sensitivity sweeps: the row buffer delay calculator multiplies each request
+  // cost by the runtime-programmable scale, in fixed point with LatScaleFracW fractional bits, and
+  // adds the runtime-programmable offset, in clk_i cycles (see the register map below).
+  parameter int unsigned LatScaleW = 12;
+  parameter int unsigned LatScaleFracW = 8;
+  parameter int unsigned LatOffsetW = 8;
+
+  // Maximal delay of a single memory request, measured in clk_i cycles (rounded up).
+  parameter int unsigned MaxDelay = ((RowHitCost + PrechargeCost + ActivationCost) * MemClkRatio +
+      (1 << MemClkRatioFracW) - 1) >> MemClkRatioFracW;
+  // Maximal delay of a single memory request with the maximal scale and offset, including one cycle
+  // for the carried fractional part.
+  parameter int unsigned MaxScaledDelay = ((MaxDelay * ((1 << LatScaleW) - 1) +
+      (1 << LatScaleFracW) - 1) >> LatScaleFracW) + (1 << LatOffsetW);
   // Maximal bit width on which to encode a delay.(measured in clock cycles).
-  parameter int unsigned DelayW = $clog2(RowHitCost + PrechargeCost + ActivationCost);  // bits
+  // Delays are never lower than 3 cycles.
+  parameter int unsigned DelayW = $clog2((MaxScaledDelay < 3 ? 3 : MaxScaledDelay) + 1);  // bits
+
+  // Width of the performance counters.
+  parameter int unsigned PerfCntW = 32;
+
+  // Performance counters exported by the delay calculator, indexing perf_cnts_o. The command counters
+  // give the number of emulated DRAM commands (PERF_CNT_PRE only counts the precharges due to row
+  // conflicts), and the standby counters give the number of rank-cycles with an open row (active
+  // standby) or with all rows closed (precharge standby).
+  typedef enum int unsigned {
+    PERF_CNT_ACT = 0,
+    PERF_CNT_PRE = 1,
+    PERF_CNT_RD_CAS = 2,
+    PERF_CNT_WR_CAS = 3,
+    PERF_CNT_ACT_STBY_CYCLES = 4,
+    PERF_CNT_PRE_STBY_CYCLES = 5,
+    PERF_CNT_POLICY_PRE = 6,  // Precharges issued by the row buffer policy
+    // Rank-cycles where the optimal entry of an idle rank is stalled by an inter-command constraint
+    PERF_CNT_STALL_RRD = 7,
+    PERF_CNT_STALL_FAW = 8,
+    PERF_CNT_STALL_WTR = 9,
+    PERF_CNT_STALL_RTW = 10
+  } perf_cnt_e;
+  parameter int unsigned NumPerfCnts = 11;
+
+  // Default number of requester ports of simmem_multiport_top, between 2 and NumIds/2, and the
+  // number of identifier MSBs which tag the port.
+  parameter int unsigned NumPorts /*verilator public*/ = `SIMMEM_NUM_PORTS;
+  parameter int unsigned PortIdW = $clog2(NumPorts);
+
+  // Arbitration between the requester ports of simmem_multiport_top.
+  typedef enum logic [1:0] {
+    ARB_ROUND_ROBIN = 0,
+    ARB_WEIGHTED = 1,  // Round-robin, with up to Weights[port] consecutive grants per port.
+    ARB_QOS = 2  // Highest AxQOS first, round-robin among equal AxQOS values.
+  } arb_mode_e;
+
+  // Width of the arbitration weights.
+  parameter int unsigned ArbWeightW = 4;
+
+  // Delay engine of the delay calculator:
+  //  * DELAY_ENGINE_ROW_BUF: the row buffer model of simmem_delay_calculator_core.
+  //  * DELAY_ENGINE_STAT: the latency of each request is drawn from a runtime-programmable
+  //    distribution (see simmem_delay_calculator_stat).
+  //  * DELAY_ENGINE_FIXED: each request has a fixed latency, depending on its direction (see
+  //    simmem_delay_calculator_fixed).
+  typedef enum logic [1:0] {
+    DELAY_ENGINE_ROW_BUF = 0,
+    DELAY_ENGINE_STAT = 1,
+    DELAY_ENGINE_FIXED = 2
+  } delay_engine_e;
+
+  parameter delay_engine_e DelayEngine /*verilator public*/ =
+      delay_engine_e'(`SIMMEM_DELAY_ENGINE);
+
+  // Fixed-latency delay engine. The write latency is measured from the last write data, and the read
+  // latency from the read address request.
+  parameter int unsigned FixedWLat = 20;  // Cycles
+  parameter int unsigned FixedRLat = 20;  // Cycles
+
+  // Statistical delay engine. The distribution is a table of StatNumBins (cumulative probability,
+  // latency) pairs, where the cumulative probabilities are StatLfsrW-bit fractions of one.
+  parameter int unsigned StatNumBins = 8;
+  parameter int unsigned StatLatW = 8;  // Width of a latency, in clk_i cycles
+  parameter int unsigned StatLfsrW = 16;
+  // Feedback polynomial of the Galois LFSR (x^16 + x^14 + x^13 + x^11 + 1, maximal length).
+  parameter logic [StatLfsrW-1:0] StatLfsrTaps = 16'hB400;
+  parameter logic [StatLfsrW-1:0] StatLfsrSeed = 16'hACE1;  // Must not be zero
+  // Latency of all the bins at reset. The reset cumulative probabilities are uniform.
+  parameter int unsigned StatResetLat = 16;  // Cycles
+
+  // Runtime configuration port, common to all the delay engines. A register is written when
+  // cfg_valid_i is set and cfg_addr_i matches its address. Writes to other addresses are ignored.
+  parameter int unsigned CfgAddrW = 8;
+  parameter int unsigned CfgDataW = 32;
+
+  // Register map (addresses of the configuration registers).
+  parameter logic [CfgAddrW-1:0] CfgStatCdfBase = 8'h00;  // StatNumBins cumulative probabilities
+  parameter logic [CfgAddrW-1:0] CfgStatLatBase = 8'h20;  // StatNumBins latencies
+  parameter logic [CfgAddrW-1:0] CfgStatSeed = 8'h40;  // Writing the seed restarts the LFSR
+  parameter logic [CfgAddrW-1:0] CfgLatScale = 8'h48;  // LatScaleW bits, one at reset
+  parameter logic [CfgAddrW-1:0] CfgLatOffset = 8'h49;  // LatOffsetW bits, zero at reset
 
   /////////////////
   // AXI signals //
   /////////////////
 
-  parameter int unsigned IDWidth = 2;
+  parameter int unsigned IDWidth /*verilator public*/ = `SIMMEM_ID_WIDTH;
   parameter int unsigned NumIds = 1 << IDWidth;
 
   // Address field widths
@@ -156,7 +156,12 @@ module simmem_rsp_bank #(
     // Ready signal from the delay calculator
     input  logic delay_calc_ready_i,
     // Ready signal to the delay calculator
-    output logic delay_calc_ready_o
+    output logic delay_calc_ready_o,
+
+    // Debug outputs, only observed by the testbench (occupancy sampling): the lengths of the
+    // reservation and response queues of each AXI identifier.
+    output logic [BankAddrWidth:0] rsv_len_o[simmem_pkg::NumIds],
+    output logic [BankAddrWidth:0] rsp_len_o[simmem_pkg::NumIds]
 );
 
   import simmem_pkg::*;
@@ -265,6 +270,9 @@ module simmem_rsp_bank #(
   logic [LLLenWidth-1:0] rsp_len_d[NumIds];
   logic [LLLenWidth-1:0] rsp_len_q[NumIds];
 
+  assign rsv_len_o = rsv_len_q;
+  assign rsp_len_o = rsp_len_q;
+
   // Length after the potential output.
   logic [LLLenWidth-1:0] rsp_len_after_out[NumIds];
   // Determines whether the tail (or pre_tail) awaits the next burst data to release and can
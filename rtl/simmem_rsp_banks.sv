@@ -60,8 +60,14 @@ module simmem_rsp_banks (
 
     // Ready signals for the delay calculator
     output logic w_delay_calc_ready_o,
-    output logic r_delay_calc_ready_o
-
+    output logic r_delay_calc_ready_o,
+
+    // Debug outputs, only observed by the testbench: the lengths of the reservation and response
+    // queues of each AXI identifier.
+    output logic [ simmem_pkg::WRspBankAddrW:0] wrsv_len_o [simmem_pkg::NumIds],
+    output logic [ simmem_pkg::WRspBankAddrW:0] wrsp_len_o [simmem_pkg::NumIds],
+    output logic [simmem_pkg::RDataBankAddrW:0] rrsv_len_o [simmem_pkg::NumIds],
+    output logic [simmem_pkg::RDataBankAddrW:0] rdata_len_o[simmem_pkg::NumIds]
 );
 
   import simmem_pkg::*;
@@ -86,8 +92,9 @@ module simmem_rsp_banks (
       .out_rsp_ready_i       (w_out_rsp_ready_i),
       .out_rsp_valid_o       (w_out_rsp_valid_o),
       .delay_calc_ready_i    (w_delay_calc_ready_i),
-      .delay_calc_ready_o    (w_delay_calc_ready_o)
-
+      .delay_calc_ready_o    (w_delay_calc_ready_o),
+      .rsv_len_o             (wrsv_len_o),
+      .rsp_len_o             (wrsp_len_o)
   );
 
   simmem_rsp_bank #(
@@ -110,7 +117,9 @@ module simmem_rsp_banks (
       .out_rsp_ready_i       (r_out_data_ready_i),
       .out_rsp_valid_o       (r_out_data_valid_o),
       .delay_calc_ready_i    (r_delay_calc_ready_i),
-      .delay_calc_ready_o    (r_delay_calc_ready_o)
+      .delay_calc_ready_o    (r_delay_calc_ready_o),
+      .rsv_len_o             (rrsv_len_o),
+      .rsp_len_o             (rdata_len_o)
   );
 
 endmodule
@@ -57,7 +57,37 @@ module simmem_top (
 
     input  logic              wrsp_in_valid_i,
     output logic              wrsp_in_ready_o,
-    input  simmem_pkg::wrsp_t wrsp_i
+    input  simmem_pkg::wrsp_t wrsp_i,
+
+    // Configuration port of the delay calculator (see the register map in simmem_pkg)
+
+    input logic                            cfg_valid_i,
+    input logic [simmem_pkg::CfgAddrW-1:0] cfg_addr_i,
+    input logic [simmem_pkg::CfgDataW-1:0] cfg_wdata_i,
+
+    // Performance counters of the delay calculator, indexed by simmem_pkg::perf_cnt_e
+
+    output logic [simmem_pkg::PerfCntW-1:0] perf_cnts_o[simmem_pkg::NumPerfCnts],
+
+    // Debug port, only observed by the testbench (latency attribution)
+
+    // Internal identifiers reserved for the incoming address requests.
+    output logic [simmem_pkg::WRspBankAddrW-1:0] dbg_wrsv_iid_o,
+    output logic [simmem_pkg::RDataBankAddrW-1:0] dbg_rrsv_iid_o,
+    // Internal identifiers whose burst starts being served by the delay calculator, and whose burst
+    // completes, in the current cycle.
+    output logic [simmem_pkg::WRspBankCapa-1:0] dbg_wrsp_issued_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] dbg_rdata_issued_mhot_o,
+    output logic [simmem_pkg::WRspBankCapa-1:0] dbg_wrsp_done_mhot_o,
+    output logic [simmem_pkg::RDataBankCapa-1:0] dbg_rdata_done_mhot_o,
+    // Valid bits of the write and read slots of the delay calculator, and lengths of the
+    // reservation and response queues of each AXI identifier in the response banks.
+    output logic [simmem_pkg::NumWSlots-1:0] dbg_wslt_v_mhot_o,
+    output logic [simmem_pkg::NumRSlots-1:0] dbg_rslt_v_mhot_o,
+    output logic [simmem_pkg::WRspBankAddrW:0] dbg_wrsv_len_o[simmem_pkg::NumIds],
+    output logic [simmem_pkg::WRspBankAddrW:0] dbg_wrsp_len_o[simmem_pkg::NumIds],
+    output logic [simmem_pkg::RDataBankAddrW:0] dbg_rrsv_len_o[simmem_pkg::NumIds],
+    output logic [simmem_pkg::RDataBankAddrW:0] dbg_rdata_len_o[simmem_pkg::NumIds]
 );
 
   import simmem_pkg::*;
@@ -75,6 +105,9 @@ module simmem_top (
   logic [WRspBankAddrW-1:0] wrsv_iid;
   logic [RDataBankAddrW-1:0] rrsv_iid;
 
+  assign dbg_wrsv_iid_o = wrsv_iid;
+  assign dbg_rrsv_iid_o = rrsv_iid;
+
   // Reservation handshakes on the response banks
   logic wrsv_valid_in;
   logic rrsv_valid_in;
@@ -158,10 +191,16 @@ module simmem_top (
       .w_delay_calc_ready_i    (w_delay_calc_ready_in),
       .r_delay_calc_ready_i    (r_delay_calc_ready_in),
       .w_delay_calc_ready_o    (w_delay_calc_ready_out),
-      .r_delay_calc_ready_o    (r_delay_calc_ready_out)
+      .r_delay_calc_ready_o    (r_delay_calc_ready_out),
+      .wrsv_len_o              (dbg_wrsv_len_o),
+      .wrsp_len_o              (dbg_wrsp_len_o),
+      .rrsv_len_o              (dbg_rrsv_len_o),
+      .rdata_len_o             (dbg_rdata_len_o)
   );
 
-  simmem_delay_calculator i_simmem_delay_calculator (
+  simmem_delay_calculator #(
+      .NumRanks(NumRanks)
+  ) i_simmem_delay_calculator (
       .clk_i                      (clk_i),
       .rst_ni                     (rst_ni),
       .waddr_i                    (waddr_i),
@@ -181,7 +220,17 @@ module simmem_top (
       .wrsp_bank_ready_o          (w_delay_calc_ready_in),
       .rrsp_bank_ready_o          (r_delay_calc_ready_in),
       .wrsp_bank_ready_i          (w_delay_calc_ready_out),
-      .rrsp_bank_ready_i          (r_delay_calc_ready_out)
+      .rrsp_bank_ready_i          (r_delay_calc_ready_out),
+      .cfg_valid_i                (cfg_valid_i),
+      .cfg_addr_i                 (cfg_addr_i),
+      .cfg_wdata_i                (cfg_wdata_i),
+      .perf_cnts_o                (perf_cnts_o),
+      .wrsp_issued_mhot_o         (dbg_wrsp_issued_mhot_o),
+      .rdata_issued_mhot_o        (dbg_rdata_issued_mhot_o),
+      .wrsp_done_mhot_o           (dbg_wrsp_done_mhot_o),
+      .rdata_done_mhot_o          (dbg_rdata_done_mhot_o),
+      .wslt_v_mhot_o              (dbg_wslt_v_mhot_o),
+      .rslt_v_mhot_o              (dbg_rslt_v_mhot_o)
   );
 
 endmodule
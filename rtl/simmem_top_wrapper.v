@@ -5,10 +5,16 @@
 // Simulated memory controller top-level Verilog wrapper
 
 // This is a Verilog wrapper to integrate the module as a block in Xilinx Vivado.
+//
+// The parameters shared with simmem_pkg take their defaults from the SIMMEM_* macros of
+// simmem_config.svh. To change them, override the macros (for instance in the Verilog options of
+// the Vivado project), rather than the wrapper parameters, so that the package follows.
+
+`include "simmem_config.svh"
 
 module simmem_top_wrapper #(
     // Width of the main memory capacity, i.e., of an address in main memory.
-    parameter GlobalMemCapaW = 19,
+    parameter GlobalMemCapaW = `SIMMEM_GLOBAL_MEM_CAPA_W,
     // Main memory capacity, in bytes.
     parameter GlobalMemCapa = 1 << GlobalMemCapaW,
 
@@ -16,7 +22,7 @@ module simmem_top_wrapper #(
     // AXI signals //
     /////////////////
 
-    parameter IDWidth = 2,
+    parameter IDWidth = `SIMMEM_ID_WIDTH,
     parameter NumIds = 1 << IDWidth,
     // No ID tag in the write data
     parameter WIDWidth = 0,
@@ -35,7 +41,7 @@ module simmem_top_wrapper #(
     parameter ArUserWidth = 0,
 
     // Data & response field widths
-    parameter MaxBurstSizeField = 2,
+    parameter MaxBurstSizeField = `SIMMEM_MAX_BURST_SIZE_FIELD,
     parameter MaxBurstEffSizeBytes = 1 << MaxBurstSizeField,
     parameter MaxBurstEffSizeBits = MaxBurstEffSizeBytes * 8,
 
@@ -51,11 +57,28 @@ module simmem_top_wrapper #(
     parameter ReadAddrWidth  = IDWidth + AxAddrWidth + AxLenWidth + AxSizeWidth + AxBurstWidth + AxLockWidth + AxCacheWidth + AxProtWidth + AxRegionWidth + AxQoSWidth,// + AxUserWidth,
     parameter WriteDataWidth = MaxBurstEffSizeBits + WStrbWidth + XLastWidth,
     parameter ReadDataWidth  = IDWidth + MaxBurstEffSizeBits + XRespWidth-1 + XLastWidth,
-    parameter WriteRespWidth = IDWidth + XRespWidth-1
+    parameter WriteRespWidth = IDWidth + XRespWidth-1,
+
+    // Configuration port widths
+    parameter CfgAddrW = 8,
+    parameter CfgDataW = 32,
+
+    // Performance counter dimensions, must match simmem_pkg
+    parameter PerfCntW = 32,
+    parameter NumPerfCnts = 11
   ) (
     input clk_i,
     input rst_ni,
 
+    // Configuration port of the delay calculator (see the register map in simmem_pkg)
+    input                cfg_valid_i,
+    input [CfgAddrW-1:0] cfg_addr_i,
+    input [CfgDataW-1:0] cfg_wdata_i,
+
+    // Performance counters of the delay calculator, concatenated: the counter of index i in
+    // simmem_pkg::perf_cnt_e is perf_cnts_o[i*PerfCntW+:PerfCntW].
+    output [NumPerfCnts*PerfCntW-1:0] perf_cnts_o,
+
     // Normally AXI is automatically inferred.  However, if the names of
     // your ports do not match, you can force the
     // the creation of an interface and map the physical ports to the
@@ -301,6 +324,14 @@ module simmem_top_wrapper #(
   wire [WriteRespWidth-1:0] s_wrsp_internal;
   wire [WriteRespWidth-1:0] m_wrsp_internal;
 
+  // Performance counters, in the order of simmem_pkg::perf_cnt_e.
+  wire [PerfCntW-1:0] perf_cnts[0:NumPerfCnts-1];
+
+  genvar i_cnt;
+  for (i_cnt = 0; i_cnt < NumPerfCnts; i_cnt = i_cnt + 1) begin : gen_perf_cnts
+    assign perf_cnts_o[i_cnt*PerfCntW+:PerfCntW] = perf_cnts[i_cnt];
+  end
+
   assign s_waddr_internal[0+:IDWidth] = s_awid;
   assign m_waddr_internal[0+:IDWidth] = m_awid;
   assign s_waddr_internal[IDWidth+:AxAddrWidth] = s_awaddr;
@@ -369,38 +400,55 @@ module simmem_top_wrapper #(
   assign m_wrsp_internal[IDWidth+:XRespWidth-1] = m_bresp;
 
   simmem_top i_simmem_top (
-      .clk_i            (clk_i),
-      .rst_ni           (rst_ni),
-      .raddr_in_valid_i (s_arvalid),
-      .raddr_out_ready_i(m_arready),
-      .raddr_in_ready_o (s_arready),
-      .raddr_out_valid_o(m_arvalid),
-      .waddr_in_valid_i (s_awvalid),
-      .waddr_out_ready_i(m_awready),
-      .waddr_in_ready_o (s_awready),
-      .waddr_out_valid_o(m_awvalid),
-      .wdata_in_valid_i (s_wvalid),
-      .wdata_out_ready_i(m_wready),
-      .wdata_in_ready_o (s_wready),
-      .wdata_out_valid_o(m_wvalid),
-      .rdata_in_valid_i (m_rvalid),
-      .rdata_out_ready_i(s_rready),
-      .rdata_in_ready_o (m_rready),
-      .rdata_out_valid_o(s_rvalid),
-      .wrsp_in_valid_i  (m_bvalid),
-      .wrsp_out_ready_i (s_bready),
-      .wrsp_in_ready_o  (m_bready),
-      .wrsp_out_valid_o (s_bvalid),
-      .raddr_i          (s_raddr_internal),
-      .waddr_i          (s_waddr_internal),
-      .wdata_i          (s_wdata_internal),
-      .rdata_i          (m_rdata_internal),
-      .wrsp_i           (m_wrsp_internal),
-      .raddr_o          (m_raddr_internal),
-      .waddr_o          (m_waddr_internal),
-      .wdata_o          (m_wdata_internal),
-      .rdata_o          (s_rdata_internal),
-      .wrsp_o           (s_wrsp_internal)
+      .clk_i                  (clk_i),
+      .rst_ni                 (rst_ni),
+      .raddr_in_valid_i       (s_arvalid),
+      .raddr_out_ready_i      (m_arready),
+      .raddr_in_ready_o       (s_arready),
+      .raddr_out_valid_o      (m_arvalid),
+      .waddr_in_valid_i       (s_awvalid),
+      .waddr_out_ready_i      (m_awready),
+      .waddr_in_ready_o       (s_awready),
+      .waddr_out_valid_o      (m_awvalid),
+      .wdata_in_valid_i       (s_wvalid),
+      .wdata_out_ready_i      (m_wready),
+      .wdata_in_ready_o       (s_wready),
+      .wdata_out_valid_o      (m_wvalid),
+      .rdata_in_valid_i       (m_rvalid),
+      .rdata_out_ready_i      (s_rready),
+      .rdata_in_ready_o       (m_rready),
+      .rdata_out_valid_o      (s_rvalid),
+      .wrsp_in_valid_i        (m_bvalid),
+      .wrsp_out_ready_i       (s_bready),
+      .wrsp_in_ready_o        (m_bready),
+      .wrsp_out_valid_o       (s_bvalid),
+      .raddr_i                (s_raddr_internal),
+      .waddr_i                (s_waddr_internal),
+      .wdata_i                (s_wdata_internal),
+      .rdata_i                (m_rdata_internal),
+      .wrsp_i                 (m_wrsp_internal),
+      .raddr_o                (m_raddr_internal),
+      .waddr_o                (m_waddr_internal),
+      .wdata_o                (m_wdata_internal),
+      .rdata_o                (s_rdata_internal),
+      .wrsp_o                 (s_wrsp_internal),
+      .cfg_valid_i            (cfg_valid_i),
+      .cfg_addr_i             (cfg_addr_i),
+      .cfg_wdata_i            (cfg_wdata_i),
+      .perf_cnts_o            (perf_cnts),
+      // The debug port is only observed by the testbench.
+      .dbg_wrsv_iid_o         (),
+      .dbg_rrsv_iid_o         (),
+      .dbg_wrsp_issued_mhot_o (),
+      .dbg_rdata_issued_mhot_o(),
+      .dbg_wrsp_done_mhot_o   (),
+      .dbg_rdata_done_mhot_o  (),
+      .dbg_wslt_v_mhot_o      (),
+      .dbg_rslt_v_mhot_o      (),
+      .dbg_wrsv_len_o         (),
+      .dbg_wrsp_len_o         (),
+      .dbg_rrsv_len_o         (),
+      .dbg_rdata_len_o        ()
   );
 
 endmodule
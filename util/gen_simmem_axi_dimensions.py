@@ -0,0 +1,504 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Generates simmem_axi_dimensions.h from rtl/simmem_pkg.sv.
+
+The header contains the package parameters and enumerations as constexpr
+values, as well as the bit layout (offset and width of each field) of the
+packed AXI message structures, so that the C++ testbenches always match the
+RTL configuration.
+
+Standalone usage:
+
+  util/gen_simmem_axi_dimensions.py rtl/simmem_pkg.sv -o simmem_axi_dimensions.h
+
+Parameters can be overridden with -D Name=Value, for instance when sweeping a
+configuration, in which case the RTL must be built with the same overrides.
+Name is either a package parameter, or a SIMMEM_* macro of simmem_config.svh.
+
+The script can also be invoked as a FuseSoC generator, with the path to the
+generator configuration file as single argument (see simmem.core). In this
+mode, the SIMMEM_DEFINES environment variable may hold whitespace-separated
+Name=Value overrides, so that the generated header follows the macros passed to
+FuseSoC.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# C++ structures and the SystemVerilog packed structures they represent. The
+# field names differ when the C++ testbenches use shorter names.
+MESSAGES = [
+    ('WriteAddress', 'waddr_t', {
+        'memory_type': 'mem_type',
+        'protection_type': 'prot'
+    }),
+    ('ReadAddress', 'raddr_t', {
+        'memory_type': 'mem_type',
+        'protection_type': 'prot'
+    }),
+    ('WriteData', 'wdata_t', {
+        'strobes': 'strb'
+    }),
+    ('ReadData', 'rdata_all_fields_t', {
+        'response': 'rsp'
+    }),
+    ('WriteResponse', 'wrsp_merged_payload_t', {
+        'payload': 'rsp'
+    }),
+]
+
+HEADER_NAME = 'simmem_axi_dimensions.h'
+
+##############################
+# Constant expression parser #
+##############################
+
+TOKEN_RE = re.compile(r"""
+    \s*(?:
+      (?P<sized>\d*\s*'[sS]?[bBoOdDhH]\s*[0-9a-fA-F_]+)|
+      (?P<num>\d[\d_]*)|
+      (?P<ident>\$?[A-Za-z_]\w*(?:::\w+)?)|
+      (?P<op><<|>>|<=|>=|==|!=|&&|\|\||[-+*/%()?:<>&|^~!'])
+    )""", re.VERBOSE)
+
+# Binary operators, from the lowest to the highest precedence.
+BINARY_OPS = [
+    {'||': lambda a, b: int(bool(a) or bool(b))},
+    {'&&': lambda a, b: int(bool(a) and bool(b))},
+    {'|': lambda a, b: a | b},
+    {'^': lambda a, b: a ^ b},
+    {'&': lambda a, b: a & b},
+    {'==': lambda a, b: int(a == b), '!=': lambda a, b: int(a != b)},
+    {
+        '<': lambda a, b: int(a < b),
+        '<=': lambda a, b: int(a <= b),
+        '>': lambda a, b: int(a > b),
+        '>=': lambda a, b: int(a >= b)
+    },
+    {'<<': lambda a, b: a << b, '>>': lambda a, b: a >> b},
+    {'+': lambda a, b: a + b, '-': lambda a, b: a - b},
+    {
+        '*': lambda a, b: a * b,
+        '/': lambda a, b: a // b,
+        '%': lambda a, b: a % b
+    },
+]
+
+
+def clog2(val):
+    """SystemVerilog $clog2."""
+    return 0 if val <= 1 else (val - 1).bit_length()
+
+
+def parse_sized(literal):
+    """Evaluates a sized literal, such as 16'hB400."""
+    base_chars = {'b': 2, 'o': 8, 'd': 10, 'h': 16}
+    match = re.match(r"(\d*)\s*'[sS]?([bBoOdDhH])\s*([0-9a-fA-F_]+)", literal)
+    val = int(match.group(3).replace('_', ''), base_chars[match.group(2).lower()])
+    if match.group(1):
+        val &= (1 << int(match.group(1))) - 1
+    return val
+
+
+class ExprEvaluator:
+    """Evaluates SystemVerilog constant expressions."""
+
+    def __init__(self, expr, symbols):
+        self.tokens = []
+        pos = 0
+        expr = expr.strip()
+        while pos < len(expr):
+            match = TOKEN_RE.match(expr, pos)
+            if not match or match.end() == pos:
+                raise ValueError('Cannot parse expression: {}'.format(expr))
+            self.tokens.append((match.lastgroup, match.group(match.lastgroup)))
+            pos = match.end()
+        self.pos = 0
+        self.expr = expr
+        self.symbols = symbols
+
+    def peek(self):
+        return self.tokens[self.pos][1] if self.pos < len(self.tokens) else None
+
+    def take(self, expected=None):
+        kind, val = self.tokens[self.pos]
+        if expected is not None and val != expected:
+            raise ValueError('Expected {} in expression: {}'.format(
+                expected, self.expr))
+        self.pos += 1
+        return kind, val
+
+    def evaluate(self):
+        val = self.ternary()
+        if self.pos != len(self.tokens):
+            raise ValueError('Trailing tokens in expression: {}'.format(
+                self.expr))
+        return val
+
+    def ternary(self):
+        cond = self.binary(0)
+        if self.peek() != '?':
+            return cond
+        self.take('?')
+        val_true = self.ternary()
+        self.take(':')
+        val_false = self.ternary()
+        return val_true if cond else val_false
+
+    def binary(self, level):
+        if level == len(BINARY_OPS):
+            return self.unary()
+        val = self.binary(level + 1)
+        while self.peek() in BINARY_OPS[level]:
+            _, op = self.take()
+            val = BINARY_OPS[level][op](val, self.binary(level + 1))
+        return val
+
+    def unary(self):
+        if self.peek() == '-':
+            self.take()
+            return -self.unary()
+        if self.peek() == '+':
+            self.take()
+            return self.unary()
+        if self.peek() == '!':
+            self.take()
+            return int(not self.unary())
+        return self.primary()
+
+    def primary(self):
+        kind, val = self.take()
+        if val == '(':
+            ret = self.ternary()
+            self.take(')')
+            return ret
+        if kind == 'sized':
+            return parse_sized(val)
+        if kind == 'num':
+            return int(val.replace('_', ''))
+        if kind == 'ident':
+            if val == '$clog2':
+                self.take('(')
+                ret = clog2(self.ternary())
+                self.take(')')
+                return ret
+            if self.peek() == "'":
+                # Cast, such as row_policy_e'(0): the type is ignored.
+                self.take("'")
+                self.take('(')
+                ret = self.ternary()
+                self.take(')')
+                return ret
+            name = val.split('::')[-1]
+            if name not in self.symbols:
+                raise ValueError('Unknown identifier {} in expression: {}'.format(
+                    name, self.expr))
+            return self.symbols[name]
+        raise ValueError('Unexpected token {} in expression: {}'.format(
+            val, self.expr))
+
+
+def evaluate(expr, symbols):
+    return ExprEvaluator(expr, symbols).evaluate()
+
+
+###################
+# Package parsing #
+###################
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.DOTALL)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def preprocess(text, include_dir, defines, overrides):
+    """Expands the includes and the macros of a source file.
+
+    The macro definitions are collected in defines. As the configuration
+    macros are only defined if they are not defined yet, the overrides take
+    precedence over the definitions of the sources.
+    """
+    text = strip_comments(text)
+
+    def expand_include(match):
+        with open(os.path.join(include_dir, match.group(1))) as inc_file:
+            return preprocess(inc_file.read(), include_dir, defines, overrides)
+
+    text = re.sub(r'`include\s+"([^"]+)"', expand_include, text)
+
+    for match in re.finditer(r'`define\s+(\w+)[ \t]*([^\n]*)', text):
+        name = match.group(1)
+        if name not in defines:
+            defines[name] = overrides.get(name, match.group(2).strip())
+    text = re.sub(r'`(define|ifndef|ifdef|endif|else)\b[^\n]*', '', text)
+
+    def expand_macro(match):
+        if match.group(1) not in defines:
+            raise ValueError('Undefined macro: `{}'.format(match.group(1)))
+        # Macro values may themselves refer to macros.
+        return re.sub(r'`(\w+)', expand_macro, defines[match.group(1)])
+
+    return re.sub(r'`(\w+)', expand_macro, text)
+
+
+def get_range_width(range_expr, symbols):
+    """Returns the width of a packed range, such as [AxLenWidth-1:0]."""
+    msb, lsb = range_expr.split(':')
+    return evaluate(msb, symbols) - evaluate(lsb, symbols) + 1
+
+
+class Package:
+    """Parameters, enumerations and packed structures of a package."""
+
+    def __init__(self, text, include_dir, overrides):
+        self.defines = {}
+        text = preprocess(text, include_dir, self.defines, overrides)
+        # Ordered lists of (name, value).
+        self.params = []
+        self.enums = []
+        # Symbol table for expression evaluation.
+        self.symbols = {}
+        # Widths of the enumeration types.
+        self.enum_widths = {}
+        # Packed structure bodies, parsed on demand.
+        self.struct_bodies = {}
+
+        decl_re = re.compile(
+            r'\b(?P<param>parameter|localparam)\s+(?P<ptype>[^=;]*?)\s*'
+            r'(?P<pname>\w+)\s*=\s*(?P<pval>[^;]+);|'
+            r'\btypedef\s+enum\s+(?P<etype>[^{]*)\{(?P<ebody>[^}]*)\}\s*'
+            r'(?P<ename>\w+)\s*;|'
+            r'\btypedef\s+struct\s+packed\s*\{(?P<sbody>[^}]*)\}\s*'
+            r'(?P<sname>\w+)\s*;', re.DOTALL)
+
+        unused_overrides = set(overrides) - set(self.defines)
+        for decl in decl_re.finditer(text):
+            if decl.group('param'):
+                name = decl.group('pname')
+                if name in overrides:
+                    val = evaluate(overrides[name], self.symbols)
+                    unused_overrides.discard(name)
+                else:
+                    val = evaluate(decl.group('pval'), self.symbols)
+                self.symbols[name] = val
+                self.params.append((name, val))
+            elif decl.group('ename'):
+                self.parse_enum(decl.group('ename'), decl.group('etype'),
+                                decl.group('ebody'))
+            else:
+                self.struct_bodies[decl.group('sname')] = decl.group('sbody')
+
+        if unused_overrides:
+            raise ValueError('Unknown parameters: {}'.format(', '.join(
+                sorted(unused_overrides))))
+
+    def parse_enum(self, name, enum_type, body):
+        range_match = re.search(r'\[([^\]]+)\]', enum_type)
+        if range_match:
+            self.enum_widths[name] = get_range_width(range_match.group(1),
+                                                     self.symbols)
+        else:
+            self.enum_widths[name] = 1 if 'logic' in enum_type else 32
+
+        items = []
+        next_val = 0
+        for item in body.split(','):
+            item = item.strip()
+            if not item:
+                continue
+            if '=' in item:
+                item_name, item_val = [s.strip() for s in item.split('=', 1)]
+                next_val = evaluate(item_val, self.symbols)
+            else:
+                item_name = item
+            items.append((item_name, next_val))
+            self.symbols[item_name] = next_val
+            next_val += 1
+        self.enums.append((name, items))
+
+    def get_struct_layout(self, struct_name):
+        """Returns the (name, offset, width) list of the fields of a packed
+        structure, from the least significant field."""
+        if struct_name not in self.struct_bodies:
+            raise ValueError('Unknown packed structure: {}'.format(struct_name))
+        fields = []
+        for field in self.struct_bodies[struct_name].split(';'):
+            field = field.strip()
+            if not field:
+                continue
+            match = re.match(r'logic\s*\[([^\]]+)\]\s*(\w+)$', field)
+            if match:
+                width = get_range_width(match.group(1), self.symbols)
+                fields.append((match.group(2), width))
+                continue
+            match = re.match(r'(\w+)\s+(\w+)$', field)
+            if match and match.group(1) in self.enum_widths:
+                fields.append((match.group(2),
+                               self.enum_widths[match.group(1)]))
+                continue
+            raise ValueError('Cannot parse field of {}: {}'.format(
+                struct_name, field))
+
+        # The first field of a packed structure is the most significant one.
+        layout = []
+        offset = 0
+        for field_name, width in reversed(fields):
+            layout.append((field_name, offset, width))
+            offset += width
+        return layout
+
+
+####################
+# Header rendering #
+####################
+
+
+def banner(title):
+    line = '/' * (len(title) + 6)
+    return '{}\n// {} //\n{}\n'.format(line, title, line)
+
+
+def render_header(pkg, pkg_path):
+    out = []
+    out.append('// Copyright lowRISC contributors.\n'
+               '// Licensed under the Apache License, Version 2.0, see LICENSE '
+               'for details.\n'
+               '// SPDX-License-Identifier: Apache-2.0\n'
+               '//\n'
+               '// Generated by util/gen_simmem_axi_dimensions.py from {}.\n'
+               '// Do not edit: regenerate it when the package changes.\n\n'
+               '#ifndef SIMMEM_DV_AXI_DIMENSIONS\n'
+               '#define SIMMEM_DV_AXI_DIMENSIONS\n\n'
+               '#include <stdint.h>\n\n'.format(os.path.basename(pkg_path)))
+
+    out.append(banner('Package parameters'))
+    out.append('\n')
+    for name, val in pkg.params:
+        out.append('constexpr uint64_t {} = {};\n'.format(name, val))
+    out.append('\n')
+
+    out.append(banner('Package enumerations'))
+    for name, items in pkg.enums:
+        out.append('\ntypedef enum {\n')
+        out.append(',\n'.join('  {} = {}'.format(item_name, item_val)
+                              for item_name, item_val in items))
+        out.append('\n}} {};\n'.format(name))
+    out.append('\n')
+
+    out.append(banner('Message layouts'))
+    for cpp_name, struct_name, renames in MESSAGES:
+        layout = pkg.get_struct_layout(struct_name)
+        packed_w = sum(width for _, _, width in layout)
+        out.append('\n// Bit offsets and widths of the fields of '
+                   'simmem_pkg::{}.\n'.format(struct_name))
+        out.append('struct {}Layout {{\n'.format(cpp_name))
+        for field_name, offset, width in layout:
+            field_name = renames.get(field_name, field_name)
+            out.append('  static constexpr uint64_t {0}_off = {1}, {0}_w = {2};'
+                       '\n'.format(field_name, offset, width))
+        out.append('  static constexpr uint64_t packed_w = {};\n'.format(
+            packed_w))
+        out.append('};\n')
+
+    out.append('\n#endif  // SIMMEM_DV_AXI_DIMENSIONS\n')
+    return ''.join(out)
+
+
+def generate(pkg_path, out_path, overrides):
+    with open(pkg_path) as pkg_file:
+        pkg = Package(pkg_file.read(), os.path.dirname(pkg_path), overrides)
+    header = render_header(pkg, pkg_path)
+
+    # Do not touch an up-to-date header, to avoid needless recompilations.
+    if os.path.exists(out_path):
+        with open(out_path) as out_file:
+            if out_file.read() == header:
+                return
+    with open(out_path, 'w') as out_file:
+        out_file.write(header)
+
+
+def run_fusesoc_generator(config_path):
+    """Generates the header in the working directory, and the core file that
+    exposes it to the dependent core."""
+    import yaml
+
+    with open(config_path) as config_file:
+        config = yaml.safe_load(config_file)
+    params = config.get('parameters') or {}
+    pkg_path = os.path.join(config['files_root'],
+                            params.get('pkg', 'rtl/simmem_pkg.sv'))
+    overrides = {
+        str(name): str(val)
+        for name, val in (params.get('overrides') or {}).items()
+    }
+    overrides.update(
+        parse_define(define)
+        for define in os.environ.get('SIMMEM_DEFINES', '').split())
+
+    generate(pkg_path, HEADER_NAME, overrides)
+
+    core = {
+        'name': config['vlnv'],
+        'filesets': {
+            'files_dv_generated': {
+                'files': [{
+                    HEADER_NAME: {
+                        'is_include_file': True
+                    }
+                }],
+                'file_type': 'cppSource'
+            }
+        },
+        'targets': {
+            'default': {
+                'filesets': ['files_dv_generated']
+            }
+        }
+    }
+    with open('simmem_axi_dimensions.core', 'w') as core_file:
+        core_file.write('CAPI=2:\n')
+        core_file.write(yaml.safe_dump(core, default_flow_style=False))
+
+
+def parse_define(define):
+    if '=' not in define:
+        raise argparse.ArgumentTypeError(
+            'Expected Name=Value, got {}'.format(define))
+    name, val = define.split('=', 1)
+    return name.strip(), val.strip()
+
+
+def main():
+    if len(sys.argv) == 2 and sys.argv[1].endswith(('.yml', '.yaml')):
+        run_fusesoc_generator(sys.argv[1])
+        return 0
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('pkg', help='path to simmem_pkg.sv')
+    parser.add_argument('-o',
+                        '--output',
+                        default=HEADER_NAME,
+                        help='path of the generated header')
+    parser.add_argument('-D',
+                        dest='defines',
+                        action='append',
+                        type=parse_define,
+                        default=[],
+                        metavar='Name=Value',
+                        help='override a package parameter')
+    args = parser.parse_args()
+
+    generate(args.pkg, args.output, dict(args.defines))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Runs the performance regression benchmarks of the toplevel testbench.
+
+The optimized toplevel testbench (sim_simmem_top_fast) is built once with
+FuseSoC, then run on a fixed set of workloads, which differ by their request
+probabilities and address patterns (see the +addr_pattern plusarg of the
+testbench). Each run is repeated and the fastest repetition is kept. The
+script reports per workload, in JSON:
+  * the simulation speed, in thousands of simulated cycles per second,
+  * the modelled write and read bandwidths, in bytes per cycle,
+  * the percentiles of the write response and read data delays, in cycles,
+  * the row-hit rate, i.e., the share of CAS commands which hit an open row
+  (only with the row buffer delay engine).
+The report is compared against a committed baseline: a metric may not be worse
+than its baseline by more than the relative tolerance of the metric, and a
+workload or metric without baseline fails the comparison. The simulation speed
+depends on the host, so it is compared against a local baseline, kept in the
+output directory, instead.
+
+Usage:
+
+  util/simmem_bench.py [--cycles 100000] [--repeat 3] [--update-baseline]
+"""
+
+import argparse
+import json
+import os
+import sys
+
+from simmem_dse import PERCENTILES, percentile
+from simmem_sweep import REPO_ROOT, build_config, parse_output, run_sim
+
+BASELINE_PATH = os.path.join(REPO_ROOT, 'util', 'simmem_bench_baseline.json')
+LOCAL_BASELINE_NAME = 'simmem_bench_local_baseline.json'
+TARGET = 'sim_simmem_top_fast'
+
+# Workloads, as testbench plusargs.
+WORKLOADS = {
+    'stream_read': [
+        '+waddr_prob=0', '+wdata_prob=0', '+raddr_prob=100',
+        '+addr_pattern=sequential'
+    ],
+    'stream_write': [
+        '+waddr_prob=100', '+wdata_prob=100', '+raddr_prob=0',
+        '+addr_pattern=sequential'
+    ],
+    'random': [
+        '+waddr_prob=50', '+wdata_prob=50', '+raddr_prob=50',
+        '+addr_pattern=random'
+    ],
+    'row_conflict': [
+        '+waddr_prob=50', '+wdata_prob=100', '+raddr_prob=50',
+        '+addr_pattern=row_conflict'
+    ],
+    'mixed': [
+        '+waddr_prob=50', '+wdata_prob=100', '+raddr_prob=50',
+        '+addr_pattern=sequential'
+    ],
+}
+
+# Metrics which regress when they decrease. All the other metrics regress when
+# they increase.
+HIGHER_IS_BETTER = ['kcycles_per_s', 'wr_bw', 'rd_bw', 'row_hit_rate']
+
+# Metrics which depend on the host, and are kept out of the committed baseline.
+MACHINE_LOCAL = ['kcycles_per_s']
+
+# Relative tolerance of the machine-local metrics.
+LOCAL_TOLERANCE = 0.15
+
+
+def run_workload(out_dir, plusargs, num_cycles, repeat, log):
+    """Runs a workload, and gives its metrics, or None if a run failed."""
+    run_times = []
+    for _ in range(repeat):
+        ret, output, run_s = run_sim(out_dir, TARGET, plusargs, log)
+        if ret:
+            return None
+        run_times.append(run_s)
+
+    stats = parse_output(output)
+    if stats.get('wrsp_mismatches') or stats.get('rdata_mismatches'):
+        return None
+    metrics = {
+        'kcycles_per_s': round(num_cycles / min(run_times) / 1000, 1),
+        'wr_bw': stats['wr_bw'],
+        'rd_bw': stats['rd_bw'],
+        'row_hit_rate': stats.get('row_hit_rate')
+    }
+    for key in ('wrsp', 'rdata'):
+        for pct in PERCENTILES + [100]:
+            metrics['{}_p{}'.format(key, pct)] = percentile(
+                stats[key + '_delays'], pct)
+    return metrics
+
+
+def split_report(report, local):
+    """Gives the machine-local metrics of a report if local is set, and the
+    other metrics otherwise."""
+    return {
+        workload: {
+            metric: value
+            for metric, value in metrics.items()
+            if (metric in MACHINE_LOCAL) == local
+        }
+        for workload, metrics in report.items()
+    }
+
+
+def find_missing(report, baseline):
+    """Lists the workloads and metrics of a report which have no baseline."""
+    missing = []
+    for workload, metrics in report.items():
+        if workload not in baseline:
+            missing.append(workload)
+            continue
+        for metric, value in metrics.items():
+            if value is not None and baseline[workload].get(metric) is None:
+                missing.append('{}: {}'.format(workload, metric))
+    return missing
+
+
+def compare(report, baseline, tolerances):
+    """Compares a benchmark report against the baseline.
+
+    The tolerances map the metrics to relative tolerances, and default to the
+    tolerance of the 'default' key.
+    """
+    regressions = []
+    for workload, metrics in report.items():
+        base = baseline.get(workload, {})
+        for metric, value in metrics.items():
+            if value is None or base.get(metric) is None:
+                continue
+            tolerance = tolerances.get(metric, tolerances['default'])
+            if metric in HIGHER_IS_BETTER:
+                worse = value < base[metric] * (1 - tolerance)
+            else:
+                worse = value > base[metric] * (1 + tolerance)
+            if worse:
+                regressions.append('{}: {} {} (baseline {})'.format(
+                    workload, metric, value, base[metric]))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--cycles',
+                        type=int,
+                        default=100000,
+                        help='number of measured cycles per run')
+    parser.add_argument('--warmup',
+                        type=int,
+                        default=1000,
+                        help='number of warmup cycles per run')
+    parser.add_argument('--repeat',
+                        type=int,
+                        default=3,
+                        help='number of repetitions of each run')
+    parser.add_argument('--seed', type=int, default=0, help='testbench seed')
+    parser.add_argument('--out',
+                        default='build/bench',
+                        help='output directory')
+    parser.add_argument('--baseline',
+                        default=BASELINE_PATH,
+                        help='baseline of the benchmark report')
+    parser.add_argument('--update-baseline',
+                        action='store_true',
+                        help='overwrite the baseline with the benchmark report')
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    plusargs = [
+        '+notrace', '+quiet', '+cycles={}'.format(args.cycles),
+        '+warmup={}'.format(args.warmup), '+seed={}'.format(args.seed)
+    ]
+
+    report = {}
+    with open(os.path.join(args.out, 'bench.log'), 'w') as log:
+        if build_config(args.out, {}, TARGET, log) is None:
+            print('Build failed, see {}'.format(log.name))
+            return 1
+
+        for name, workload_plusargs in WORKLOADS.items():
+            metrics = run_workload(args.out, plusargs + workload_plusargs,
+                                   args.cycles + args.warmup, args.repeat, log)
+            if metrics is None:
+                print('Run of {} failed, see {}'.format(name, log.name))
+                return 1
+            report[name] = metrics
+
+    report_path = os.path.join(args.out, 'simmem_bench_report.json')
+    with open(report_path, 'w') as report_file:
+        json.dump(report, report_file, indent=2, sort_keys=True)
+    print('Report written to {}'.format(report_path))
+
+    local_path = os.path.join(args.out, LOCAL_BASELINE_NAME)
+    with open(args.baseline) as baseline_file:
+        baseline = json.load(baseline_file)
+    if args.update_baseline:
+        baseline['workloads'] = split_report(report, False)
+        with open(args.baseline, 'w') as baseline_file:
+            json.dump(baseline, baseline_file, indent=2, sort_keys=True)
+            baseline_file.write('\n')
+        with open(local_path, 'w') as local_file:
+            json.dump(split_report(report, True),
+                      local_file,
+                      indent=2,
+                      sort_keys=True)
+        print('Baseline updated')
+        return 0
+
+    missing = find_missing(split_report(report, False), baseline['workloads'])
+    if missing:
+        print('No baseline for: {} (see --update-baseline)'.format(
+            ', '.join(missing)))
+        return 1
+    regressions = compare(report, baseline['workloads'],
+                          baseline['tolerances'])
+    if os.path.exists(local_path):
+        with open(local_path) as local_file:
+            regressions += compare(report, json.load(local_file),
+                                   {'default': LOCAL_TOLERANCE})
+    else:
+        print('No local baseline for the simulation speed in {}'.format(
+            args.out))
+    for regression in regressions:
+        print('Regression: ' + regression)
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Measures the simulation speed of the testbench clocking schemes.
+
+The toplevel testbench is built once with FuseSoC, then run on the same
+workload with the two-evaluation clocking of the testbench harness (see
+dv/common/cpp/simmem_bfm.h) and with the former three-evaluation clocking
+(+legacy_clocking). Each run is repeated and the fastest repetition is kept.
+The script reports the simulation speed of both schemes, the speedup, and
+checks that both schemes produce the same delays. The speed depends on the
+host and on the Verilator version, which are reported with the results for the
+Clocking section of the documentation.
+
+Usage:
+
+  util/simmem_clocking_bench.py [--cycles 200000] [--repeat 3]
+"""
+
+import argparse
+import os
+import platform
+import subprocess
+import sys
+
+from simmem_sweep import build_config, parse_output, run_sim, write_results
+
+# Clocking schemes, as (name, evaluations per cycle, plusargs).
+SCHEMES = [
+    ('legacy', 4, ['+legacy_clocking']),
+    ('two_eval', 2, []),
+]
+
+COLUMNS = ['clocking', 'evals_per_cycle', 'run_s', 'kcycles_per_s', 'speedup']
+
+
+def get_verilator_version():
+    """Gives the version string of Verilator, or None if it is not found."""
+    try:
+        return subprocess.check_output(['verilator', '--version'],
+                                       universal_newlines=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--target',
+                        default='sim_simmem_top',
+                        help='FuseSoC target of the toplevel testbench')
+    parser.add_argument('--cycles',
+                        type=int,
+                        default=200000,
+                        help='number of simulated cycles per run')
+    parser.add_argument('--repeat',
+                        type=int,
+                        default=3,
+                        help='number of repetitions of each run')
+    parser.add_argument('--seed', type=int, default=0, help='testbench seed')
+    parser.add_argument('--out',
+                        default='build/clocking_bench',
+                        help='output directory')
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    plusargs = [
+        '+notrace', '+quiet', '+cycles={}'.format(args.cycles),
+        '+seed={}'.format(args.seed)
+    ]
+
+    results = []
+    delays = {}
+    with open(os.path.join(args.out, 'clocking_bench.log'), 'w') as log:
+        if build_config(args.out, {}, args.target, log) is None:
+            print('Build failed, see {}'.format(log.name))
+            return 1
+
+        for name, evals, scheme_plusargs in SCHEMES:
+            run_times = []
+            for _ in range(args.repeat):
+                ret, output, run_s = run_sim(args.out, args.target,
+                                             plusargs + scheme_plusargs, log)
+                if ret:
+                    print('Run failed, see {}'.format(log.name))
+                    return 1
+                run_times.append(run_s)
+            stats = parse_output(output)
+            delays[name] = (stats['wrsp_delays'], stats['rdata_delays'])
+            results.append({
+                'clocking': name,
+                'evals_per_cycle': evals,
+                'run_s': round(min(run_times), 2),
+                'kcycles_per_s': round(args.cycles / min(run_times) / 1000, 1)
+            })
+
+    for res in results:
+        res['speedup'] = round(results[0]['run_s'] / res['run_s'], 2)
+    write_results(results, COLUMNS,
+                  os.path.join(args.out, 'clocking_bench.csv'))
+    print('Host: {} ({}), {}, {} cycles, seed {}'.format(
+        platform.processor() or platform.machine(), platform.system(),
+        get_verilator_version(), args.cycles, args.seed))
+
+    # Both schemes must be cycle-accurate equivalents.
+    if len(set(map(str, delays.values()))) != 1:
+        print('The clocking schemes produce different delays.')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
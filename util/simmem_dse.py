@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Explores the latency/area trade-off of the simulated memory controller.
+
+Every combination of the parameter matrix of the DSE file is built with
+FuseSoC, and each workload of the DSE file is run through the toplevel
+testbench of each configuration. Each configuration is additionally
+synthesized with sv2v and Yosys (see util/simmem_synth.py). The bandwidth,
+the latency percentiles, the simulation speed, the area and the logic depth
+are gathered in a single comparison table, also written as a CSV file.
+
+Usage:
+
+  util/simmem_dse.py [--dse util/simmem_dse.yml] [--jobs 4] [--no-synth]
+"""
+
+import argparse
+import itertools
+import os
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+import yaml
+
+from simmem_sweep import REPO_ROOT, build_config, parse_output, run_sim, \
+    write_results
+from simmem_synth import synthesize
+
+# Build target of the explored configurations.
+TARGET = 'sim_simmem_top'
+
+# Latency percentiles reported for the write responses and the read data.
+PERCENTILES = [50, 90, 99]
+
+# Columns of the comparison table following the configuration parameters.
+RESULT_COLUMNS = ['workload', 'status', 'wr_bw', 'rd_bw'] + [
+    '{}_p{}'.format(key, pct) for key in ('wrsp', 'rdata')
+    for pct in PERCENTILES + [100]
+] + ['kcycles_per_s', 'luts', 'ffs', 'lutrams', 'brams', 'logic_depth']
+
+
+def percentile(vals, pct):
+    """Returns the nearest-rank percentile of a list of values."""
+    if not vals:
+        return None
+    vals = sorted(vals)
+    rank = max(0, -(-len(vals) * pct // 100) - 1)
+    return vals[rank]
+
+
+def get_plusargs(workload):
+    """Converts a workload into testbench plusargs."""
+    return ['+notrace', '+quiet'] + [
+        '+{}={}'.format(key, val) for key, val in workload.items()
+    ]
+
+
+def explore_config(name, defines, workloads, args):
+    """Builds, simulates and synthesizes one configuration.
+
+    Returns:
+        One result per workload.
+    """
+    build_root = os.path.join(args.out, name)
+    os.makedirs(build_root, exist_ok=True)
+    base = dict(defines, config=name)
+
+    with open(os.path.join(build_root, 'dse.log'), 'w') as log:
+        area = {}
+        if not args.no_synth:
+            area = synthesize(defines, os.path.join(build_root, 'synth'),
+                              log=log) or {'luts': 'failed'}
+
+        if build_config(build_root, defines, TARGET, log) is None:
+            return [dict(base, status='build failed', **area)]
+
+        results = []
+        for wl_name, workload in workloads.items():
+            result = dict(base, workload=wl_name, **area)
+            ret, output, run_s = run_sim(build_root, TARGET,
+                                         get_plusargs(workload), log)
+            result['status'] = 'ok' if ret == 0 else 'run failed'
+            stats = parse_output(output)
+            result['wr_bw'] = stats.get('wr_bw')
+            result['rd_bw'] = stats.get('rd_bw')
+            for key in ('wrsp', 'rdata'):
+                for pct in PERCENTILES + [100]:
+                    result['{}_p{}'.format(key, pct)] = percentile(
+                        stats[key + '_delays'], pct)
+            if 'cycles' in stats and run_s > 0:
+                result['kcycles_per_s'] = round(
+                    stats['cycles'] / run_s / 1000, 1)
+            results.append(result)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--dse',
+                        default=os.path.join(REPO_ROOT, 'util',
+                                             'simmem_dse.yml'),
+                        help='DSE file')
+    parser.add_argument('--jobs',
+                        type=int,
+                        default=os.cpu_count(),
+                        help='number of configurations explored in parallel')
+    parser.add_argument('--out',
+                        default='build/dse',
+                        help='output directory')
+    parser.add_argument('--no-synth',
+                        action='store_true',
+                        help='skip the area and logic depth estimation')
+    args = parser.parse_args()
+
+    with open(args.dse) as dse_file:
+        dse = yaml.safe_load(dse_file)
+    macros = list(dse['matrix'])
+    configs = [
+        dict(zip(macros, vals))
+        for vals in itertools.product(*dse['matrix'].values())
+    ]
+
+    with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = [
+            executor.submit(explore_config, 'cfg{:03d}'.format(idx), defines,
+                            dse['workloads'], args)
+            for idx, defines in enumerate(configs)
+        ]
+        results = [res for future in futures for res in future.result()]
+
+    write_results(results, ['config'] + macros + RESULT_COLUMNS,
+                  os.path.join(args.out, 'dse_results.csv'))
+
+    return 0 if all(res['status'] == 'ok' for res in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
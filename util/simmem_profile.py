@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Profiles the toplevel testbench on a fixed workload.
+
+The profiled target (sim_simmem_top_prof) is built with FuseSoC and run on a
+fixed workload. The script then reports:
+  * the share of the simulation time spent in each RTL module, from the gprof
+    profile broken down by verilator_profcfunc,
+  * the time spent in each testbench phase (stimulus generation, model
+    evaluation, scoreboard and logging), as measured by the testbench.
+Both breakdowns are also written to a CSV file.
+
+Usage:
+
+  util/simmem_profile.py [--cycles 100000] [--seed 0]
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+from simmem_sweep import build_config, get_toplevel, run_sim, write_results
+
+TARGET = 'sim_simmem_top_prof'
+
+COLUMNS = ['kind', 'name', 'percent', 'seconds']
+
+
+def parse_modules(profcfunc_output):
+    """Extracts the share of each RTL module from the verilator_profcfunc
+    output."""
+    results = []
+    in_section = False
+    for line in profcfunc_output.splitlines():
+        if line.startswith('Overall summary by module'):
+            in_section = True
+            continue
+        if not in_section:
+            continue
+        match = re.match(r'\s*([\d.]+)\s+(\S.*?)\s*$', line)
+        if match:
+            results.append({
+                'kind': 'module',
+                'name': match.group(2),
+                'percent': float(match.group(1))
+            })
+        elif results:
+            # The section ends with the first line after its entries.
+            break
+    return results
+
+
+def parse_phases(output):
+    """Extracts the testbench phase profile from the testbench output."""
+    results = []
+    for line in output.splitlines():
+        match = re.match(r'Phase (\w+):\s*([\d.]+) s \(([\d.]+) %\)', line)
+        if match:
+            results.append({
+                'kind': 'phase',
+                'name': match.group(1),
+                'seconds': float(match.group(2)),
+                'percent': float(match.group(3))
+            })
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--cycles',
+                        type=int,
+                        default=100000,
+                        help='number of simulated cycles')
+    parser.add_argument('--seed', type=int, default=0, help='testbench seed')
+    parser.add_argument('--out',
+                        default='build/profile',
+                        help='output directory')
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    sim_dir = os.path.join(args.out, TARGET + '-verilator')
+    sim_bin = os.path.join(sim_dir, 'V' + get_toplevel(TARGET))
+    gmon_path = os.path.join(sim_dir, 'gmon.out')
+    plusargs = [
+        '+notrace', '+quiet', '+brief', '+cycles={}'.format(args.cycles),
+        '+seed={}'.format(args.seed)
+    ]
+
+    with open(os.path.join(args.out, 'profile.log'), 'w') as log:
+        if build_config(args.out, {}, TARGET, log) is None:
+            print('Build failed, see {}'.format(log.name))
+            return 1
+
+        if os.path.exists(gmon_path):
+            os.remove(gmon_path)
+        ret, output, run_s = run_sim(args.out, TARGET, plusargs, log)
+        if ret:
+            print('Run failed, see {}'.format(log.name))
+            return 1
+
+        gprof_path = os.path.join(args.out, 'gprof.txt')
+        with open(gprof_path, 'w') as gprof_file:
+            ret = subprocess.call(['gprof', '-b', sim_bin, gmon_path],
+                                  stdout=gprof_file, stderr=log)
+        if ret:
+            print('gprof failed, see {}'.format(log.name))
+            return 1
+        profcfunc_output = subprocess.run(['verilator_profcfunc', gprof_path],
+                                          stdout=subprocess.PIPE,
+                                          stderr=log,
+                                          universal_newlines=True).stdout
+        with open(os.path.join(args.out, 'profcfunc.txt'), 'w') as out_file:
+            out_file.write(profcfunc_output)
+
+    print('Simulated {} cycles in {:.1f} s.\n'.format(args.cycles, run_s))
+    results = parse_modules(profcfunc_output) + parse_phases(output)
+    write_results(results, COLUMNS, os.path.join(args.out, 'profile.csv'))
+
+    exec_profile = os.path.join(sim_dir, 'profile_exec.dat')
+    if os.path.exists(exec_profile):
+        print('Execution profile: verilator_gantt {}'.format(exec_profile))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
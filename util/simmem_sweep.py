@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Builds and runs several simulated memory controller configurations.
+
+Each configuration of the sweep file overrides some SIMMEM_* macros of
+rtl/simmem_config.svh. The configurations are built in parallel with FuseSoC,
+each in its own build directory, then simulated, and the delays, mismatches,
+row-hit rate and energy reported by the testbench are summarized in a table
+and a CSV file.
+
+Usage:
+
+  util/simmem_sweep.py [--configs util/simmem_sweep.yml] [--jobs 4]
+"""
+
+import argparse
+import csv
+import os
+import re
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import yaml
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CORE_NAME = '::simmem:0.1'
+
+# Columns of the summary, in order.
+COLUMNS = [
+    'config', 'status', 'build_s', 'run_s', 'wrsp_mean', 'wrsp_max',
+    'rdata_mean', 'rdata_max', 'wrsp_mismatches', 'rdata_mismatches',
+    'row_hit_rate', 'energy_pj'
+]
+
+
+def get_toplevel(target):
+    """Returns the toplevel module of a simulation target."""
+    return target[len('sim_'):] if target.startswith('sim_') else target
+
+
+def parse_output(output):
+    """Extracts the delays, the mismatches, the throughput, the row-hit rate
+    and the energy from the testbench output.
+
+    The delays are returned as lists, under the wrsp_delays and rdata_delays
+    keys.
+    """
+    results = {'wrsp_delays': [], 'rdata_delays': []}
+    section = None
+
+    for line in output.splitlines():
+        if line.startswith('#### Write responses'):
+            section = 'wrsp_delays'
+        elif line.startswith('#### Read data'):
+            section = 'rdata_delays'
+        elif line.startswith('####'):
+            section = None
+
+        match = re.match(r'Delay:\s*(\d+)', line)
+        if match and section:
+            results[section].append(int(match.group(1)))
+        match = re.match(r'Write response mismatches:\s*(\d+)', line)
+        if match:
+            results['wrsp_mismatches'] = int(match.group(1))
+        match = re.match(r'Read data mismatches:\s*(\d+)', line)
+        if match:
+            results['rdata_mismatches'] = int(match.group(1))
+        match = re.match(r'Cycles:\s*(\d+)', line)
+        if match:
+            results['cycles'] = int(match.group(1))
+        match = re.match(
+            r'Write bandwidth:\s*([\d.e+-]+) B/cycle, '
+            r'read bandwidth:\s*([\d.e+-]+) B/cycle', line)
+        if match:
+            results['wr_bw'] = float(match.group(1))
+            results['rd_bw'] = float(match.group(2))
+        match = re.search(r'total:\s*([\d.e+]+) pJ', line)
+        if match:
+            results['energy_pj'] = float(match.group(1))
+        match = re.match(r'Row hits:\s*(\d+) of (\d+) CAS', line)
+        if match and int(match.group(2)):
+            results['row_hit_rate'] = round(
+                int(match.group(1)) / int(match.group(2)), 4)
+    return results
+
+
+def build_config(build_root, defines, target, log):
+    """Builds one configuration with FuseSoC.
+
+    Returns:
+        The build time in seconds, or None if the build failed.
+    """
+    # The C++ dimensions generator reads the same overrides from SIMMEM_DEFINES.
+    env = dict(os.environ)
+    env['SIMMEM_DEFINES'] = ' '.join('{}={}'.format(macro, val)
+                                     for macro, val in defines.items())
+
+    build_cmd = [
+        'fusesoc', '--cores-root', REPO_ROOT, 'run', '--build-root',
+        build_root, '--target', target, '--build', CORE_NAME
+    ] + ['--{}={}'.format(macro, val) for macro, val in defines.items()]
+
+    start = time.time()
+    ret = subprocess.call(build_cmd, stdout=log, stderr=subprocess.STDOUT,
+                          env=env)
+    return None if ret else round(time.time() - start, 1)
+
+
+def run_sim(build_root, target, plusargs, log):
+    """Runs the testbench of a built configuration.
+
+    Returns:
+        The return code, the output and the run time in seconds.
+    """
+    sim_dir = os.path.join(build_root, target + '-verilator')
+    sim_bin = os.path.join(sim_dir, 'V' + get_toplevel(target))
+    start = time.time()
+    proc = subprocess.run([sim_bin] + plusargs, cwd=sim_dir,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+    log.write(proc.stdout)
+    return proc.returncode, proc.stdout, time.time() - start
+
+
+def run_config(name, defines, args):
+    """Builds and simulates one configuration."""
+    build_root = os.path.join(args.out, name)
+    os.makedirs(build_root, exist_ok=True)
+    result = {'config': name}
+
+    with open(os.path.join(build_root, 'sweep.log'), 'w') as log:
+        result['build_s'] = build_config(build_root, defines, args.target, log)
+        if result['build_s'] is None:
+            result['status'] = 'build failed'
+            return result
+        if args.no_run:
+            result['status'] = 'built'
+            return result
+        ret, output, run_s = run_sim(build_root, args.target, [], log)
+
+    result['status'] = 'ok' if ret == 0 else 'run failed'
+    result['run_s'] = round(run_s, 1)
+    result.update(parse_output(output))
+    for key in ('wrsp', 'rdata'):
+        delays = result.pop(key + '_delays')
+        if delays:
+            result[key + '_mean'] = round(sum(delays) / len(delays), 2)
+            result[key + '_max'] = max(delays)
+    return result
+
+
+def write_results(results, columns, csv_path):
+    """Prints the results as a table and writes them to a CSV file."""
+    os.makedirs(os.path.dirname(csv_path) or '.', exist_ok=True)
+    with open(csv_path, 'w', newline='') as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=columns,
+                                extrasaction='ignore')
+        writer.writeheader()
+        writer.writerows(results)
+
+    widths = [
+        max(len(col), *(len(str(res.get(col, '-'))) for res in results))
+        for col in columns
+    ]
+    print('  '.join(col.ljust(width) for col, width in zip(columns, widths)))
+    for res in results:
+        print('  '.join(
+            str(res.get(col, '-')).ljust(width)
+            for col, width in zip(columns, widths)))
+    print('\nResults written to {}'.format(csv_path))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--configs',
+                        default=os.path.join(REPO_ROOT, 'util',
+                                             'simmem_sweep.yml'),
+                        help='sweep file')
+    parser.add_argument('--only',
+                        nargs='+',
+                        help='only sweep the given configurations')
+    parser.add_argument('--target',
+                        default='sim_simmem_top',
+                        help='FuseSoC simulation target')
+    parser.add_argument('--jobs',
+                        type=int,
+                        default=os.cpu_count(),
+                        help='number of configurations built in parallel')
+    parser.add_argument('--out',
+                        default='build/sweep',
+                        help='output directory')
+    parser.add_argument('--no-run',
+                        action='store_true',
+                        help='only build the configurations')
+    args = parser.parse_args()
+
+    with open(args.configs) as configs_file:
+        configs = yaml.safe_load(configs_file)['configs']
+    if args.only:
+        unknown = set(args.only) - set(configs)
+        if unknown:
+            parser.error('Unknown configurations: {}'.format(', '.join(
+                sorted(unknown))))
+        configs = {name: configs[name] for name in args.only}
+
+    with ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = [
+            executor.submit(run_config, name, defines or {}, args)
+            for name, defines in configs.items()
+        ]
+        results = [future.result() for future in futures]
+
+    write_results(results, COLUMNS,
+                  os.path.join(args.out, 'sweep_results.csv'))
+
+    return 0 if all(res['status'] in ('ok', 'built')
+                    for res in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,348 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Estimates the area and logic depth of the simulated memory controller.
+
+The RTL sources of simmem.core are converted to Verilog with sv2v, then
+synthesized with Yosys. Two flows are available:
+
+* The module report (default) synthesizes simmem_top with the generic Yosys
+  flow, without flattening, and reports per RTL module the cell count, the
+  flip-flop count, the RAM bits and the logic depth, i.e., the longest
+  combinational path in cells, in JSON. The report covers several
+  configurations, so that the scaling of the modules with the bank
+  capacities is visible, and is compared against a committed baseline.
+* The FPGA estimate (--fpga) synthesizes a single configuration for Xilinx
+  7-series devices and reports LUT, flip-flop and RAM primitive counts.
+
+The SIMMEM_* macros of rtl/simmem_config.svh may be overridden with -D.
+
+Usage:
+
+  util/simmem_synth.py [--out build/synth] [--update-baseline]
+  util/simmem_synth.py --fpga [-D SIMMEM_WRSP_BANK_CAPA=6]
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import yaml
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CORE_PATH = os.path.join(REPO_ROOT, 'simmem.core')
+BASELINE_PATH = os.path.join(REPO_ROOT, 'util', 'simmem_synth_baseline.json')
+RTL_FILESET = 'files_rtl_simmem_top'
+
+# Configurations of the module report. The two capacity points give the growth
+# of each module when the bank capacities, hence the slot counts, double.
+REPORT_CONFIGS = {
+    'default': {},
+    'capa4': {
+        'SIMMEM_WRSP_BANK_CAPA': 4,
+        'SIMMEM_RDATA_BANK_CAPA': 4
+    },
+    'capa8': {
+        'SIMMEM_WRSP_BANK_CAPA': 8,
+        'SIMMEM_RDATA_BANK_CAPA': 8
+    },
+}
+SCALING_CONFIGS = ('capa4', 'capa8')
+
+# Metrics of the module report.
+METRICS = ['cells', 'ffs', 'mem_bits', 'logic_depth']
+
+
+def get_rtl_files(fileset):
+    """Returns the SystemVerilog sources of a fileset of simmem.core."""
+    with open(CORE_PATH) as core_file:
+        core = yaml.safe_load(core_file)
+    rtl_files = []
+    for entry in core['filesets'][fileset]['files']:
+        # Include files are given as {path: {is_include_file: true}}.
+        if isinstance(entry, str):
+            rtl_files.append(os.path.join(REPO_ROOT, entry))
+    return rtl_files
+
+
+def get_rtl_modules(rtl_files):
+    """Returns the names of the modules defined in the RTL sources."""
+    modules = []
+    for rtl_path in rtl_files:
+        with open(rtl_path) as rtl_file:
+            modules += re.findall(r'^module\s+(\w+)', rtl_file.read(), re.M)
+    return modules
+
+
+def get_rtl_module(synth_module, rtl_modules):
+    """Returns the RTL module of a synthesized module.
+
+    sv2v and Yosys give their own names to the specializations of the
+    parameterized modules, which keep the RTL module name as prefix.
+    """
+    name = synth_module.lstrip('\\')
+    matches = [mod for mod in rtl_modules if name.startswith(mod)]
+    return max(matches, key=len) if matches else name
+
+
+def convert(defines, out_dir, top, log):
+    """Converts the RTL sources to Verilog with sv2v.
+
+    Returns:
+        The path of the Verilog file, or None if the conversion failed.
+    """
+    os.makedirs(out_dir, exist_ok=True)
+    verilog_path = os.path.join(out_dir, top + '.v')
+    sv2v_cmd = ['sv2v', '-I', os.path.join(REPO_ROOT, 'rtl'), '-w',
+                verilog_path]
+    sv2v_cmd += ['-D{}={}'.format(macro, val)
+                 for macro, val in defines.items()]
+    sv2v_cmd += get_rtl_files(RTL_FILESET)
+    if subprocess.call(sv2v_cmd, stdout=log, stderr=subprocess.STDOUT):
+        return None
+    return verilog_path
+
+
+def run_yosys(out_dir, commands, log):
+    """Runs a Yosys script. Returns True on success."""
+    script_path = os.path.join(out_dir, 'synth.ys')
+    with open(script_path, 'w') as script:
+        script.write('\n'.join(commands) + '\n')
+    return subprocess.call(['yosys', '-q', '-s', script_path], stdout=log,
+                           stderr=subprocess.STDOUT) == 0
+
+
+def synthesize(defines, out_dir, top='simmem_top', log=None):
+    """Synthesizes one configuration for Xilinx 7-series devices.
+
+    Returns:
+        A dictionary with the LUT, flip-flop, LUTRAM and block RAM counts, the
+        logic depth and the synthesis time, or None if the synthesis failed.
+    """
+    start = time.time()
+    verilog_path = convert(defines, out_dir, top, log)
+    stat_path = os.path.join(out_dir, 'stat.json')
+    ltp_path = os.path.join(out_dir, 'ltp.txt')
+    if verilog_path is None or not run_yosys(out_dir, [
+            'read_verilog {}'.format(verilog_path),
+            'synth_xilinx -flatten -top {}'.format(top),
+            'tee -q -o {} stat -json'.format(stat_path),
+            'tee -q -o {} ltp -noff'.format(ltp_path),
+    ], log):
+        return None
+
+    with open(stat_path) as stat_file:
+        cells = json.load(stat_file)['design']['num_cells_by_type']
+    with open(ltp_path) as ltp_file:
+        depth = re.search(r'length=(\d+)', ltp_file.read())
+
+    def count(*prefixes):
+        return sum(num for cell, num in cells.items()
+                   if cell.startswith(prefixes))
+
+    return {
+        'luts': count('LUT'),
+        'ffs': count('FD'),
+        'lutrams': count('RAM32', 'RAM64', 'RAM128', 'RAM256'),
+        'brams': count('RAMB'),
+        'logic_depth': int(depth.group(1)) if depth else None,
+        'synth_s': round(time.time() - start, 1),
+    }
+
+
+def report_modules(defines, out_dir, top='simmem_top', log=None):
+    """Synthesizes one configuration with the generic Yosys flow.
+
+    Returns:
+        A dictionary mapping each RTL module to its metrics, or None if the
+        synthesis failed. The metrics of the specializations of a module are
+        summed, and the logic depth is the maximum among them.
+    """
+    verilog_path = convert(defines, out_dir, top, log)
+    mem_path = os.path.join(out_dir, 'mem.json')
+    stat_path = os.path.join(out_dir, 'stat.json')
+    ltp_path = os.path.join(out_dir, 'ltp.txt')
+    # The memories are counted before they are mapped to flip-flops.
+    if verilog_path is None or not run_yosys(out_dir, [
+            'read_verilog {}'.format(verilog_path),
+            'synth -top {} -run begin:fine'.format(top),
+            'tee -q -o {} stat -json'.format(mem_path),
+            'synth -top {} -run fine:'.format(top),
+            'tee -q -o {} stat -json'.format(stat_path),
+            'tee -q -o {} ltp -noff'.format(ltp_path),
+    ], log):
+        return None
+
+    with open(mem_path) as mem_file:
+        mem_stats = json.load(mem_file)['modules']
+    with open(stat_path) as stat_file:
+        stats = json.load(stat_file)['modules']
+    with open(ltp_path) as ltp_file:
+        depths = dict(
+            re.findall(r'Longest topological path in (\S+) \(length=(\d+)\)',
+                       ltp_file.read()))
+
+    rtl_modules = get_rtl_modules(get_rtl_files(RTL_FILESET))
+    synth_modules = [mod.lstrip('\\') for mod in stats]
+    report = {}
+    for synth_module, stat in stats.items():
+        module = get_rtl_module(synth_module, rtl_modules)
+        metrics = report.setdefault(module, dict.fromkeys(METRICS, 0))
+        for cell, num in stat['num_cells_by_type'].items():
+            # Submodule instances are reported by their own modules.
+            if cell.lstrip('\\') in synth_modules:
+                continue
+            metrics['cells'] += num
+            if 'DFF' in cell or 'DLATCH' in cell:
+                metrics['ffs'] += num
+        metrics['mem_bits'] += mem_stats.get(synth_module,
+                                             {}).get('num_memory_bits', 0)
+        metrics['logic_depth'] = max(
+            metrics['logic_depth'],
+            int(depths.get(synth_module, depths.get(synth_module.lstrip('\\'),
+                                                    0))))
+    return report
+
+
+def find_missing(report, baseline):
+    """Lists the configurations and modules of a report which have no
+    baseline."""
+    missing = []
+    for config, modules in report.items():
+        if config not in baseline:
+            missing.append(config)
+            continue
+        missing += [
+            '{}/{}'.format(config, module) for module in modules
+            if module not in baseline[config]
+        ]
+    return missing
+
+
+def compare(report, baseline, tolerance):
+    """Compares a module report against the baseline.
+
+    Both the absolute metrics and their growth between the scaling
+    configurations may not exceed the baseline by more than the relative
+    tolerance.
+
+    Returns:
+        The list of the regressions, as strings.
+    """
+    regressions = []
+    for config, modules in report.items():
+        for module, metrics in modules.items():
+            base = baseline.get(config, {}).get(module)
+            if base is None:
+                continue
+            for metric in METRICS:
+                if metrics[metric] > base[metric] * (1 + tolerance):
+                    regressions.append('{}/{}: {} {} > baseline {}'.format(
+                        config, module, metric, metrics[metric],
+                        base[metric]))
+
+    def growth(metrics_lo, metrics_hi, metric):
+        # Growth exponent of the metric when the capacities double.
+        if not metrics_lo[metric] or not metrics_hi[metric]:
+            return 0.
+        return math.log2(metrics_hi[metric] / metrics_lo[metric])
+
+    lo, hi = SCALING_CONFIGS
+    for module in report.get(hi, {}):
+        if module not in report.get(lo, {}) or \
+                module not in baseline.get(lo, {}) or \
+                module not in baseline.get(hi, {}):
+            continue
+        for metric in METRICS:
+            new = growth(report[lo][module], report[hi][module], metric)
+            old = growth(baseline[lo][module], baseline[hi][module], metric)
+            if new > old + tolerance:
+                regressions.append(
+                    '{}: {} grows as capacity^{:.2f} (baseline {:.2f})'.format(
+                        module, metric, new, old))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--top', default='simmem_top', help='toplevel module')
+    parser.add_argument('--fpga',
+                        action='store_true',
+                        help='estimate the FPGA resources of one configuration')
+    parser.add_argument('-D',
+                        dest='defines',
+                        action='append',
+                        default=[],
+                        metavar='NAME=VALUE',
+                        help='override a simmem_config.svh macro')
+    parser.add_argument('--out',
+                        default='build/synth',
+                        help='output directory')
+    parser.add_argument('--baseline',
+                        default=BASELINE_PATH,
+                        help='baseline of the module report')
+    parser.add_argument('--update-baseline',
+                        action='store_true',
+                        help='overwrite the baseline with the module report')
+    args = parser.parse_args()
+
+    defines = dict(define.split('=', 1) for define in args.defines)
+
+    if args.fpga:
+        result = synthesize(defines, args.out, args.top)
+        if result is None:
+            print('Synthesis failed', file=sys.stderr)
+            return 1
+        print(json.dumps(result, indent=2))
+        return 0
+
+    with ThreadPoolExecutor() as executor:
+        futures = {
+            name: executor.submit(report_modules, dict(config, **defines),
+                                  os.path.join(args.out, name), args.top)
+            for name, config in REPORT_CONFIGS.items()
+        }
+        report = {name: future.result() for name, future in futures.items()}
+    failed = [name for name, modules in report.items() if modules is None]
+    if failed:
+        print('Synthesis failed: {}'.format(', '.join(failed)),
+              file=sys.stderr)
+        return 1
+
+    report_path = os.path.join(args.out, 'simmem_synth_report.json')
+    with open(report_path, 'w') as report_file:
+        json.dump(report, report_file, indent=2, sort_keys=True)
+    print('Report written to {}'.format(report_path))
+
+    with open(args.baseline) as baseline_file:
+        baseline = json.load(baseline_file)
+    if args.update_baseline:
+        baseline['configs'] = report
+        with open(args.baseline, 'w') as baseline_file:
+            json.dump(baseline, baseline_file, indent=2, sort_keys=True)
+            baseline_file.write('\n')
+        print('Baseline updated')
+        return 0
+
+    missing = find_missing(report, baseline['configs'])
+    if missing:
+        print('No baseline for: {} (see --update-baseline)'.format(
+            ', '.join(missing)))
+        return 1
+    regressions = compare(report, baseline['configs'], baseline['tolerance'])
+    for regression in regressions:
+        print('Regression: ' + regression)
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())